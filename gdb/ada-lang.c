@@ -1141,9 +1141,9 @@ ada_remove_Xbn_suffix (const char *encoded, int *len)
    the decoded form of ENCODED.  Otherwise, return "<%s>" where "%s" is
    replaced by ENCODED.
 
-   The resulting string is valid until the next call of ada_decode.
-   If the string is unchanged by decoding, the original string pointer
-   is returned.  */
+   The resulting string is valid until the next call of ada_decode in
+   the same thread.  If the string is unchanged by decoding, the
+   original string pointer is returned.  */
 
 const char *
 ada_decode (const char *encoded)
@@ -1153,8 +1153,9 @@ ada_decode (const char *encoded)
   const char *p;
   char *decoded;
   int at_start_name;
-  static char *decoding_buffer = NULL;
-  static size_t decoding_buffer_size = 0;
+  /* Per-thread, since minimal symbols are demangled, and so decoded,
+     in worker threads.  */
+  static thread_local std::vector<char> decoding_buffer;
 
   /* The name of the Ada main procedure starts with "_ada_".
      This prefix is not part of the decoded name, so skip this part
@@ -1208,8 +1209,9 @@ ada_decode (const char *encoded)
 
   /* Make decoded big enough for possible expansion by operator name.  */
 
-  GROW_VECT (decoding_buffer, decoding_buffer_size, 2 * len0 + 1);
-  decoded = decoding_buffer;
+  if (decoding_buffer.size () < (size_t) (2 * len0 + 1))
+    decoding_buffer.resize (2 * len0 + 1);
+  decoded = decoding_buffer.data ();
 
   /* Remove trailing __{digit}+ or trailing ${digit}+.  */
 
@@ -1382,12 +1384,13 @@ ada_decode (const char *encoded)
     return decoded;
 
 Suppress:
-  GROW_VECT (decoding_buffer, decoding_buffer_size, strlen (encoded) + 3);
-  decoded = decoding_buffer;
+  if (decoding_buffer.size () < strlen (encoded) + 3)
+    decoding_buffer.resize (strlen (encoded) + 3);
+  decoded = decoding_buffer.data ();
   if (encoded[0] == '<')
     strcpy (decoded, encoded);
   else
-    xsnprintf (decoded, decoding_buffer_size, "<%s>", encoded);
+    xsnprintf (decoded, decoding_buffer.size (), "<%s>", encoded);
   return decoded;
 
 }
@@ -96,6 +96,12 @@ enum aarch64_opcodes
   CSINC           = 0x9a800400,
   /* MUL            s001 1011 000r rrrr 0111 11rr rrrr rrrr */
   MUL             = 0x1b007c00,
+  /* MSUB           s001 1011 000r rrrr 1aaa aarr rrrr rrrr */
+  MSUB            = 0x1b008000,
+  /* UDIV           s001 1010 110r rrrr 0000 10rr rrrr rrrr */
+  /* SDIV           s001 1010 110r rrrr 0000 11rr rrrr rrrr */
+  UDIV            = 0x1ac00800,
+  SDIV            = 0x00000400 | UDIV,
   /* MSR (register) 1101 0101 0001 oooo oooo oooo ooor rrrr */
   /* MRS            1101 0101 0011 oooo oooo oooo ooor rrrr */
   MSR             = 0xd5100000,
@@ -80,6 +80,7 @@
 #include "mi/mi-common.h"
 #include "extension.h"
 #include <algorithm>
+#include <unordered_set>
 
 /* Enums for exception-handling support.  */
 enum exception_event_kind
@@ -3106,6 +3107,60 @@ update_inserted_breakpoint_locations (void)
   do_cleanups (cleanups);
 }
 
+/* Write out the software breakpoints batched by
+   insert_breakpoint_locations.  Mark the locations whose breakpoint
+   could not be written as not inserted, explaining why in
+   TMP_ERROR_STREAM if it is not NULL.  Return nonzero if there was any
+   such location.  */
+
+static int
+flush_batched_breakpoint_locations (struct ui_file *tmp_error_stream)
+{
+  std::vector<struct bp_target_info *> failed = end_memory_breakpoint_batch ();
+  struct bp_location *bl, **blp_tmp;
+
+  if (failed.empty ())
+    return 0;
+
+  /* Sort the failures so that looking up each location is cheap even
+     when many of them failed.  */
+  std::sort (failed.begin (), failed.end ());
+
+  ALL_BP_LOCATIONS (bl, blp_tmp)
+    {
+      if (!bl->inserted
+	  || !std::binary_search (failed.begin (), failed.end (),
+				  &bl->target_info))
+	continue;
+
+      bl->inserted = 0;
+      if (tmp_error_stream != NULL)
+	{
+	  char *message = memory_error_message (TARGET_XFER_E_IO,
+						bl->gdbarch, bl->address);
+	  struct cleanup *old_chain = make_cleanup (xfree, message);
+
+	  fprintf_unfiltered (tmp_error_stream,
+			      "Cannot insert breakpoint %d.\n"
+			      "%s\n",
+			      bl->owner->number, message);
+	  do_cleanups (old_chain);
+	}
+    }
+
+  return 1;
+}
+
+/* A cleanup that writes out the batched software breakpoints if
+   insert_breakpoint_locations is interrupted.  */
+
+static void
+flush_batched_breakpoint_locations_cleanup (void *arg)
+{
+  if (*(int *) arg)
+    flush_batched_breakpoint_locations (NULL);
+}
+
 /* Used when starting or continuing the program.  */
 
 static void
@@ -3127,6 +3182,14 @@ insert_breakpoint_locations (void)
 
   struct cleanup *cleanups = save_current_space_and_thread ();
 
+  /* Software breakpoints written to memory are batched per page while
+     the locations of a program space are inserted.  Writing them later
+     than the rest of the code expects is only safe if no thread can
+     run into them meanwhile.  */
+  int batching = 0;
+  struct program_space *batch_pspace = NULL;
+  make_cleanup (flush_batched_breakpoint_locations_cleanup, &batching);
+
   ALL_BP_LOCATIONS (bl, blp_tmp)
     {
       if (!should_be_inserted (bl) || (bl->inserted && !bl->needs_update))
@@ -3139,8 +3202,24 @@ insert_breakpoint_locations (void)
 	  && !valid_global_thread_id (bl->owner->thread))
 	continue;
 
+      /* The batch is written to the current inferior, so write it out
+	 before switching to another program space.  */
+      if (batching && batch_pspace != bl->pspace)
+	{
+	  batching = 0;
+	  if (flush_batched_breakpoint_locations (&tmp_error_stream))
+	    error_flag = 1;
+	}
+
       switch_to_program_space_and_thread (bl->pspace);
 
+      if (!batching && !threads_are_executing ())
+	{
+	  begin_memory_breakpoint_batch ();
+	  batching = 1;
+	  batch_pspace = bl->pspace;
+	}
+
       /* For targets that support global breakpoints, there's no need
 	 to select an inferior to insert breakpoint to.  In fact, even
 	 if we aren't attached to any process yet, we should still
@@ -3155,6 +3234,13 @@ insert_breakpoint_locations (void)
 	error_flag = val;
     }
 
+  if (batching)
+    {
+      batching = 0;
+      if (flush_batched_breakpoint_locations (&tmp_error_stream))
+	error_flag = 1;
+    }
+
   /* If we failed to insert all locations of a watchpoint, remove
      them, as half-inserted watchpoint is of limited use.  */
   ALL_BREAKPOINTS (bpt)  
@@ -12166,6 +12252,71 @@ bp_locations_compare (const void *ap, const void *bp)
   return (a > b) - (a < b);
 }
 
+/* A less-than comparison of bp_locations_compare, for std::sort and
+   std::merge.  */
+
+static bool
+bp_location_is_less_than (const struct bp_location *a,
+			  const struct bp_location *b)
+{
+  return bp_locations_compare (&a, &b) < 0;
+}
+
+/* Set BP_LOCATIONS to the locations of all the breakpoints, sorted by
+   bp_locations_compare.  OLD_LOCATIONS is the previous, sorted, content
+   of BP_LOCATIONS.  Only the locations which were not in OLD_LOCATIONS
+   are sorted, then merged with the ones that were, so that adding or
+   removing a few locations does not sort them all again.  */
+
+static void
+build_global_location_list (struct bp_location **old_locations,
+			    unsigned old_locations_count)
+{
+  struct breakpoint *b;
+  struct bp_location *loc, **locp;
+  std::vector<struct bp_location *> kept, added;
+  unsigned i;
+
+  for (locp = old_locations;
+       locp < old_locations + old_locations_count;
+       locp++)
+    (*locp)->listed = 1;
+
+  ALL_BREAKPOINTS (b)
+    for (loc = b->loc; loc; loc = loc->next)
+      {
+	if (loc->listed)
+	  loc->listed = 2;
+	else
+	  added.push_back (loc);
+      }
+
+  kept.reserve (old_locations_count);
+  for (locp = old_locations;
+       locp < old_locations + old_locations_count;
+       locp++)
+    {
+      if ((*locp)->listed == 2)
+	kept.push_back (*locp);
+      (*locp)->listed = 0;
+    }
+
+  /* The locations kept are normally still sorted, but the sort keys
+     of some (permanent, owner number) may have changed.  */
+  for (i = 1; i < kept.size (); i++)
+    if (bp_location_is_less_than (kept[i], kept[i - 1]))
+      {
+	std::sort (kept.begin (), kept.end (), bp_location_is_less_than);
+	break;
+      }
+  std::sort (added.begin (), added.end (), bp_location_is_less_than);
+
+  bp_locations_count = kept.size () + added.size ();
+  bp_locations = XNEWVEC (struct bp_location *, bp_locations_count);
+  std::merge (kept.begin (), kept.end (), added.begin (), added.end (),
+	      bp_locations, bp_location_is_less_than);
+}
+
 /* Set bp_locations_placed_address_before_address_max and
    bp_locations_shadow_len_after_address_max according to the current
    content of the bp_locations array.  */
@@ -12374,17 +12525,7 @@ update_global_location_list (enum ugll_insert_mode insert_mode)
   bp_locations_count = 0;
   cleanups = make_cleanup (xfree, old_locations);
 
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      bp_locations_count++;
-
-  bp_locations = XNEWVEC (struct bp_location *, bp_locations_count);
-  locp = bp_locations;
-  ALL_BREAKPOINTS (b)
-    for (loc = b->loc; loc; loc = loc->next)
-      *locp++ = loc;
-  qsort (bp_locations, bp_locations_count, sizeof (*bp_locations),
-	 bp_locations_compare);
+  build_global_location_list (old_locations, old_locations_count);
 
   bp_locations_target_extensions_update ();
 
@@ -14532,16 +14673,307 @@ breakpoint_re_set_one (void *bint)
   return 0;
 }
 
-/* Re-set breakpoint locations for the current program space.
-   Locations bound to other program spaces are left untouched.  */
+/* Return true if re-setting B after new objfiles are loaded may be
+   skipped when none of the names of its location is found in them.
+   This holds for plain source breakpoints in C-like languages: a
+   linespec resolving into an objfile either names a function, whose
+   identifiers then appear in a symbol of that objfile, or a source
+   file, whose basename then appears among its files.  Everything
+   else, including breakpoints with a condition (which may be parsed
+   differently once new globals exist) and breakpoints with locations
+   in unloaded libraries, is always re-set.  */
 
-void
-breakpoint_re_set (void)
+static bool
+breakpoint_re_set_narrowable_p (struct breakpoint *b)
+{
+  struct bp_location *loc;
+
+  if (b->ops->re_set != bkpt_re_set
+      && b->ops->re_set != tracepoint_re_set
+      && b->ops->re_set != dprintf_re_set)
+    return false;
+  if (!user_breakpoint_p (b)
+      || b->cond_string != NULL
+      || b->location == NULL
+      || b->location_range_end != NULL)
+    return false;
+  if (event_location_type (b->location.get ()) != LINESPEC_LOCATION
+      && event_location_type (b->location.get ()) != EXPLICIT_LOCATION)
+    return false;
+  if (b->language != language_c
+      && b->language != language_cplus
+      && b->language != language_asm
+      && b->language != language_minimal)
+    return false;
+
+  for (loc = b->loc; loc != NULL; loc = loc->next)
+    if (loc->shlib_disabled)
+      return false;
+
+  return true;
+}
+
+/* Return the basename of FILENAME as breakpoint_re_set_objfiles
+   compares it.  */
+
+static std::string
+re_set_basename (const char *filename)
+{
+  std::string result (lbasename (filename));
+
+#ifdef HAVE_CASE_INSENSITIVE_FILE_SYSTEM
+  std::transform (result.begin (), result.end (), result.begin (),
+		  [] (char c) { return tolower ((unsigned char) c); });
+#endif
+
+  return result;
+}
+
+/* Return true if C may be part of an identifier.  Bytes outside ASCII
+   are taken as such, so that UTF-8 names split the same way
+   everywhere.  */
+
+static bool
+re_set_ident_char_p (char c)
+{
+  unsigned char uc = c;
+
+  return isalnum (uc) || uc == '_' || uc == '$' || uc >= 0x80;
+}
+
+/* Call CALLBACK on each identifier in NAME that is not just a
+   number.  */
+
+static void
+iterate_over_identifiers
+  (const char *name,
+   gdb::function_view<void (const std::string &)> callback)
+{
+  std::string ident;
+
+  while (*name != '\0')
+    {
+      const char *start;
+      bool number = true;
+
+      while (*name != '\0' && !re_set_ident_char_p (*name))
+	name++;
+      start = name;
+      while (*name != '\0' && re_set_ident_char_p (*name))
+	{
+	  if (!isdigit ((unsigned char) *name))
+	    number = false;
+	  name++;
+	}
+
+      if (name > start && !number)
+	{
+	  ident.assign (start, name - start);
+	  callback (ident);
+	}
+    }
+}
+
+/* Return true if C separates the file name from the rest of a
+   location spec.  */
+
+static bool
+re_set_spec_separator_p (char c)
+{
+  return isspace ((unsigned char) c) || c == ':' || c == '\'' || c == '"';
+}
+
+/* Add to NAMES the identifiers, and to BASENAMES the possible file
+   basenames, of the location spec SPEC.  */
+
+static void
+add_location_spec_names (const char *spec,
+			 std::unordered_set<std::string> *names,
+			 std::unordered_set<std::string> *basenames)
+{
+  if (spec == NULL)
+    return;
+
+  iterate_over_identifiers (spec, [&] (const std::string &ident)
+    {
+      names->insert (ident);
+    });
+
+  while (*spec != '\0')
+    {
+      const char *start;
+
+      while (*spec != '\0' && re_set_spec_separator_p (*spec))
+	spec++;
+      start = spec;
+      while (*spec != '\0' && !re_set_spec_separator_p (*spec))
+	spec++;
+
+      if (spec > start)
+	{
+	  std::string file (start, spec - start);
+
+	  basenames->insert (re_set_basename (file.c_str ()));
+	}
+    }
+}
+
+/* Collect into NAMES and BASENAMES the names of the location of B,
+   which must satisfy breakpoint_re_set_narrowable_p.  Return false if
+   the location does not name a function or a file, e.g. a bare line
+   number, in which case B must always be re-set.  */
+
+static bool
+breakpoint_location_names (struct breakpoint *b,
+			   std::unordered_set<std::string> *names,
+			   std::unordered_set<std::string> *basenames)
+{
+  const struct event_location *location = b->location.get ();
+
+  if (event_location_type (location) == LINESPEC_LOCATION)
+    add_location_spec_names (get_linespec_location (location),
+			     names, basenames);
+  else
+    {
+      const struct explicit_location *explicit_loc
+	= get_explicit_location_const (location);
+
+      add_location_spec_names (explicit_loc->source_filename,
+			       names, basenames);
+      add_location_spec_names (explicit_loc->function_name,
+			       names, basenames);
+      add_location_spec_names (explicit_loc->label_name,
+			       names, basenames);
+    }
+
+  return !names->empty ();
+}
+
+/* Find which of the identifiers in NAMES and of the basenames in
+   BASENAMES appear in the symbols and source files of OBJFILE and of
+   its separate debug objfiles, and add them to MATCHED_NAMES and
+   MATCHED_BASENAMES.  This reads the partial symbols of OBJFILE if
+   needed, but does not expand any symtab.  */
+
+static void
+match_objfile_names (struct objfile *objfile,
+		     const std::unordered_set<std::string> &names,
+		     const std::unordered_set<std::string> &basenames,
+		     std::unordered_set<std::string> *matched_names,
+		     std::unordered_set<std::string> *matched_basenames)
+{
+  struct objfile *iter;
+
+  auto match_name = [&] (const char *name)
+    {
+      if (name == NULL)
+	return;
+      iterate_over_identifiers (name, [&] (const std::string &ident)
+	{
+	  if (names.find (ident) != names.end ())
+	    matched_names->insert (ident);
+	});
+    };
+
+  auto match_file = [&] (const char *filename)
+    {
+      std::string base = re_set_basename (filename);
+
+      if (basenames.find (base) != basenames.end ())
+	matched_basenames->insert (base);
+    };
+
+  for (iter = objfile;
+       iter != NULL;
+       iter = objfile_separate_debug_iterate (objfile, iter))
+    {
+      struct compunit_symtab *cust;
+      struct symtab *s;
+
+      if (iter->per_bfd->minimal_symbol_count > 0)
+	{
+	  struct minimal_symbol *msymbol;
+
+	  ALL_OBJFILE_MSYMBOLS (iter, msymbol)
+	    {
+	      match_name (MSYMBOL_LINKAGE_NAME (msymbol));
+	      match_name (MSYMBOL_DEMANGLED_NAME (msymbol));
+	    }
+	}
+
+      /* Symtabs already expanded are skipped by the quick functions
+	 below.  */
+      ALL_OBJFILE_FILETABS (iter, cust, s)
+	match_file (s->filename);
+      ALL_OBJFILE_COMPUNITS (iter, cust)
+	{
+	  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (cust);
+	  int i;
+
+	  for (i = GLOBAL_BLOCK; i <= STATIC_BLOCK; i++)
+	    {
+	      struct block_iterator block_iter;
+	      struct symbol *sym;
+
+	      ALL_BLOCK_SYMBOLS (BLOCKVECTOR_BLOCK (bv, i), block_iter, sym)
+		{
+		  match_name (SYMBOL_LINKAGE_NAME (sym));
+		  match_name (SYMBOL_DEMANGLED_NAME (sym));
+		}
+	    }
+	}
+
+      if (iter->sf == NULL)
+	continue;
+
+      iter->sf->qf->expand_symtabs_matching
+	(iter, NULL,
+	 [&] (const char *name)
+	 {
+	   match_name (name);
+	   return false;
+	 },
+	 NULL, ALL_DOMAIN);
+
+      iter->sf->qf->map_symbol_filenames
+	(iter,
+	 [] (const char *filename, const char *fullname, void *data)
+	 {
+	   (*(decltype (match_file) *) data) (filename);
+	 },
+	 &match_file, 0);
+    }
+}
+
+/* Re-set the breakpoints of the current program space after the
+   objfiles in NEW_OBJFILES were loaded, or all of them if NEW_OBJFILES
+   is NULL.  */
+
+static void
+breakpoint_re_set_1 (const std::vector<struct objfile *> *new_objfiles)
 {
   struct breakpoint *b, *b_tmp;
   enum language save_language;
   int save_input_radix;
   struct cleanup *old_chain;
+  std::unordered_set<std::string> matched_names, matched_basenames;
+  bool narrow = (new_objfiles != NULL
+		 && case_sensitivity == case_sensitive_on
+		 && !basenames_may_differ);
+
+  if (narrow)
+    {
+      std::unordered_set<std::string> names, basenames;
+
+      ALL_BREAKPOINTS (b)
+	if (breakpoint_re_set_narrowable_p (b))
+	  breakpoint_location_names (b, &names, &basenames);
+
+      if (!names.empty ())
+	for (struct objfile *objfile : *new_objfiles)
+	  match_objfile_names (objfile, names, basenames,
+			       &matched_names, &matched_basenames);
+    }
 
   save_language = current_language->la_language;
   save_input_radix = input_radix;
@@ -14554,6 +14986,26 @@ breakpoint_re_set (void)
 
   ALL_BREAKPOINTS_SAFE (b, b_tmp)
   {
+    if (narrow && breakpoint_re_set_narrowable_p (b))
+      {
+	std::unordered_set<std::string> names, basenames;
+
+	/* Leave B alone if none of its names is found in the new
+	   objfiles: its locations cannot have changed.  */
+	if (breakpoint_location_names (b, &names, &basenames)
+	    && std::none_of (names.begin (), names.end (),
+			     [&] (const std::string &name)
+			     {
+			       return matched_names.count (name) > 0;
+			     })
+	    && std::none_of (basenames.begin (), basenames.end (),
+			     [&] (const std::string &name)
+			     {
+			       return matched_basenames.count (name) > 0;
+			     }))
+	  continue;
+      }
+
     /* Format possible error msg.  */
     char *message = xstrprintf ("Error in re-setting breakpoint %d: ",
 				b->number);
@@ -14576,6 +15028,23 @@ breakpoint_re_set (void)
   /* Now we can insert.  */
   update_global_location_list (UGLL_MAY_INSERT);
 }
+
+/* Re-set breakpoint locations for the current program space.
+   Locations bound to other program spaces are left untouched.  */
+
+void
+breakpoint_re_set (void)
+{
+  breakpoint_re_set_1 (NULL);
+}
+
+/* See breakpoint.h.  */
+
+void
+breakpoint_re_set_objfiles (const std::vector<struct objfile *> &objfiles)
+{
+  breakpoint_re_set_1 (&objfiles);
+}
 
 /* Reset the thread number of this breakpoint:
 
@@ -387,6 +387,10 @@ struct bp_location
      gdbarch_skip_permanent_breakpoint method.  */
   char permanent;
 
+  /* Used by update_global_location_list to tell which locations were
+     already in the global location list.  Zero otherwise.  */
+  char listed;
+
   /* Nonzero if this is not the first breakpoint in the list
      for the given address.  location of tracepoint can _never_
      be duplicated with other locations of tracepoints and other
@@ -1216,6 +1220,14 @@ extern void update_breakpoint_locations (struct breakpoint *b,
 
 extern void breakpoint_re_set (void);
 
+/* Re-set breakpoint locations for the current program space after
+   the objfiles in OBJFILES were loaded.  Breakpoints whose location
+   names nothing found in OBJFILES keep their locations and are not
+   re-set.  */
+
+extern void breakpoint_re_set_objfiles
+  (const std::vector<struct objfile *> &objfiles);
+
 extern void breakpoint_re_set_thread (struct breakpoint *);
 
 extern struct breakpoint *set_momentary_breakpoint
@@ -501,7 +501,16 @@ c_val_print (struct type *type,
 	     const struct value_print_options *options)
 {
   struct type *unresolved_type = type;
-  const gdb_byte *valaddr = value_contents_for_printing (original_value);
+  const gdb_byte *valaddr;
+
+  /* Leave an array that val_print_array_elements reads a window at a
+     time unfetched, unless it is printed as a string.  */
+  if (val_print_array_windowed_p (type, embedded_offset, original_value)
+      && !c_textual_element_type (TYPE_TARGET_TYPE (check_typedef (type)),
+				  options->format))
+    valaddr = NULL;
+  else
+    valaddr = value_contents_for_printing (original_value);
 
   type = check_typedef (type);
   switch (TYPE_CODE (type))
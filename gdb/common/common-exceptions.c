@@ -52,8 +52,10 @@ struct catcher
   struct catcher *prev;
 };
 
-/* Where to go for throw_exception().  */
-static struct catcher *current_catcher;
+/* Where to go for throw_exception().  This and the other exception
+   state below is per-thread, so that a worker thread can throw and
+   catch errors without disturbing the main thread.  */
+static thread_local struct catcher *current_catcher;
 
 #if GDB_XCPT == GDB_XCPT_SJMP
 
@@ -220,7 +222,7 @@ exceptions_state_mc_action_iter_1 (void)
 /* How many nested TRY blocks we have.  See exception_messages and
    throw_it.  */
 
-static int try_scope_depth;
+static thread_local int try_scope_depth;
 
 /* Called on entry to a TRY scope.  */
 
@@ -328,10 +330,10 @@ throw_exception (struct gdb_exception exception)
    This is indexed by the size of the current_catcher list.
    It is a dynamically allocated array so that we don't care how deeply
    GDB nests its TRY_CATCHs.  */
-static char **exception_messages;
+static thread_local char **exception_messages;
 
 /* The number of currently allocated entries in exception_messages.  */
-static int exception_messages_size;
+static thread_local int exception_messages_size;
 
 static void ATTRIBUTE_NORETURN ATTRIBUTE_PRINTF (3, 0)
 throw_it (enum return_reason reason, enum errors error, const char *fmt,
@@ -0,0 +1,158 @@
+/* Parallel for loops
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_PARALLEL_FOR_H
+#define COMMON_PARALLEL_FOR_H
+
+#ifdef CXX_STD_THREAD
+#include <exception>
+#include <signal.h>
+#include <system_error>
+#include <thread>
+#include <vector>
+#endif
+
+namespace gdb
+{
+
+/* Return the number of threads parallel_for_each should use for N
+   elements, given the user's SETTING (-1 meaning one per CPU) and the
+   smallest number of elements, MIN_ELEMENTS, worth giving a thread.
+   The result counts the calling thread, so 1 means no workers.  */
+
+static inline int
+parallel_for_thread_count (int setting, size_t n, size_t min_elements)
+{
+#ifdef CXX_STD_THREAD
+  size_t n_threads;
+
+  if (setting < 0)
+    n_threads = std::thread::hardware_concurrency ();
+  else
+    n_threads = setting;
+
+  if (min_elements == 0)
+    min_elements = 1;
+  if (n_threads > n / min_elements)
+    n_threads = n / min_elements;
+
+  return n_threads > 1 ? n_threads : 1;
+#else
+  return 1;
+#endif
+}
+
+/* Split the range [FIRST, LAST) into N_THREADS contiguous pieces and
+   call CALLBACK (BEGIN, END) on each, the first piece on the calling
+   thread and the others on new threads, and wait for all of them.
+
+   CALLBACK may be called concurrently, so it must only write to state
+   belonging to its piece.  If it throws, the exception of the first
+   piece that threw is rethrown once all the pieces are done.
+
+   Without thread support, or with N_THREADS <= 1, this is just
+   CALLBACK (FIRST, LAST).  The pieces whose thread cannot be started
+   are run on the calling thread too.  */
+
+template<typename RandomIt, typename Callback>
+void
+parallel_for_each (RandomIt first, RandomIt last, int n_threads,
+		   Callback callback)
+{
+#ifdef CXX_STD_THREAD
+  size_t n = last - first;
+
+  if (n_threads > 1 && n > 1)
+    {
+      if ((size_t) n_threads > n)
+	n_threads = n;
+
+      size_t piece = n / n_threads;
+      size_t extra = n % n_threads;
+      std::vector<std::exception_ptr> errors (n_threads);
+      std::vector<std::thread> threads;
+      std::vector<RandomIt> bounds;
+
+      bounds.push_back (first);
+      for (int i = 0; i < n_threads; ++i)
+	bounds.push_back (bounds.back () + piece
+			  + ((size_t) i < extra ? 1 : 0));
+
+      auto run = [&] (int i)
+	{
+	  try
+	    {
+	      callback (bounds[i], bounds[i + 1]);
+	    }
+	  catch (...)
+	    {
+	      errors[i] = std::current_exception ();
+	    }
+	};
+
+      /* Signals should be handled by the main thread, so block them
+	 all while the workers inherit our mask.  */
+#ifdef HAVE_SIGPROCMASK
+      sigset_t all_signals, old_mask;
+
+      sigfillset (&all_signals);
+      sigprocmask (SIG_BLOCK, &all_signals, &old_mask);
+#endif
+
+      int started = 1;
+
+      threads.reserve (n_threads - 1);
+      for (; started < n_threads; ++started)
+	{
+	  try
+	    {
+	      threads.emplace_back (run, started);
+	    }
+	  catch (const std::system_error &)
+	    {
+	      /* Make do with the threads we have.  */
+	      break;
+	    }
+	}
+
+#ifdef HAVE_SIGPROCMASK
+      sigprocmask (SIG_SETMASK, &old_mask, NULL);
+#endif
+
+      run (0);
+      for (int i = started; i < n_threads; ++i)
+	run (i);
+
+      for (std::thread &thread : threads)
+	thread.join ();
+
+      for (const std::exception_ptr &error : errors)
+	if (error != nullptr)
+	  std::rethrow_exception (error);
+
+      return;
+    }
+#endif
+
+  callback (first, last);
+}
+
+}
+
+#endif /* COMMON_PARALLEL_FOR_H */
@@ -152,6 +152,31 @@ find_complaint (struct complaints *complaints, const char *file,
 
 static int stop_whining = 0;
 
+/* The innermost complaint_interceptor of the current thread.  */
+
+static thread_local complaint_interceptor *current_interceptor;
+
+complaint_interceptor::complaint_interceptor ()
+  : m_complained (false),
+    m_saved (current_interceptor)
+{
+  current_interceptor = this;
+}
+
+complaint_interceptor::~complaint_interceptor ()
+{
+  current_interceptor = m_saved;
+}
+
+bool
+complaint_interceptor::note ()
+{
+  if (current_interceptor == NULL)
+    return false;
+  current_interceptor->m_complained = true;
+  return true;
+}
+
 /* Print a complaint, and link the complaint block into a chain for
    later handling.  */
 
@@ -160,11 +185,16 @@ vcomplaint (struct complaints **c, const char *file,
 	    int line, const char *fmt,
 	    va_list args)
 {
-  struct complaints *complaints = get_complaints (c);
-  struct complain *complaint = find_complaint (complaints, file, 
-					       line, fmt);
+  struct complaints *complaints;
+  struct complain *complaint;
   enum complaint_series series;
 
+  if (complaint_interceptor::note ())
+    return;
+
+  complaints = get_complaints (c);
+  complaint = find_complaint (complaints, file, line, fmt);
+
   gdb_assert (complaints != NULL);
 
   complaint->counter++;
@@ -48,5 +48,41 @@ extern void internal_complaint (struct complaints **complaints,
 extern void clear_complaints (struct complaints **complaints,
 			      int less_verbose, int noisy);
 
+/* While an object of this type is live in a thread, complaints made
+   by that thread are not printed or counted; instead the object just
+   records that one was made.  This lets a worker thread find out
+   whether the debug info it reads is suspect, so that the main thread
+   can read it again and issue the complaints itself.  */
+
+class complaint_interceptor
+{
+public:
+
+  complaint_interceptor ();
+  ~complaint_interceptor ();
+
+  /* Return true if a complaint was made since this object was
+     created.  */
+  bool complained () const
+  {
+    return m_complained;
+  }
+
+  /* If the current thread has an interceptor, record a complaint in
+     it and return true.  Otherwise return false.  */
+  static bool note ();
+
+private:
+
+  /* True if a complaint was made.  */
+  bool m_complained;
+
+  /* The interceptor this one replaced, if any.  */
+  complaint_interceptor *m_saved;
+
+  complaint_interceptor (const complaint_interceptor &) = delete;
+  complaint_interceptor &operator= (const complaint_interceptor &) = delete;
+};
+
 
 #endif /* !defined (COMPLAINTS_H) */
@@ -1,6 +1,7 @@
 #! /bin/sh
 
-# Add a .gdb_index section to a file.
+# Add a .gdb_index section, or with -dwarf-5 a .debug_names section, to
+# a file.
 
 # Copyright (C) 2010-2017 Free Software Foundation, Inc.
 # This program is free software; you can redistribute it and/or modify
@@ -23,8 +24,14 @@ OBJCOPY=${OBJCOPY:=objcopy}
 
 myname="${0##*/}"
 
+dwarf5=""
+if test "$1" = "-dwarf-5"; then
+    dwarf5="$1"
+    shift
+fi
+
 if test $# != 1; then
-    echo "usage: $myname FILE" 1>&2
+    echo "usage: $myname [-dwarf-5] FILE" 1>&2
     exit 1
 fi
 
@@ -37,14 +44,18 @@ fi
 
 dir="${file%/*}"
 test "$dir" = "$file" && dir="."
-index="${file}.gdb-index"
+index4="${file}.gdb-index"
+index5="${file}.debug_names"
+debugstr="${file}.debug_str"
+debugstrmerge="${file}.debug_str.merge"
+debugstrerr="${file}.debug_str.err"
 
-rm -f $index
+rm -f $index4 $index5 $debugstr $debugstrmerge $debugstrerr
 # Ensure intermediate index file is removed when we exit.
-trap "rm -f $index" 0
+trap "rm -f $index4 $index5 $debugstr $debugstrmerge $debugstrerr" 0
 
 $GDB --batch -nx -iex 'set auto-load no' \
-    -ex "file $file" -ex "save gdb-index $dir" || {
+    -ex "file $file" -ex "save gdb-index $dwarf5 $dir" || {
     # Just in case.
     status=$?
     echo "$myname: gdb error generating index for $file" 1>&2
@@ -57,10 +68,28 @@ $GDB --batch -nx -iex 'set auto-load no' \
 # already stripped binary, it's a no-op.
 status=0
 
-if test -f "$index"; then
-    $OBJCOPY --add-section .gdb_index="$index" \
+if test -f "$index4" -a -f "$index5"; then
+    echo "$myname: Both index types were created for $file" 1>&2
+    status=1
+elif test -f "$index4"; then
+    $OBJCOPY --add-section .gdb_index="$index4" \
 	--set-section-flags .gdb_index=readonly "$file" "$file"
     status=$?
+elif test -f "$index5"; then
+    # The index refers to its names past the end of the current
+    # .debug_str section, so append them to it, creating the section if
+    # the file has none.
+    strop=--update-section
+    if ! $OBJCOPY --dump-section .debug_str="$debugstrmerge" "$file" \
+	 /dev/null 2>$debugstrerr; then
+	strop=--add-section
+	: > "$debugstrmerge"
+    fi
+    cat "$debugstr" >>"$debugstrmerge"
+    $OBJCOPY --add-section .debug_names="$index5" \
+	--set-section-flags .debug_names=readonly \
+	$strop .debug_str="$debugstrmerge" "$file" "$file"
+    status=$?
 else
     echo "$myname: No index was created for $file" 1>&2
     echo "$myname: [Was there no debuginfo? Was there already an index?]" 1>&2
@@ -45,6 +45,12 @@
 #include "gdb_bfd.h"
 #include "completer.h"
 #include "filestuff.h"
+#include <algorithm>
+#include <vector>
+#include <sys/stat.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #ifndef O_LARGEFILE
 #define O_LARGEFILE 0
@@ -74,6 +80,29 @@ static struct gdbarch *core_gdbarch = NULL;
    unix child targets.  */
 static struct target_section_table *core_data;
 
+/* A range of the core file's memory whose contents are in CORE_MAP.  */
+
+struct core_mapped_range
+{
+  CORE_ADDR start;
+  CORE_ADDR end;
+
+  /* Where START is in CORE_MAP, or NULL if the section covering this
+     range has no contents in the file, in which case reads go through
+     BFD.  */
+  const gdb_byte *data;
+};
+
+/* When the core file is a local ELF file, it is mapped read-only
+   here, and memory reads are served from the mapping, found through
+   CORE_MAPPED_RANGES, instead of through BFD's seeks and copies.  */
+static gdb_byte *core_map;
+static size_t core_map_size;
+
+/* The ranges of memory of the sections of CORE_DATA, sorted by start
+   address.  Empty if CORE_MAP is not used.  */
+static std::vector<core_mapped_range> core_mapped_ranges;
+
 static void core_files_info (struct target_ops *);
 
 static struct core_fns *sniff_core_bfd (bfd *);
@@ -183,6 +212,137 @@ gdb_check_format (bfd *abfd)
   return (0);
 }
 
+/* Map the core file, and index the sections of CORE_DATA in
+   CORE_MAPPED_RANGES.  Nothing is done if the file cannot be mapped,
+   and memory is then read through BFD.  Nothing is done either if the
+   core file is opened for writing, since writes go through BFD and
+   would not be seen in the mapping.  */
+
+static void
+core_map_file (void)
+{
+#ifdef HAVE_MMAP
+  const char *filename = bfd_get_filename (core_bfd);
+  struct target_section *p;
+  struct stat st;
+  int fd;
+
+  /* Only section contents at a known offset of a plain local file can
+     be found in a mapping of it.  */
+  if (write_files
+      || bfd_get_flavour (core_bfd) != bfd_target_elf_flavour
+      || (core_bfd->flags & BFD_IN_MEMORY) != 0
+      || core_bfd->my_archive != NULL
+      || is_target_filename (filename))
+    return;
+
+  fd = gdb_open_cloexec (filename, O_RDONLY | O_BINARY, 0);
+  if (fd < 0)
+    return;
+
+  if (fstat (fd, &st) < 0 || st.st_size == 0
+      || (off_t) (size_t) st.st_size != st.st_size)
+    {
+      close (fd);
+      return;
+    }
+
+  core_map = (gdb_byte *) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+				fd, 0);
+  close (fd);
+  if (core_map == (gdb_byte *) MAP_FAILED)
+    {
+      core_map = NULL;
+      return;
+    }
+  core_map_size = st.st_size;
+
+  for (p = core_data->sections; p < core_data->sections_end; p++)
+    {
+      asection *asect = p->the_bfd_section;
+      core_mapped_range range;
+
+      if (p->endaddr <= p->addr)
+	continue;
+
+      range.start = p->addr;
+      range.end = p->endaddr;
+      range.data = NULL;
+      if ((bfd_get_section_flags (core_bfd, asect) & SEC_HAS_CONTENTS) != 0
+	  && asect->compress_status == COMPRESS_SECTION_NONE
+	  && asect->filepos >= 0
+	  && (ULONGEST) asect->filepos <= core_map_size
+	  && (bfd_get_section_size (asect)
+	      <= core_map_size - (ULONGEST) asect->filepos)
+	  && p->endaddr - p->addr <= bfd_get_section_size (asect))
+	range.data = core_map + asect->filepos;
+
+      core_mapped_ranges.push_back (range);
+    }
+
+  std::sort (core_mapped_ranges.begin (), core_mapped_ranges.end (),
+	     [] (const core_mapped_range &a, const core_mapped_range &b)
+	     {
+	       return a.start < b.start;
+	     });
+
+  /* section_table_xfer_memory_partial serves a read from the first
+     section that covers it.  Rather than mimic that for overlapping
+     sections, which real core files do not have, leave it to it.  */
+  for (size_t i = 1; i < core_mapped_ranges.size (); i++)
+    if (core_mapped_ranges[i].start < core_mapped_ranges[i - 1].end)
+      {
+	core_mapped_ranges.clear ();
+	break;
+      }
+#endif
+}
+
+/* Undo core_map_file.  */
+
+static void
+core_unmap_file (void)
+{
+  core_mapped_ranges.clear ();
+#ifdef HAVE_MMAP
+  if (core_map != NULL)
+    munmap (core_map, core_map_size);
+#endif
+  core_map = NULL;
+  core_map_size = 0;
+}
+
+/* Read LEN bytes of memory at MEMADDR into READBUF from CORE_MAP.
+   Return TARGET_XFER_E_IO if the read must go through BFD instead.  */
+
+static enum target_xfer_status
+core_xfer_mapped_memory (gdb_byte *readbuf, ULONGEST memaddr, ULONGEST len,
+			 ULONGEST *xfered_len)
+{
+  if (core_mapped_ranges.empty ())
+    return TARGET_XFER_E_IO;
+
+  auto it = std::upper_bound (core_mapped_ranges.begin (),
+			      core_mapped_ranges.end (), memaddr,
+			      [] (ULONGEST addr, const core_mapped_range &r)
+			      {
+				return addr < r.start;
+			      });
+  if (it == core_mapped_ranges.begin ())
+    return TARGET_XFER_E_IO;
+  --it;
+
+  if (memaddr >= it->end || it->data == NULL)
+    return TARGET_XFER_E_IO;
+
+  /* Like section_table_xfer_memory_partial, stop at the end of the
+     section.  */
+  len = std::min (len, (ULONGEST) (it->end - memaddr));
+  memcpy (readbuf, it->data + (memaddr - it->start), len);
+  *xfered_len = len;
+  return TARGET_XFER_OK;
+}
+
 /* Discard all vestiges of any previous core file and mark data and
    stack spaces as empty.  */
 
@@ -201,6 +361,8 @@ core_close (struct target_ops *self)
          comments in clear_solib in solib.c.  */
       clear_solib ();
 
+      core_unmap_file ();
+
       if (core_data)
 	{
 	  xfree (core_data->sections);
@@ -350,6 +512,8 @@ core_open (const char *arg, int from_tty)
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
 
+  core_map_file ();
+
   /* If we have no exec file, try to set the architecture from the
      core file.  We don't do this unconditionally since an exec file
      typically contains more information that helps us determine the
@@ -684,6 +848,14 @@ core_xfer_partial (struct target_ops *ops, enum target_object object,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (readbuf != NULL)
+	{
+	  enum target_xfer_status status
+	    = core_xfer_mapped_memory (readbuf, offset, len, xfered_len);
+
+	  if (status == TARGET_XFER_OK)
+	    return status;
+	}
       return section_table_xfer_memory_partial (readbuf, writebuf,
 						offset, len, xfered_len,
 						core_data->sections,
@@ -36,6 +36,10 @@
 #include <signal.h>
 #include "gdb_setjmp.h"
 #include "safe-ctype.h"
+#ifdef CXX_STD_THREAD
+#include <mutex>
+#include <thread>
+#endif
 
 #define d_left(dc) (dc)->u.s_binary.left
 #define d_right(dc) (dc)->u.s_binary.right
@@ -1461,9 +1465,12 @@ cp_lookup_rtti_type (const char *name, struct block *block)
 
 static int catch_demangler_crashes = 1;
 
-/* Stack context and environment for demangler crash recovery.  */
+/* Stack context and environment for demangler crash recovery of the
+   current thread, or NULL if the thread is not in gdb_demangle.
+   Minimal symbols are demangled in worker threads, so each thread
+   needs its own.  */
 
-static SIGJMP_BUF gdb_demangle_jmp_buf;
+static thread_local SIGJMP_BUF *gdb_demangle_jmp_buf;
 
 /* If nonzero, attempt to dump core from the signal handler.  */
 
@@ -1474,6 +1481,15 @@ static int gdb_demangle_attempt_core_dump = 1;
 static void
 gdb_demangle_signal_handler (int signo)
 {
+  /* The handler is shared by all threads while any of them is in
+     gdb_demangle.  If this one is not, the crash has nothing to do
+     with the demangler: let it take its normal course.  */
+  if (gdb_demangle_jmp_buf == NULL)
+    {
+      signal (signo, SIG_DFL);
+      return;
+    }
+
   if (gdb_demangle_attempt_core_dump)
     {
       if (fork () == 0)
@@ -1482,26 +1498,52 @@ gdb_demangle_signal_handler (int signo)
       gdb_demangle_attempt_core_dump = 0;
     }
 
-  SIGLONGJMP (gdb_demangle_jmp_buf, signo);
+  SIGLONGJMP (*gdb_demangle_jmp_buf, signo);
 }
 
-#endif
+#ifdef CXX_STD_THREAD
+/* Protects the variables below, which are shared by the threads in
+   gdb_demangle.  */
 
-/* A wrapper for bfd_demangle.  */
+static std::mutex gdb_demangle_lock;
 
-char *
-gdb_demangle (const char *name, int options)
-{
-  char *result = NULL;
-  int crash_signal = 0;
+/* The thread that runs the event loop and may print.  */
 
-#ifdef HAVE_WORKING_FORK
+static const std::thread::id gdb_demangle_main_thread
+  = std::this_thread::get_id ();
+#endif
+
+/* The number of threads in gdb_demangle with the signal handler
+   installed, and the handler to restore when the last one leaves.  */
+
+static int gdb_demangle_handler_users;
 #if defined (HAVE_SIGACTION) && defined (SA_RESTART)
-  struct sigaction sa, old_sa;
+static struct sigaction gdb_demangle_old_sa;
 #else
-  sighandler_t ofunc;
+static sighandler_t gdb_demangle_old_func;
+#endif
+
+/* -1 until gdb_demangle first needs to know whether it can dump
+   core, then the result of can_dump_core.  */
+
+static int core_dump_allowed = -1;
+
+/* A demangler crash that happened in a worker thread, to be reported
+   by report_deferred_demangler_crash.  The name is empty if there is
+   none.  */
+
+static std::string deferred_crash_name;
+static int deferred_crash_signal;
+
+/* Install gdb_demangle_signal_handler for SIGSEGV, unless another
+   thread already did.  */
+
+static void
+install_demangler_signal_handler ()
+{
+#ifdef CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (gdb_demangle_lock);
 #endif
-  static int core_dump_allowed = -1;
 
   if (core_dump_allowed == -1)
     {
@@ -1511,22 +1553,129 @@ gdb_demangle (const char *name, int options)
 	gdb_demangle_attempt_core_dump = 0;
     }
 
-  if (catch_demangler_crashes)
-    {
+  if (gdb_demangle_handler_users++ > 0)
+    return;
+
 #if defined (HAVE_SIGACTION) && defined (SA_RESTART)
-      sa.sa_handler = gdb_demangle_signal_handler;
-      sigemptyset (&sa.sa_mask);
+  struct sigaction sa;
+
+  sa.sa_handler = gdb_demangle_signal_handler;
+  sigemptyset (&sa.sa_mask);
 #ifdef HAVE_SIGALTSTACK
-      sa.sa_flags = SA_ONSTACK;
+  sa.sa_flags = SA_ONSTACK;
 #else
-      sa.sa_flags = 0;
+  sa.sa_flags = 0;
+#endif
+  sigaction (SIGSEGV, &sa, &gdb_demangle_old_sa);
+#else
+  gdb_demangle_old_func = signal (SIGSEGV, gdb_demangle_signal_handler);
+#endif
+}
+
+/* Undo install_demangler_signal_handler, restoring the previous
+   SIGSEGV handler when the last thread leaves gdb_demangle.  */
+
+static void
+uninstall_demangler_signal_handler ()
+{
+#ifdef CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (gdb_demangle_lock);
 #endif
-      sigaction (SIGSEGV, &sa, &old_sa);
+
+  if (--gdb_demangle_handler_users > 0)
+    return;
+
+#if defined (HAVE_SIGACTION) && defined (SA_RESTART)
+  sigaction (SIGSEGV, &gdb_demangle_old_sa, NULL);
 #else
-      ofunc = signal (SIGSEGV, gdb_demangle_signal_handler);
+  signal (SIGSEGV, gdb_demangle_old_func);
 #endif
+}
+
+/* Report that the demangler crashed with CRASH_SIGNAL while
+   demangling NAME.  Only the first crash is reported.  */
+
+static void
+report_demangler_crash (const char *name, int crash_signal)
+{
+  static int error_reported = 0;
 
-      crash_signal = SIGSETJMP (gdb_demangle_jmp_buf);
+  if (!error_reported)
+    {
+      char *short_msg, *long_msg;
+      struct cleanup *back_to;
+
+      short_msg = xstrprintf (_("unable to demangle '%s' "
+			      "(demangler failed with signal %d)"),
+			    name, crash_signal);
+      back_to = make_cleanup (xfree, short_msg);
+
+      long_msg = xstrprintf ("%s:%d: %s: %s", __FILE__, __LINE__,
+			    "demangler-warning", short_msg);
+      make_cleanup (xfree, long_msg);
+
+      make_cleanup_restore_target_terminal ();
+      target_terminal_ours_for_output ();
+
+      begin_line ();
+      if (core_dump_allowed)
+	fprintf_unfiltered (gdb_stderr,
+			    _("%s\nAttempting to dump core.\n"),
+			    long_msg);
+      else
+	warn_cant_dump_core (long_msg);
+
+      demangler_warning (__FILE__, __LINE__, "%s", short_msg);
+
+      do_cleanups (back_to);
+
+      error_reported = 1;
+    }
+}
+
+#endif
+
+/* See cp-support.h.  */
+
+void
+report_deferred_demangler_crash (void)
+{
+#ifdef HAVE_WORKING_FORK
+  std::string name;
+  int crash_signal;
+
+  {
+#ifdef CXX_STD_THREAD
+    std::lock_guard<std::mutex> guard (gdb_demangle_lock);
+#endif
+
+    name = std::move (deferred_crash_name);
+    deferred_crash_name.clear ();
+    crash_signal = deferred_crash_signal;
+  }
+
+  if (!name.empty ())
+    report_demangler_crash (name.c_str (), crash_signal);
+#endif
+}
+
+/* A wrapper for bfd_demangle.  */
+
+char *
+gdb_demangle (const char *name, int options)
+{
+  char *result = NULL;
+  int crash_signal = 0;
+
+#ifdef HAVE_WORKING_FORK
+  SIGJMP_BUF buf;
+
+  if (catch_demangler_crashes)
+    {
+      install_demangler_signal_handler ();
+
+      gdb_demangle_jmp_buf = &buf;
+      crash_signal = SIGSETJMP (buf);
     }
 #endif
 
@@ -1536,47 +1685,27 @@ gdb_demangle (const char *name, int options)
 #ifdef HAVE_WORKING_FORK
   if (catch_demangler_crashes)
     {
-#if defined (HAVE_SIGACTION) && defined (SA_RESTART)
-      sigaction (SIGSEGV, &old_sa, NULL);
-#else
-      signal (SIGSEGV, ofunc);
-#endif
+      gdb_demangle_jmp_buf = NULL;
+      uninstall_demangler_signal_handler ();
 
       if (crash_signal != 0)
 	{
-	  static int error_reported = 0;
-
-	  if (!error_reported)
+	  /* Worker threads must not print; leave the report to the
+	     main thread.  */
+#ifdef CXX_STD_THREAD
+	  if (std::this_thread::get_id () != gdb_demangle_main_thread)
 	    {
-	      char *short_msg, *long_msg;
-	      struct cleanup *back_to;
-
-	      short_msg = xstrprintf (_("unable to demangle '%s' "
-				      "(demangler failed with signal %d)"),
-				    name, crash_signal);
-	      back_to = make_cleanup (xfree, short_msg);
-
-	      long_msg = xstrprintf ("%s:%d: %s: %s", __FILE__, __LINE__,
-				    "demangler-warning", short_msg);
-	      make_cleanup (xfree, long_msg);
-
-	      make_cleanup_restore_target_terminal ();
-	      target_terminal_ours_for_output ();
-
-	      begin_line ();
-	      if (core_dump_allowed)
-		fprintf_unfiltered (gdb_stderr,
-				    _("%s\nAttempting to dump core.\n"),
-				    long_msg);
-	      else
-		warn_cant_dump_core (long_msg);
-
-	      demangler_warning (__FILE__, __LINE__, "%s", short_msg);
+	      std::lock_guard<std::mutex> guard (gdb_demangle_lock);
 
-	      do_cleanups (back_to);
-
-	      error_reported = 1;
+	      if (deferred_crash_name.empty ())
+		{
+		  deferred_crash_name = name;
+		  deferred_crash_signal = crash_signal;
+		}
 	    }
+	  else
+#endif
+	    report_demangler_crash (name, crash_signal);
 
 	  result = NULL;
 	}
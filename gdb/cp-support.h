@@ -153,10 +153,17 @@ extern void cp_merge_demangle_parse_infos (struct demangle_parse_info *,
 
 extern struct cmd_list_element *maint_cplus_cmd_list;
 
-/* A wrapper for bfd_demangle.  */
+/* A wrapper for bfd_demangle.  It can be called from worker threads,
+   but if the demangler crashes in one of them, the crash is only
+   reported by the next call to report_deferred_demangler_crash.  */
 
 char *gdb_demangle (const char *name, int options);
 
+/* Report a demangler crash that happened in a worker thread, if any.
+   Must be called from the main thread.  */
+
+void report_deferred_demangler_crash (void);
+
 /* Like gdb_demangle, but suitable for use as la_sniff_from_mangled_name.  */
 
 int gdb_sniff_from_mangled_name (const char *mangled, char **demangled);
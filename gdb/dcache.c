@@ -23,7 +23,10 @@
 #include "gdbcore.h"
 #include "target-dcache.h"
 #include "inferior.h"
-#include "splay-tree.h"
+#include "selftest.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
 /* Commands with a prefix of `{set,show} dcache'.  */
 static struct cmd_list_element *dcache_set_list = NULL;
@@ -42,10 +45,17 @@ static struct cmd_list_element *dcache_show_list = NULL;
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
-   The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
-   remember the address of the line (which must be a multiple of
-   LINE_SIZE) and the actual data block.
+   The cache is an open-addressing hash table, keyed by line address,
+   along with a linked list for replacement.  Each block caches a
+   LINE_SIZE area of memory.  Within each line we remember the address
+   of the line (which must be a multiple of LINE_SIZE) and the actual
+   data block.
+
+   A miss fills all the uncached lines of the request that follow the
+   missing one with a single transfer.  When misses walk forward
+   through memory, lines past the end of the request are filled too,
+   in a window that doubles with each sequential miss up to
+   DCACHE_PREFETCH_LINES lines.
 
    Lines are only allocated as needed, so DCACHE_SIZE really specifies the
    *maximum* number of lines in the cache.
@@ -59,8 +69,8 @@ static struct cmd_list_element *dcache_show_list = NULL;
 /* NOTE: Interaction of dcache and memory region attributes
 
    As there is no requirement that memory region attributes be aligned
-   to or be a multiple of the dcache page size, dcache_read_line() and
-   dcache_write_line() must break up the page by memory region.  If a
+   to or be a multiple of the dcache page size, dcache_read_lines()
+   must break up the page by memory region.  If a
    chunk does not have the cache attribute set, an invalid memory type
    is set, etc., then the chunk is skipped.  Those chunks are handled
    in target_xfer_memory() (or target_xfer_memory_partial()).
@@ -82,6 +92,15 @@ static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
 #define DCACHE_DEFAULT_LINE_SIZE 64
 static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
 
+/* The maximum number of lines read ahead of a sequential access.
+   Zero disables reading ahead.  */
+#define DCACHE_DEFAULT_PREFETCH_LINES 16
+static unsigned dcache_prefetch_lines = DCACHE_DEFAULT_PREFETCH_LINES;
+
+/* The initial number of slots of the line table.  It must be a power
+   of 2.  The table doubles whenever it becomes half full.  */
+#define DCACHE_INITIAL_TABLE_SIZE 64
+
 /* Each cache block holds LINE_SIZE bytes of data
    starting at a multiple-of-LINE_SIZE address.  */
 
@@ -97,12 +116,40 @@ struct dcache_block
 
   CORE_ADDR addr;		/* address of data */
   int refs;			/* # hits */
+  int prefetched;		/* read ahead and not hit yet */
   gdb_byte data[1];		/* line_size bytes at given address */
 };
 
+/* Counters shown by "info dcache".  They survive invalidation, and
+   are only reset when the line size changes.  */
+
+struct dcache_stats
+{
+  /* Lines looked up by reads and found, or not found.  */
+  ULONGEST hits;
+  ULONGEST misses;
+
+  /* Hits on lines that were read ahead.  */
+  ULONGEST prefetch_hits;
+
+  /* Transfers made to fill lines, the lines they filled, and how many
+     of those were read ahead of the request.  */
+  ULONGEST fills;
+  ULONGEST lines_filled;
+  ULONGEST lines_prefetched;
+
+  /* Total time spent waiting for fills.  */
+  std::chrono::steady_clock::duration fill_time;
+};
+
 struct dcache_struct
 {
-  splay_tree tree;
+  /* The line table, indexed by a hash of the line address, using
+     linear probing.  TABLE_SIZE is a power of 2 at least twice SIZE,
+     so that probe sequences stay short.  */
+  struct dcache_block **table;
+  unsigned int table_size;
+
   struct dcache_block *oldest; /* least-recently-allocated list.  */
 
   /* The free list is maintained identically to OLDEST to simplify
@@ -115,14 +162,19 @@ struct dcache_struct
 
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
+
+  /* The address just past the lines of the last fill, and the number
+     of lines read ahead by the next fill if it starts there.  */
+  CORE_ADDR next_fill_addr;
+  unsigned int prefetch_window;
+
+  struct dcache_stats stats;
 };
 
 typedef void (block_func) (struct dcache_block *block, void *param);
 
 static struct dcache_block *dcache_hit (DCACHE *dcache, CORE_ADDR addr);
 
-static int dcache_read_line (DCACHE *dcache, struct dcache_block *db);
-
 static struct dcache_block *dcache_alloc (DCACHE *dcache, CORE_ADDR addr);
 
 static void dcache_info (char *exp, int tty);
@@ -209,6 +261,113 @@ for_each_block (struct dcache_block **blist, block_func *func, void *param)
   while (*blist && db != *blist);
 }
 
+/* Return the slot of the line table of DCACHE where the search for
+   the line at ADDR starts.  */
+
+static unsigned int
+dcache_hash (DCACHE *dcache, CORE_ADDR addr)
+{
+  /* Multiplicative hashing: the high bits of the product depend on
+     all the bits of the line number.  */
+  uint64_t line = addr / dcache->line_size;
+  uint64_t product = line * 0x9e3779b97f4a7c15ULL;
+
+  return (product >> 32) & (dcache->table_size - 1);
+}
+
+/* Return the slot of the line table of DCACHE holding the line at
+   ADDR, or the empty slot ending its probe sequence if it is not
+   cached.  */
+
+static unsigned int
+dcache_find_slot (DCACHE *dcache, CORE_ADDR addr)
+{
+  unsigned int mask = dcache->table_size - 1;
+  unsigned int slot = dcache_hash (dcache, addr);
+
+  while (dcache->table[slot] != NULL && dcache->table[slot]->addr != addr)
+    slot = (slot + 1) & mask;
+
+  return slot;
+}
+
+/* Return the block for the line at ADDR, which must be a multiple of
+   the line size, or NULL if it is not cached.  */
+
+static struct dcache_block *
+dcache_lookup (DCACHE *dcache, CORE_ADDR addr)
+{
+  return dcache->table[dcache_find_slot (dcache, addr)];
+}
+
+/* Make the line table of DCACHE TABLE_SIZE slots large, and insert
+   the valid blocks into it.  */
+
+static void
+dcache_resize_table (DCACHE *dcache, unsigned int table_size)
+{
+  struct dcache_block *db;
+
+  xfree (dcache->table);
+  dcache->table = XCNEWVEC (struct dcache_block *, table_size);
+  dcache->table_size = table_size;
+
+  db = dcache->oldest;
+  if (db != NULL)
+    do
+      {
+	dcache->table[dcache_find_slot (dcache, db->addr)] = db;
+	db = db->next;
+      }
+    while (db != dcache->oldest);
+}
+
+/* Add DB to the line table of DCACHE.  The caller has counted it in
+   DCACHE->size already.  */
+
+static void
+dcache_table_insert (DCACHE *dcache, struct dcache_block *db)
+{
+  if (2 * (unsigned int) dcache->size > dcache->table_size)
+    dcache_resize_table (dcache, 2 * dcache->table_size);
+
+  dcache->table[dcache_find_slot (dcache, db->addr)] = db;
+}
+
+/* Remove DB from the line table of DCACHE.  */
+
+static void
+dcache_table_remove (DCACHE *dcache, struct dcache_block *db)
+{
+  unsigned int mask = dcache->table_size - 1;
+  unsigned int hole = dcache_find_slot (dcache, db->addr);
+  unsigned int slot = hole;
+
+  gdb_assert (dcache->table[hole] == db);
+  dcache->table[hole] = NULL;
+
+  /* Move back the blocks that follow in the same cluster and whose
+     probe sequence passes through the hole, so that lookups do not
+     stop early at it.  */
+  for (slot = (slot + 1) & mask;
+       dcache->table[slot] != NULL;
+       slot = (slot + 1) & mask)
+    {
+      unsigned int home = dcache_hash (dcache, dcache->table[slot]->addr);
+
+      /* The block may stay where it is if its home slot lies
+	 cyclically in (HOLE, SLOT].  */
+      if (hole <= slot
+	  ? (hole < home && home <= slot)
+	  : (hole < home || home <= slot))
+	continue;
+
+      dcache->table[hole] = dcache->table[slot];
+      dcache->table[slot] = NULL;
+      hole = slot;
+    }
+}
+
 /* BLOCK_FUNC routine for dcache_free.  */
 
 static void
@@ -222,23 +381,30 @@ free_block (struct dcache_block *block, void *param)
 void
 dcache_free (DCACHE *dcache)
 {
-  splay_tree_delete (dcache->tree);
+  xfree (dcache->table);
   for_each_block (&dcache->oldest, free_block, NULL);
   for_each_block (&dcache->freelist, free_block, NULL);
   xfree (dcache);
 }
 
 
+/* Reset the statistics of DCACHE.  */
+
+static void
+dcache_reset_stats (DCACHE *dcache)
+{
+  dcache->stats = dcache_stats ();
+}
+
 /* BLOCK_FUNC function for dcache_invalidate.
    This doesn't remove the block from the oldest list on purpose.
-   dcache_invalidate will do it later.  */
+   dcache_invalidate will do it later, and clear the line table.  */
 
 static void
 invalidate_block (struct dcache_block *block, void *param)
 {
   DCACHE *dcache = (DCACHE *) param;
 
-  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
   append_block (&dcache->freelist, block);
 }
 
@@ -252,6 +418,9 @@ dcache_invalidate (DCACHE *dcache)
   dcache->oldest = NULL;
   dcache->size = 0;
   dcache->ptid = null_ptid;
+  dcache->next_fill_addr = 0;
+  dcache->prefetch_window = 0;
+  memset (dcache->table, 0, dcache->table_size * sizeof (*dcache->table));
 
   if (dcache->line_size != dcache_line_size)
     {
@@ -261,6 +430,9 @@ dcache_invalidate (DCACHE *dcache)
       for_each_block (&dcache->freelist, free_block, dcache);
       dcache->freelist = NULL;
       dcache->line_size = dcache_line_size;
+
+      /* The statistics of the old lines would be misleading.  */
+      dcache_reset_stats (dcache);
     }
 }
 
@@ -273,7 +445,7 @@ dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 
   if (db)
     {
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache_table_remove (dcache, db);
       remove_block (&dcache->oldest, db);
       append_block (&dcache->freelist, db);
       --dcache->size;
@@ -286,43 +458,34 @@ dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 static struct dcache_block *
 dcache_hit (DCACHE *dcache, CORE_ADDR addr)
 {
-  struct dcache_block *db;
+  struct dcache_block *db = dcache_lookup (dcache, MASK (dcache, addr));
 
-  splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (dcache, addr));
-
-  if (!node)
-    return NULL;
-
-  db = (struct dcache_block *) node->value;
-  db->refs++;
+  if (db != NULL)
+    db->refs++;
   return db;
 }
 
-/* Fill a cache line from target memory.
-   The result is 1 for success, 0 if the (entire) cache line
-   wasn't readable.  */
+/* Read N_LINES cache lines of DCACHE from target memory at ADDR into
+   BUF, in as few transfers as the memory regions allow.  Return the
+   number of whole lines read, counting from ADDR; the lines after the
+   first unreadable byte are not read.  */
 
-static int
-dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+static unsigned int
+dcache_read_lines (DCACHE *dcache, CORE_ADDR addr, unsigned int n_lines,
+		   gdb_byte *buf)
 {
-  CORE_ADDR memaddr;
-  gdb_byte *myaddr;
-  int len;
-  int res;
-  int reg_len;
-  struct mem_region *region;
+  ULONGEST len = (ULONGEST) n_lines * dcache->line_size;
+  ULONGEST done = 0;
 
-  len = dcache->line_size;
-  memaddr = db->addr;
-  myaddr  = db->data;
-
-  while (len > 0)
+  while (done < len)
     {
+      CORE_ADDR memaddr = addr + done;
+      struct mem_region *region = lookup_mem_region (memaddr);
+      ULONGEST reg_len;
+
       /* Don't overrun if this block is right at the end of the region.  */
-      region = lookup_mem_region (memaddr);
-      if (region->hi == 0 || memaddr + len < region->hi)
-	reg_len = len;
+      if (region->hi == 0 || memaddr + (len - done) < region->hi)
+	reg_len = len - done;
       else
 	reg_len = region->hi - memaddr;
 
@@ -330,22 +493,31 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
          since we may be loading this for a stack access.  */
       if (region->attrib.mode == MEM_WO)
 	{
-	  memaddr += reg_len;
-	  myaddr  += reg_len;
-	  len     -= reg_len;
+	  done += reg_len;
 	  continue;
 	}
 
-      res = target_read_raw_memory (memaddr, myaddr, reg_len);
-      if (res != 0)
-	return 0;
-
-      memaddr += reg_len;
-      myaddr += reg_len;
-      len -= reg_len;
+      while (reg_len > 0)
+	{
+	  enum target_xfer_status status;
+	  ULONGEST xfered;
+
+	  /* See comment in target_read_memory about why the request
+	     starts at current_target.beneath.  */
+	  status = target_xfer_partial (current_target.beneath,
+					TARGET_OBJECT_RAW_MEMORY, NULL,
+					buf + done, NULL, addr + done,
+					reg_len, &xfered);
+	  if (status != TARGET_XFER_OK)
+	    return done / dcache->line_size;
+
+	  done += xfered;
+	  reg_len -= xfered;
+	  QUIT;
+	}
     }
 
-  return 1;
+  return n_lines;
 }
 
 /* Get a free cache block, put or keep it on the valid list,
@@ -362,7 +534,7 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
       db = dcache->oldest;
       remove_block (&dcache->oldest, db);
 
-      splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
+      dcache_table_remove (dcache, db);
     }
   else
     {
@@ -379,36 +551,125 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 
   db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->prefetched = 0;
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
 
-  splay_tree_insert (dcache->tree, (splay_tree_key) db->addr,
-		     (splay_tree_value) db);
+  dcache_table_insert (dcache, db);
 
   return db;
 }
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+/* Return true if the line of DCACHE following the line at ADDR exists,
+   without wrapping around the address space, and is not cached.  */
+
+static bool
+dcache_next_line_missing (DCACHE *dcache, CORE_ADDR addr)
+{
+  CORE_ADDR next = addr + dcache->line_size;
+
+  return next > addr && dcache_lookup (dcache, next) == NULL;
+}
 
-   Returns 1 for success, 0 for error.  */
+/* Fill the line of DCACHE containing ADDR, which is not cached, from
+   target memory.  LAST is the last address of the request ADDR is
+   part of; the uncached lines following ADDR's up to LAST are filled
+   by the same transfer, as are the lines read ahead if the miss
+   continues a sequential walk.  Return the block of ADDR, or NULL if
+   its line could not be read.  */
 
-static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+static struct dcache_block *
+dcache_fill (DCACHE *dcache, CORE_ADDR addr, CORE_ADDR last)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  CORE_ADDR first = MASK (dcache, addr);
+  CORE_ADDR line_addr, prefetch_end;
+  unsigned int max_lines = dcache_size;
+  unsigned int n_demand, n_lines, n_read, i;
+  struct dcache_block *first_db = NULL;
+  struct mem_region *region;
 
-  if (!db)
+  /* Lines are allocated after the transfer, so filling more lines
+     than the cache holds would evict the first ones.  */
+  n_demand = 1;
+  line_addr = first;
+  while (n_demand < max_lines
+	 && line_addr + dcache->line_size <= MASK (dcache, last)
+	 && dcache_next_line_missing (dcache, line_addr))
     {
-      db = dcache_alloc (dcache, addr);
+      n_demand++;
+      line_addr += dcache->line_size;
+    }
 
-      if (!dcache_read_line (dcache, db))
-         return 0;
+  /* A miss on the line just past the last fill continues a sequential
+     walk, so read further ahead.  Reading ahead stops at the end of
+     the memory region, to keep away from memory with different
+     attributes.  */
+  if (first == dcache->next_fill_addr && dcache_prefetch_lines > 0)
+    dcache->prefetch_window
+      = std::min (std::max (2 * dcache->prefetch_window, 1u),
+		  dcache_prefetch_lines);
+  else
+    dcache->prefetch_window = 0;
+
+  region = lookup_mem_region (line_addr);
+  prefetch_end = region->hi;
+  n_lines = n_demand;
+  while (n_lines < n_demand + dcache->prefetch_window
+	 && n_lines < max_lines
+	 && (prefetch_end == 0
+	     || line_addr + 2 * dcache->line_size <= prefetch_end)
+	 && dcache_next_line_missing (dcache, line_addr))
+    {
+      n_lines++;
+      line_addr += dcache->line_size;
     }
 
-  *ptr = db->data[XFORM (dcache, addr)];
-  return 1;
+  std::vector<gdb_byte> buf ((size_t) n_lines * dcache->line_size);
+  std::chrono::steady_clock::time_point start
+    = std::chrono::steady_clock::now ();
+
+  n_read = dcache_read_lines (dcache, first, n_lines, buf.data ());
+
+  /* A transfer fails as a whole on some targets, so if the lines
+     after the first are not readable, try again with the first line
+     alone.  */
+  if (n_read == 0 && n_lines > 1)
+    {
+      n_demand = n_lines = 1;
+      dcache->stats.fills++;
+      n_read = dcache_read_lines (dcache, first, 1, buf.data ());
+    }
+
+  dcache->stats.fills++;
+  dcache->stats.fill_time += std::chrono::steady_clock::now () - start;
+
+  if (n_read == 0)
+    {
+      dcache->next_fill_addr = 0;
+      dcache->prefetch_window = 0;
+      return NULL;
+    }
+
+  for (i = 0; i < n_read; i++)
+    {
+      struct dcache_block *db
+	= dcache_alloc (dcache, first + i * dcache->line_size);
+
+      memcpy (db->data, &buf[(size_t) i * dcache->line_size],
+	      dcache->line_size);
+      if (i >= n_demand)
+	{
+	  db->prefetched = 1;
+	  dcache->stats.lines_prefetched++;
+	}
+      if (i == 0)
+	first_db = db;
+    }
+
+  dcache->stats.lines_filled += n_read;
+  dcache->next_fill_addr = first + n_read * dcache->line_size;
+  return first_db;
 }
 
 /* Write the byte at PTR into ADDR in the data cache.
@@ -429,17 +690,6 @@ dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, const gdb_byte *ptr)
     db->data[XFORM (dcache, addr)] = *ptr;
 }
 
-static int
-dcache_splay_tree_compare (splay_tree_key a, splay_tree_key b)
-{
-  if (a > b)
-    return 1;
-  else if (a == b)
-    return 0;
-  else
-    return -1;
-}
-
 /* Allocate and initialize a data cache.  */
 
 DCACHE *
@@ -447,15 +697,16 @@ dcache_init (void)
 {
   DCACHE *dcache = XNEW (DCACHE);
 
-  dcache->tree = splay_tree_new (dcache_splay_tree_compare,
-				 NULL,
-				 NULL);
-
+  dcache->table = XCNEWVEC (struct dcache_block *, DCACHE_INITIAL_TABLE_SIZE);
+  dcache->table_size = DCACHE_INITIAL_TABLE_SIZE;
   dcache->oldest = NULL;
   dcache->freelist = NULL;
   dcache->size = 0;
   dcache->line_size = dcache_line_size;
   dcache->ptid = null_ptid;
+  dcache->next_fill_addr = 0;
+  dcache->prefetch_window = 0;
+  dcache_reset_stats (dcache);
 
   return dcache;
 }
@@ -482,15 +733,34 @@ dcache_read_memory_partial (struct target_ops *ops, DCACHE *dcache,
       dcache->ptid = inferior_ptid;
     }
 
-  for (i = 0; i < len; i++)
+  i = 0;
+  while (i < len)
     {
-      if (!dcache_peek_byte (dcache, memaddr + i, myaddr + i))
+      CORE_ADDR addr = memaddr + i;
+      ULONGEST offset = XFORM (dcache, addr);
+      ULONGEST chunk = std::min<ULONGEST> (dcache->line_size - offset,
+					   len - i);
+      struct dcache_block *db = dcache_hit (dcache, addr);
+
+      if (db != NULL)
 	{
-	  /* That failed.  Discard its cache line so we don't have a
-	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  break;
+	  dcache->stats.hits++;
+	  if (db->prefetched)
+	    {
+	      dcache->stats.prefetch_hits++;
+	      db->prefetched = 0;
+	    }
 	}
+      else
+	{
+	  dcache->stats.misses++;
+	  db = dcache_fill (dcache, addr, memaddr + len - 1);
+	  if (db == NULL)
+	    break;
+	}
+
+      memcpy (myaddr + i, db->data + offset, chunk);
+      i += chunk;
     }
 
   if (i == 0)
@@ -538,14 +808,38 @@ dcache_update (DCACHE *dcache, enum target_xfer_status status,
       }
 }
 
+/* Return the valid blocks of DCACHE, sorted by address.  */
+
+static std::vector<struct dcache_block *>
+dcache_sorted_blocks (DCACHE *dcache)
+{
+  std::vector<struct dcache_block *> blocks;
+  struct dcache_block *db = dcache->oldest;
+
+  if (db != NULL)
+    do
+      {
+	blocks.push_back (db);
+	db = db->next;
+      }
+    while (db != dcache->oldest);
+
+  std::sort (blocks.begin (), blocks.end (),
+	     [] (const struct dcache_block *a, const struct dcache_block *b)
+	     {
+	       return a->addr < b->addr;
+	     });
+
+  return blocks;
+}
+
 /* Print DCACHE line INDEX.  */
 
 static void
 dcache_print_line (DCACHE *dcache, int index)
 {
-  splay_tree_node n;
   struct dcache_block *db;
-  int i, j;
+  int j;
 
   if (dcache == NULL)
     {
@@ -553,22 +847,15 @@ dcache_print_line (DCACHE *dcache, int index)
       return;
     }
 
-  n = splay_tree_min (dcache->tree);
-
-  for (i = index; i > 0; --i)
-    {
-      if (!n)
-	break;
-      n = splay_tree_successor (dcache->tree, n->key);
-    }
+  std::vector<struct dcache_block *> blocks = dcache_sorted_blocks (dcache);
 
-  if (!n)
+  if ((size_t) index >= blocks.size ())
     {
       printf_filtered (_("No such cache line exists.\n"));
       return;
     }
-    
-  db = (struct dcache_block *) n->value;
+
+  db = blocks[index];
 
   printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		   index, paddress (target_gdbarch (), db->addr), db->refs);
@@ -584,12 +871,39 @@ dcache_print_line (DCACHE *dcache, int index)
   printf_filtered ("\n");
 }
 
+/* Print the statistics of DCACHE, if it has been used.  */
+
+static void
+dcache_print_stats (DCACHE *dcache)
+{
+  const struct dcache_stats &stats = dcache->stats;
+
+  if (stats.hits == 0 && stats.misses == 0)
+    return;
+
+  printf_filtered (_("Lookups: %s hits, %s misses, "
+		     "%s hits on lines read ahead\n"),
+		   pulongest (stats.hits), pulongest (stats.misses),
+		   pulongest (stats.prefetch_hits));
+
+  if (stats.fills == 0)
+    return;
+
+  ULONGEST average_us
+    = (std::chrono::duration_cast<std::chrono::microseconds> (stats.fill_time)
+       .count () / stats.fills);
+
+  printf_filtered (_("Fills: %s transfers of %s lines (%s read ahead), "
+		     "%s us average latency\n"),
+		   pulongest (stats.fills), pulongest (stats.lines_filled),
+		   pulongest (stats.lines_prefetched), pulongest (average_us));
+}
+
 /* Parse EXP and show the info about DCACHE.  */
 
 static void
 dcache_info_1 (DCACHE *dcache, char *exp)
 {
-  splay_tree_node n;
   int i, refcount;
 
   if (exp)
@@ -612,6 +926,9 @@ dcache_info_1 (DCACHE *dcache, char *exp)
 		   dcache ? (unsigned) dcache->line_size
 		   : dcache_line_size);
 
+  if (dcache != NULL)
+    dcache_print_stats (dcache);
+
   if (dcache == NULL || ptid_equal (dcache->ptid, null_ptid))
     {
       printf_filtered (_("No data cache available.\n"));
@@ -622,20 +939,14 @@ dcache_info_1 (DCACHE *dcache, char *exp)
 		   target_pid_to_str (dcache->ptid));
 
   refcount = 0;
-
-  n = splay_tree_min (dcache->tree);
   i = 0;
 
-  while (n)
+  for (struct dcache_block *db : dcache_sorted_blocks (dcache))
     {
-      struct dcache_block *db = (struct dcache_block *) n->value;
-
       printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		       i, paddress (target_gdbarch (), db->addr), db->refs);
       i++;
       refcount += db->refs;
-
-      n = splay_tree_successor (dcache->tree, n->key);
     }
 
   printf_filtered (_("Cache state: %d active lines, %d hits\n"), i, refcount);
@@ -687,6 +998,58 @@ show_dcache_command (char *args, int from_tty)
   cmd_show_list (dcache_show_list, from_tty, "");
 }
 
+#if GDB_SELF_TEST
+
+namespace selftests {
+
+/* Check that the line table of a cache finds exactly the lines that
+   were allocated and not evicted or invalidated, including when many
+   lines collide.  */
+
+static void
+dcache_table_tests ()
+{
+  DCACHE *dcache = dcache_init ();
+  std::vector<CORE_ADDR> valid;
+  unsigned int i;
+
+  /* Use addresses far apart, so that some land in the same slot.  */
+  for (i = 0; i < 300; i++)
+    {
+      CORE_ADDR addr = (CORE_ADDR) i * 4096 * dcache->line_size + 8;
+
+      dcache_alloc (dcache, addr);
+      valid.push_back (MASK (dcache, addr));
+    }
+  SELF_CHECK (dcache->table_size >= 2 * 300);
+
+  /* Drop every third line, then check all the others are still
+     found.  */
+  for (i = 0; i < valid.size (); i += 3)
+    dcache_invalidate_line (dcache, valid[i]);
+
+  for (i = 0; i < valid.size (); i++)
+    {
+      struct dcache_block *db = dcache_lookup (dcache, valid[i]);
+
+      if (i % 3 == 0)
+	SELF_CHECK (db == NULL);
+      else
+	SELF_CHECK (db != NULL && db->addr == valid[i]);
+    }
+  SELF_CHECK (dcache->size == 200);
+
+  dcache_invalidate (dcache);
+  for (i = 0; i < valid.size (); i++)
+    SELF_CHECK (dcache_lookup (dcache, valid[i]) == NULL);
+
+  dcache_free (dcache);
+}
+
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
 void
 _initialize_dcache (void)
 {
@@ -705,9 +1068,9 @@ exists only for compatibility reasons."),
   add_info ("dcache", dcache_info,
 	    _("\
 Print information on the dcache performance.\n\
-With no arguments, this command prints the cache configuration and a\n\
-summary of each line in the cache.  Use \"info dcache <lineno> to dump\"\n\
-the contents of a given line."));
+With no arguments, this command prints the cache configuration, hit\n\
+and fill statistics, and a summary of each line in the cache.\n\
+Use \"info dcache <lineno>\" to dump the contents of a given line."));
 
   add_prefix_cmd ("dcache", class_obscure, set_dcache_command, _("\
 Use this command to set number of lines in dcache and line-size."),
@@ -724,6 +1087,18 @@ Show dcache line size."),
 			     set_dcache_line_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+  add_setshow_zuinteger_cmd ("prefetch-lines", class_obscure,
+			     &dcache_prefetch_lines, _("\
+Set the maximum number of dcache lines read ahead of sequential accesses."),
+			     _("\
+Show the maximum number of dcache lines read ahead of sequential accesses."),
+			     _("\
+When reads miss the cache on consecutive lines, the cache reads lines\n\
+past the end of each request, doubling the number of lines read ahead\n\
+up to this limit.  Zero disables reading ahead."),
+			     NULL,
+			     NULL,
+			     &dcache_set_list, &dcache_show_list);
   add_setshow_zuinteger_cmd ("size", class_obscure,
 			     &dcache_size, _("\
 Set number of dcache lines."), _("\
@@ -732,4 +1107,8 @@ Show number of dcache lines."),
 			     set_dcache_size,
 			     NULL,
 			     &dcache_set_list, &dcache_show_list);
+
+#if GDB_SELF_TEST
+  register_self_test (selftests::dcache_table_tests);
+#endif
 }
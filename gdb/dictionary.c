@@ -245,8 +245,6 @@ static struct symbol *iter_match_next_hashed (const char *name,
 					      symbol_compare_ftype *compare,
 					      struct dict_iterator *iterator);
 
-static unsigned int dict_hash (const char *string);
-
 /* Functions only for DICT_HASHED.  */
 
 static int size_hashed (const struct dictionary *dict);
@@ -784,7 +782,7 @@ expand_hashtable (struct dictionary *dict)
    That is, two identifiers equivalent according to any of those three
    comparison operators hash to the same value.  */
 
-static unsigned int
+unsigned int
 dict_hash (const char *string0)
 {
   /* The Ada-encoded version of a name P1.P2...Pn has either the form
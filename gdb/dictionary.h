@@ -164,6 +164,12 @@ extern struct symbol *dict_iter_match_next (const char *name,
 					    symbol_compare_ftype *compare,
 					    struct dict_iterator *iterator);
 
+/* Produce an unsigned hash value from STRING0 that is consistent
+   with strcmp_iw, strcmp, and, at least on Ada symbols, wild_match.
+   Symbols are found in hashed dictionaries by this value.  */
+
+extern unsigned int dict_hash (const char *string0);
+
 /* Return some notion of the size of the dictionary: the number of
    symbols if we have that, the number of hash buckets otherwise.  */
 
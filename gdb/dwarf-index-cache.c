@@ -0,0 +1,628 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "dwarf-index-cache.h"
+
+#include "build-id.h"
+#include "cli/cli-cmds.h"
+#include "command.h"
+#include "gdbcmd.h"
+#include "objfiles.h"
+#include "symfile.h"
+#include "filestuff.h"
+#include "readline/tilde.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <utime.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#include <algorithm>
+#include <vector>
+
+/* When set to 1, show debug messages about the index cache.  */
+static int debug_index_cache = 0;
+
+/* The index cache directory, used for "set/show index-cache directory".  */
+static char *index_cache_directory = NULL;
+
+/* The size limit of the index cache in megabytes, or -1 for no
+   limit.  Used for "set/show index-cache max-size".  */
+static int index_cache_max_size = 1024;
+
+/* The suffix of the index files in the cache.  */
+#define INDEX_CACHE_SUFFIX ".gdb-index"
+
+/* The suffix of the demangled names files in the cache.  */
+#define DEMANGLED_NAMES_SUFFIX ".demangled"
+
+/* See dwarf-index-cache.h.  */
+index_cache global_index_cache;
+
+/* set/show index-cache commands.  */
+static cmd_list_element *set_index_cache_prefix_list;
+static cmd_list_element *show_index_cache_prefix_list;
+
+/* See dwarf-index-cache.h.  */
+
+index_cache_resource::~index_cache_resource ()
+{
+#ifdef HAVE_MMAP
+  if (m_mapped)
+    {
+      munmap (m_data, m_size);
+      return;
+    }
+#endif
+  xfree (m_data);
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::unique_ptr<index_cache_resource>
+index_cache_resource::open (const std::string &filename)
+{
+  struct stat st;
+  gdb_byte *data;
+  bool mapped = false;
+  int fd;
+
+  fd = gdb_open_cloexec (filename.c_str (), O_RDONLY | O_BINARY, 0);
+  if (fd < 0)
+    return NULL;
+
+  if (fstat (fd, &st) < 0 || st.st_size == 0)
+    {
+      close (fd);
+      return NULL;
+    }
+
+#ifdef HAVE_MMAP
+  data = (gdb_byte *) mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data != (gdb_byte *) MAP_FAILED)
+    mapped = true;
+  else
+#endif
+    {
+      size_t done = 0;
+
+      data = (gdb_byte *) xmalloc (st.st_size);
+      while (done < st.st_size)
+	{
+	  ssize_t n = read (fd, data + done, st.st_size - done);
+
+	  if (n <= 0)
+	    {
+	      xfree (data);
+	      close (fd);
+	      return NULL;
+	    }
+	  done += n;
+	}
+    }
+
+  close (fd);
+
+  return std::unique_ptr<index_cache_resource>
+    (new index_cache_resource (filename, data, st.st_size, mapped));
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::set_directory (std::string dir)
+{
+  gdb_assert (!dir.empty ());
+
+  m_dir = std::move (dir);
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: now using directory %s\n",
+		       m_dir.c_str ());
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::enable (bool enabled)
+{
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: %s\n",
+		       enabled ? "enabling" : "disabling");
+
+  m_enabled = enabled;
+}
+
+/* Create DIR and any missing parents.  Return false and set errno on
+   failure.  */
+
+static bool
+mkdir_recursive (const char *dir)
+{
+  std::string path (dir);
+  size_t pos = 0;
+
+  while (pos != std::string::npos)
+    {
+      pos = path.find ('/', pos + 1);
+
+      std::string component = path.substr (0, pos);
+      if (mkdir (component.c_str (), 0700) != 0 && errno != EEXIST)
+	return false;
+    }
+
+  return true;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store (struct objfile *objfile)
+{
+  const struct bfd_build_id *build_id;
+
+  if (!enabled ())
+    return;
+
+  build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id == NULL)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: objfile %s has no build id\n",
+			   objfile_name (objfile));
+      return;
+    }
+
+  if (m_dir.empty ())
+    {
+      warning (_("The index cache directory is not set, "
+		 "disabling the index cache."));
+      enable (false);
+      return;
+    }
+
+  TRY
+    {
+      std::string filename = make_index_filename (build_id,
+						  INDEX_CACHE_SUFFIX);
+
+      /* dwarf2_write_index adds the suffix itself.  */
+      filename.resize (filename.size () - strlen (INDEX_CACHE_SUFFIX));
+      const char *basename = lbasename (filename.c_str ());
+
+      if (!mkdir_recursive (m_dir.c_str ()))
+	error (_("Unable to create cache directory %s: %s"),
+	       m_dir.c_str (), safe_strerror (errno));
+
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: writing index cache for objfile %s\n",
+			   objfile_name (objfile));
+
+      dwarf2_write_index (objfile, m_dir.c_str (), basename,
+			  dw_index_kind::GDB_INDEX);
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't store index cache for "
+			   "objfile %s: %s\n", objfile_name (objfile),
+			   except.message);
+      return;
+    }
+  END_CATCH
+
+  trim ();
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::unique_ptr<index_cache_resource>
+index_cache::lookup_gdb_index (const struct bfd_build_id *build_id)
+{
+  if (!enabled () || m_dir.empty ())
+    return NULL;
+
+  std::string filename = make_index_filename (build_id, INDEX_CACHE_SUFFIX);
+  std::unique_ptr<index_cache_resource> res
+    = index_cache_resource::open (filename);
+
+  if (res == NULL)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't read %s\n",
+			   filename.c_str ());
+      miss ();
+      return NULL;
+    }
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: using %s\n", filename.c_str ());
+
+  /* Bump the modification time, which trim uses as the time of last
+     use.  */
+  utime (filename.c_str (), NULL);
+
+  hit ();
+  return res;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::store_demangled_names (const struct bfd_build_id *build_id,
+				    const std::string &contents)
+{
+  if (!enabled () || m_dir.empty ())
+    return;
+
+  std::string filename = make_index_filename (build_id,
+					      DEMANGLED_NAMES_SUFFIX);
+  std::string tmp_filename = string_printf ("%s.%ld.tmp", filename.c_str (),
+					    (long) getpid ());
+
+  if (!mkdir_recursive (m_dir.c_str ()))
+    return;
+
+  FILE *out_file = gdb_fopen_cloexec (tmp_filename.c_str (), "wb");
+  if (out_file == NULL)
+    return;
+
+  bool written = (fwrite (contents.data (), 1, contents.size (), out_file)
+		  == contents.size ());
+  if (fclose (out_file) != 0)
+    written = false;
+
+  if (!written || rename (tmp_filename.c_str (), filename.c_str ()) != 0)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't write %s\n",
+			   filename.c_str ());
+      unlink (tmp_filename.c_str ());
+      return;
+    }
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: wrote %s\n", filename.c_str ());
+
+  trim ();
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::unique_ptr<index_cache_resource>
+index_cache::lookup_demangled_names (const struct bfd_build_id *build_id)
+{
+  if (!enabled () || m_dir.empty ())
+    return NULL;
+
+  std::string filename = make_index_filename (build_id,
+					      DEMANGLED_NAMES_SUFFIX);
+  std::unique_ptr<index_cache_resource> res
+    = index_cache_resource::open (filename);
+
+  if (res == NULL)
+    {
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: couldn't read %s\n",
+			   filename.c_str ());
+      return NULL;
+    }
+
+  if (debug_index_cache)
+    printf_unfiltered ("index cache: using %s\n", filename.c_str ());
+
+  utime (filename.c_str (), NULL);
+
+  return res;
+}
+
+/* An entry in the cache directory, as seen by index_cache::trim.  */
+
+struct index_cache_entry
+{
+  std::string filename;
+  off_t size;
+  time_t mtime;
+};
+
+/* Return true if NAME ends with SUFFIX, and has something before it.  */
+
+static bool
+has_cache_suffix (const char *name, const char *suffix)
+{
+  size_t len = strlen (name);
+  size_t suffix_len = strlen (suffix);
+
+  return len > suffix_len && strcmp (name + len - suffix_len, suffix) == 0;
+}
+
+/* See dwarf-index-cache.h.  */
+
+void
+index_cache::trim ()
+{
+  std::vector<index_cache_entry> entries;
+  unsigned long long total = 0;
+  unsigned long long limit;
+  struct dirent *ent;
+  DIR *dir;
+
+  if (index_cache_max_size < 0 || m_dir.empty ())
+    return;
+
+  limit = (unsigned long long) index_cache_max_size * 1024 * 1024;
+
+  dir = opendir (m_dir.c_str ());
+  if (dir == NULL)
+    return;
+
+  while ((ent = readdir (dir)) != NULL)
+    {
+      struct stat st;
+
+      if (!has_cache_suffix (ent->d_name, INDEX_CACHE_SUFFIX)
+	  && !has_cache_suffix (ent->d_name, DEMANGLED_NAMES_SUFFIX))
+	continue;
+
+      std::string filename = m_dir + SLASH_STRING + ent->d_name;
+      if (stat (filename.c_str (), &st) != 0 || !S_ISREG (st.st_mode))
+	continue;
+
+      entries.push_back ({filename, st.st_size, st.st_mtime});
+      total += st.st_size;
+    }
+
+  closedir (dir);
+
+  if (total <= limit)
+    return;
+
+  std::sort (entries.begin (), entries.end (),
+	     [] (const index_cache_entry &a, const index_cache_entry &b)
+	     {
+	       return a.mtime < b.mtime;
+	     });
+
+  for (const index_cache_entry &entry : entries)
+    {
+      if (total <= limit)
+	break;
+
+      if (debug_index_cache)
+	printf_unfiltered ("index cache: removing %s\n",
+			   entry.filename.c_str ());
+
+      if (unlink (entry.filename.c_str ()) == 0)
+	total -= entry.size;
+    }
+}
+
+/* See dwarf-index-cache.h.  */
+
+std::string
+index_cache::make_index_filename (const struct bfd_build_id *build_id,
+				  const char *suffix) const
+{
+  std::string filename = m_dir + SLASH_STRING;
+
+  for (unsigned int i = 0; i < build_id->size; ++i)
+    filename += string_printf ("%02x", (unsigned) build_id->data[i]);
+
+  return filename + suffix;
+}
+
+/* Return the default index cache directory: $XDG_CACHE_HOME/gdb, or
+   $HOME/.cache/gdb.  Return an empty string if neither variable is
+   set.  */
+
+static std::string
+get_default_index_cache_directory ()
+{
+  const char *xdg_cache_home = getenv ("XDG_CACHE_HOME");
+
+  if (xdg_cache_home != NULL && xdg_cache_home[0] != '\0')
+    return string_printf ("%s/gdb", xdg_cache_home);
+
+  const char *home = getenv ("HOME");
+
+  if (home != NULL && home[0] != '\0')
+    return string_printf ("%s/.cache/gdb", home);
+
+  return std::string ();
+}
+
+/* "set index-cache" handler.  */
+
+static void
+set_index_cache_command (char *arg, int from_tty)
+{
+  printf_unfiltered (_("\
+Missing arguments.  See \"help set index-cache\" for help.\n"));
+}
+
+/* Whether we are in the context of showing the state of the index
+   cache, from "show index-cache" with no subcommand.  */
+static bool in_show_index_cache_command = false;
+
+/* "show index-cache" handler.  */
+
+static void
+show_index_cache_command (char *arg, int from_tty)
+{
+  /* Call all "show index-cache" subcommands.  */
+  in_show_index_cache_command = true;
+  cmd_show_list (show_index_cache_prefix_list, from_tty, "");
+  in_show_index_cache_command = false;
+
+  printf_unfiltered ("\n");
+  printf_unfiltered (_("The index cache is currently %s.\n"),
+		     global_index_cache.enabled () ? _("enabled")
+		     : _("disabled"));
+}
+
+/* "set index-cache on" handler.  */
+
+static void
+set_index_cache_on_command (char *arg, int from_tty)
+{
+  if (arg != NULL && *arg != '\0')
+    error (_("Unexpected argument \"%s\"."), arg);
+
+  global_index_cache.enable (true);
+}
+
+/* "set index-cache off" handler.  */
+
+static void
+set_index_cache_off_command (char *arg, int from_tty)
+{
+  if (arg != NULL && *arg != '\0')
+    error (_("Unexpected argument \"%s\"."), arg);
+
+  global_index_cache.enable (false);
+}
+
+/* "set index-cache directory" handler.  */
+
+static void
+set_index_cache_directory_command (char *arg, int from_tty,
+				   struct cmd_list_element *element)
+{
+  /* Make sure the index cache directory is absolute and tilde-expanded.  */
+  char *expanded = tilde_expand (index_cache_directory);
+
+  xfree (index_cache_directory);
+  index_cache_directory = gdb_abspath (expanded);
+  xfree (expanded);
+
+  global_index_cache.set_directory (index_cache_directory);
+}
+
+/* "set index-cache max-size" handler.  */
+
+static void
+set_index_cache_max_size_command (char *arg, int from_tty,
+				  struct cmd_list_element *element)
+{
+  global_index_cache.trim ();
+}
+
+/* "show index-cache stats" handler.  */
+
+static void
+show_index_cache_stats_command (char *arg, int from_tty)
+{
+  const char *indent = "";
+
+  /* If this command is invoked through "show index-cache", make the
+     display a bit nicer.  */
+  if (in_show_index_cache_command)
+    {
+      indent = "  ";
+      printf_unfiltered ("\n");
+    }
+
+  printf_unfiltered (_("%s  Cache hits (this session): %u\n"),
+		     indent, global_index_cache.n_hits ());
+  printf_unfiltered (_("%sCache misses (this session): %u\n"),
+		     indent, global_index_cache.n_misses ());
+}
+
+/* "show debug index-cache" handler.  */
+
+static void
+show_debug_index_cache (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Debugging of the index cache is %s.\n"), value);
+}
+
+void
+_initialize_index_cache (void)
+{
+  /* Set the default index cache directory.  */
+  std::string cache_dir = get_default_index_cache_directory ();
+  if (!cache_dir.empty ())
+    {
+      index_cache_directory = xstrdup (cache_dir.c_str ());
+      global_index_cache.set_directory (std::move (cache_dir));
+    }
+  else
+    warning (_("Couldn't determine a path for the index cache directory."));
+
+  /* set index-cache */
+  add_prefix_cmd ("index-cache", class_files, set_index_cache_command,
+		  _("Set index-cache options"), &set_index_cache_prefix_list,
+		  "set index-cache ", 0, &setlist);
+
+  /* show index-cache */
+  add_prefix_cmd ("index-cache", class_files, show_index_cache_command,
+		  _("Show index-cache options"), &show_index_cache_prefix_list,
+		  "show index-cache ", 0, &showlist);
+
+  /* set index-cache on */
+  add_cmd ("on", class_files, set_index_cache_on_command,
+	   _("Enable the index cache.\n\
+When on, GDB stores the index of each objfile with a build-id in the\n\
+cache directory after reading its symbols, and uses the stored index\n\
+the next time the same objfile is loaded."),
+	   &set_index_cache_prefix_list);
+
+  /* set index-cache off */
+  add_cmd ("off", class_files, set_index_cache_off_command,
+	   _("Disable the index cache."), &set_index_cache_prefix_list);
+
+  /* set index-cache directory */
+  add_setshow_filename_cmd ("directory", class_files, &index_cache_directory,
+			    _("Set the directory of the index cache."),
+			    _("Show the directory of the index cache."),
+			    NULL,
+			    set_index_cache_directory_command, NULL,
+			    &set_index_cache_prefix_list,
+			    &show_index_cache_prefix_list);
+
+  /* set index-cache max-size */
+  add_setshow_zuinteger_unlimited_cmd ("max-size", class_files,
+				       &index_cache_max_size, _("\
+Set the maximum size of the index cache, in megabytes."), _("\
+Show the maximum size of the index cache, in megabytes."), _("\
+When the files in the cache directory take more space than this, the\n\
+least recently used ones are removed.  \"unlimited\" means no limit."),
+				       set_index_cache_max_size_command, NULL,
+				       &set_index_cache_prefix_list,
+				       &show_index_cache_prefix_list);
+
+  /* show index-cache stats */
+  add_cmd ("stats", class_files, show_index_cache_stats_command,
+	   _("Show some stats about the index cache"),
+	   &show_index_cache_prefix_list);
+
+  /* set debug index-cache */
+  add_setshow_boolean_cmd ("index-cache", class_maintenance,
+			   &debug_index_cache,
+			   _("Set display of index-cache debug messages."),
+			   _("Show display of index-cache debug messages."),
+			   _("\
+When non-zero, debugging output for the index cache is displayed."),
+			    NULL, show_debug_index_cache,
+			    &setdebuglist, &showdebuglist);
+}
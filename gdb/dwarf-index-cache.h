@@ -0,0 +1,153 @@
+/* Caching of GDB/DWARF index files.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef DWARF_INDEX_CACHE_H
+#define DWARF_INDEX_CACHE_H
+
+#include <memory>
+#include <string>
+
+struct bfd_build_id;
+
+/* An index file read from the cache.  The contents stay valid, and
+   the file stays mapped, until the object is destroyed.  */
+
+class index_cache_resource
+{
+public:
+  ~index_cache_resource ();
+
+  /* Open FILENAME and map or read its contents.  Return NULL if the
+     file cannot be read.  */
+  static std::unique_ptr<index_cache_resource> open (const std::string &filename);
+
+  const char *filename () const
+  { return m_filename.c_str (); }
+
+  const gdb_byte *data () const
+  { return m_data; }
+
+  size_t size () const
+  { return m_size; }
+
+private:
+  index_cache_resource (const std::string &filename, gdb_byte *data,
+			size_t size, bool mapped)
+    : m_filename (filename), m_data (data), m_size (size), m_mapped (mapped)
+  {}
+
+  std::string m_filename;
+  gdb_byte *m_data;
+  size_t m_size;
+
+  /* True if M_DATA was mmapped, false if it was xmalloced.  */
+  bool m_mapped;
+};
+
+/* The index cache stores an index file for each objfile that has a
+   build-id, so that loading the objfile in a later session can skip
+   building partial symbols.  Files are named after the build-id, so
+   that an objfile which changes gets a different entry, and are
+   trimmed least-recently-used first when the cache grows over its
+   size limit.  The cache also keeps the demangled names of the
+   minimal symbols of each objfile with a build-id.  */
+
+class index_cache
+{
+public:
+  /* Change the directory used to save/load index files.  */
+  void set_directory (std::string dir);
+
+  /* Return the directory used to save/load index files.  */
+  const std::string &directory () const
+  { return m_dir; }
+
+  /* Enable or disable the cache.  */
+  void enable (bool enabled);
+
+  /* Return true if the cache is enabled.  */
+  bool enabled () const
+  { return m_enabled; }
+
+  /* Store an index for OBJFILE in the cache, if OBJFILE has a
+     build-id.  Failures are silently ignored, since the cache is only
+     an optimization.  */
+  void store (struct objfile *objfile);
+
+  /* Look for an index file matching BUILD_ID.  If found, return it,
+     otherwise return NULL.  */
+  std::unique_ptr<index_cache_resource>
+    lookup_gdb_index (const struct bfd_build_id *build_id);
+
+  /* Store CONTENTS as the demangled names of the minimal symbols of
+     the objfile with build id BUILD_ID.  The format belongs to
+     minsyms.c.  Failures are silently ignored.  */
+  void store_demangled_names (const struct bfd_build_id *build_id,
+			      const std::string &contents);
+
+  /* Look for the demangled names stored for BUILD_ID.  If found,
+     return them, otherwise return NULL.  These lookups are not counted
+     as hits or misses.  */
+  std::unique_ptr<index_cache_resource>
+    lookup_demangled_names (const struct bfd_build_id *build_id);
+
+  /* Remove the least recently used files until the cache is no larger
+     than the size limit.  */
+  void trim ();
+
+  /* Return the number of cache hits.  */
+  unsigned int n_hits () const
+  { return m_n_hits; }
+
+  /* Record a cache hit.  */
+  void hit ()
+  { m_n_hits++; }
+
+  /* Return the number of cache misses.  */
+  unsigned int n_misses () const
+  { return m_n_misses; }
+
+  /* Record a cache miss.  */
+  void miss ()
+  { m_n_misses++; }
+
+private:
+  /* Compute the absolute filename where the file with suffix SUFFIX
+     of the objfile with build id BUILD_ID will be stored.  */
+  std::string make_index_filename (const struct bfd_build_id *build_id,
+				   const char *suffix) const;
+
+  /* The base directory where we are storing and looking up index
+     files.  */
+  std::string m_dir;
+
+  /* Whether the cache is enabled.  */
+  bool m_enabled = false;
+
+  /* Number of times we looked up an index file and found it.  */
+  unsigned int m_n_hits = 0;
+
+  /* Number of times we looked up an index file and did not find it.  */
+  unsigned int m_n_misses = 0;
+};
+
+/* The global instance of the index cache.  */
+extern index_cache global_index_cache;
+
+#endif /* DWARF_INDEX_CACHE_H */
@@ -38,6 +38,9 @@
 #include "ax.h"
 #include "dwarf2loc.h"
 #include "dwarf2-frame-tailcall.h"
+#include "progspace.h"
+#include <algorithm>
+#include <vector>
 
 struct comp_unit;
 
@@ -125,6 +128,10 @@ struct dwarf2_fde_table
 {
   int num_entries;
   struct dwarf2_fde **entries;
+
+  /* The unwind rows computed for PCs covered by this table, or NULL
+     if none was computed yet.  See dwarf2_frame_find_row.  */
+  htab_t rows;
 };
 
 /* A minimal decoding of DWARF2 compilation units.  We only decode
@@ -156,6 +163,9 @@ struct comp_unit
 static struct dwarf2_fde *dwarf2_frame_find_fde (CORE_ADDR *pc,
 						 CORE_ADDR *out_offset);
 
+static struct dwarf2_fde_table *dwarf2_frame_fde_table
+  (struct objfile *objfile);
+
 static int dwarf2_frame_adjust_regnum (struct gdbarch *gdbarch, int regnum,
 				       int eh_frame_p);
 
@@ -929,67 +939,253 @@ dwarf2_frame_find_quirks (struct dwarf2_frame_state *fs,
 }
 
 
-/* See dwarf2-frame.h.  */
+/* The unwind rules in effect at a PC, as computed by running the CIE
+   and FDE programs up to it.  Computing them means decoding the CFI
+   and looking up the producer of the code, so they are cached in the
+   FDE table of the objfile, where they survive the frame cache being
+   flushed at every stop.  They only depend on the objfile's contents,
+   so they are thrown away along with the FDE table.  */
 
-int
-dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
-		       struct dwarf2_per_cu_data *data,
-		       int *regnum_out, LONGEST *offset_out,
-		       CORE_ADDR *text_offset_out,
-		       const gdb_byte **cfa_start_out,
-		       const gdb_byte **cfa_end_out)
+struct dwarf2_frame_row
 {
+  /* The architecture the rules were computed for.  */
+  struct gdbarch *gdbarch;
+
+  /* The FDE covering PC.  */
   struct dwarf2_fde *fde;
-  CORE_ADDR text_offset;
-  struct dwarf2_frame_state fs;
 
-  memset (&fs, 0, sizeof (struct dwarf2_frame_state));
+  /* The PC, relative to the text offset of the FDE's objfile.  */
+  CORE_ADDR pc;
 
-  fs.pc = pc;
+  /* If ENTRY_PC_P, the entry PC of the function containing PC,
+     relative to the text offset of the FDE's objfile.  */
+  int entry_pc_p;
+  CORE_ADDR entry_pc;
 
-  /* Find the correct FDE.  */
-  fde = dwarf2_frame_find_fde (&fs.pc, &text_offset);
-  if (fde == NULL)
-    error (_("Could not compute CFA; needed to translate this expression"));
+  /* The register and CFA rules at PC.  REGS.REG is xmalloc'd, and
+     REGS.PREV is always NULL.  */
+  struct dwarf2_frame_state_reg_info regs;
+
+  /* The information we care about from the CIE.  */
+  ULONGEST retaddr_column;
+
+  /* See the field of the same name of struct dwarf2_frame_state.  */
+  int armcc_cfa_offsets_reversed;
+
+  /* If ENTRY_CFA_SP_OFFSET_P, the offset of the CFA from the stack
+     pointer at ENTRY_PC.  */
+  LONGEST entry_cfa_sp_offset;
+  int entry_cfa_sp_offset_p;
+};
+
+/* The largest number of rows cached for an objfile.  The cache is
+   emptied when it grows past this.  */
+
+#define DWARF2_FRAME_MAX_ROWS 4096
+
+/* Hash function for a struct dwarf2_frame_row.  */
+
+static hashval_t
+hash_dwarf2_frame_row (const void *item)
+{
+  const struct dwarf2_frame_row *row = (const struct dwarf2_frame_row *) item;
+  hashval_t hash;
+
+  hash = htab_hash_pointer (row->fde);
+  hash = hash * 67 + (hashval_t) row->pc;
+  if (row->entry_pc_p)
+    hash = hash * 67 + (hashval_t) row->entry_pc + 1;
+  return hash;
+}
+
+/* Equality function for a struct dwarf2_frame_row.  */
+
+static int
+eq_dwarf2_frame_row (const void *item_lhs, const void *item_rhs)
+{
+  const struct dwarf2_frame_row *lhs
+    = (const struct dwarf2_frame_row *) item_lhs;
+  const struct dwarf2_frame_row *rhs
+    = (const struct dwarf2_frame_row *) item_rhs;
+
+  return (lhs->gdbarch == rhs->gdbarch
+	  && lhs->fde == rhs->fde
+	  && lhs->pc == rhs->pc
+	  && lhs->entry_pc_p == rhs->entry_pc_p
+	  && (!lhs->entry_pc_p || lhs->entry_pc == rhs->entry_pc));
+}
+
+/* Deletion function for a struct dwarf2_frame_row.  */
+
+static void
+free_dwarf2_frame_row (void *item)
+{
+  struct dwarf2_frame_row *row = (struct dwarf2_frame_row *) item;
+
+  xfree (row->regs.reg);
+  xfree (row);
+}
+
+/* Compute the unwind rules of FDE, whose objfile has text offset
+   TEXT_OFFSET, at PC.  If ENTRY_PC_P, also compute how the CFA relates
+   to the stack pointer at ENTRY_PC.  PC and ENTRY_PC are absolute
+   addresses.  */
+
+static struct dwarf2_frame_row *
+dwarf2_frame_compute_row (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+			  CORE_ADDR text_offset, CORE_ADDR pc,
+			  int entry_pc_p, CORE_ADDR entry_pc)
+{
+  struct dwarf2_frame_row *row;
+  struct dwarf2_frame_state *fs;
+  struct cleanup *old_chain;
+  const gdb_byte *instr;
+
+  row = XCNEW (struct dwarf2_frame_row);
+  row->gdbarch = gdbarch;
+  row->fde = fde;
+  row->pc = pc - text_offset;
+  row->entry_pc_p = entry_pc_p;
+  if (entry_pc_p)
+    row->entry_pc = entry_pc - text_offset;
+  old_chain = make_cleanup (free_dwarf2_frame_row, row);
+
+  /* Allocate and initialize the frame state.  */
+  fs = XCNEW (struct dwarf2_frame_state);
+  make_cleanup (dwarf2_frame_state_free, fs);
+  fs->pc = fde->initial_location + text_offset;
 
   /* Extract any interesting information from the CIE.  */
-  fs.data_align = fde->cie->data_alignment_factor;
-  fs.code_align = fde->cie->code_alignment_factor;
-  fs.retaddr_column = fde->cie->return_address_register;
+  fs->data_align = fde->cie->data_alignment_factor;
+  fs->code_align = fde->cie->code_alignment_factor;
+  fs->retaddr_column = fde->cie->return_address_register;
 
   /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (&fs, fde);
+  dwarf2_frame_find_quirks (fs, fde);
 
   /* First decode all the insns in the CIE.  */
   execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch, pc, &fs);
+		       fde->cie->end, gdbarch, pc, fs);
 
   /* Save the initialized register set.  */
-  fs.initial = fs.regs;
-  fs.initial.reg = dwarf2_frame_state_copy_regs (&fs.regs);
+  fs->initial = fs->regs;
+  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+
+  if (entry_pc_p)
+    {
+      /* Decode the insns in the FDE up to the entry PC.  */
+      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
+				   entry_pc, fs);
+
+      if (fs->regs.cfa_how == CFA_REG_OFFSET
+	  && (dwarf_reg_to_regnum (gdbarch, fs->regs.cfa_reg)
+	      == gdbarch_sp_regnum (gdbarch)))
+	{
+	  row->entry_cfa_sp_offset = fs->regs.cfa_offset;
+	  row->entry_cfa_sp_offset_p = 1;
+	}
+    }
+  else
+    instr = fde->instructions;
 
   /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, fde->instructions, fde->end, gdbarch, pc, &fs);
+  execute_cfa_program (fde, instr, fde->end, gdbarch, pc, fs);
+
+  row->regs = fs->regs;
+  row->regs.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+  row->regs.prev = NULL;
+  row->retaddr_column = fs->retaddr_column;
+  row->armcc_cfa_offsets_reversed = fs->armcc_cfa_offsets_reversed;
+
+  do_cleanups (old_chain);
+  return row;
+}
+
+/* Return the unwind rules of FDE, whose objfile has text offset
+   TEXT_OFFSET, at PC, computing them if they are not cached yet.  If
+   ENTRY_PC_P, the result also tells how the CFA relates to the stack
+   pointer at ENTRY_PC.  The result belongs to the cache; it stays
+   valid until the next call.  */
+
+static const struct dwarf2_frame_row *
+dwarf2_frame_find_row (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+		       CORE_ADDR text_offset, CORE_ADDR pc,
+		       int entry_pc_p, CORE_ADDR entry_pc)
+{
+  struct dwarf2_fde_table *fde_table
+    = dwarf2_frame_fde_table (fde->cie->unit->objfile);
+  struct dwarf2_frame_row key, *row;
+  void **slot;
+
+  if (fde_table->rows == NULL)
+    fde_table->rows = htab_create_alloc (16, hash_dwarf2_frame_row,
+					 eq_dwarf2_frame_row,
+					 free_dwarf2_frame_row,
+					 xcalloc, xfree);
+
+  key.gdbarch = gdbarch;
+  key.fde = fde;
+  key.pc = pc - text_offset;
+  key.entry_pc_p = entry_pc_p;
+  key.entry_pc = entry_pc_p ? entry_pc - text_offset : 0;
+
+  row = (struct dwarf2_frame_row *) htab_find (fde_table->rows, &key);
+  if (row != NULL)
+    return row;
+
+  row = dwarf2_frame_compute_row (gdbarch, fde, text_offset, pc,
+				  entry_pc_p, entry_pc);
+
+  if (htab_elements (fde_table->rows) >= DWARF2_FRAME_MAX_ROWS)
+    htab_empty (fde_table->rows);
+  slot = htab_find_slot (fde_table->rows, row, INSERT);
+  gdb_assert (*slot == NULL);
+  *slot = row;
+
+  return row;
+}
+
+/* See dwarf2-frame.h.  */
+
+int
+dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
+		       struct dwarf2_per_cu_data *data,
+		       int *regnum_out, LONGEST *offset_out,
+		       CORE_ADDR *text_offset_out,
+		       const gdb_byte **cfa_start_out,
+		       const gdb_byte **cfa_end_out)
+{
+  struct dwarf2_fde *fde;
+  CORE_ADDR text_offset;
+  CORE_ADDR fde_pc = pc;
+  const struct dwarf2_frame_row *row;
+
+  /* Find the correct FDE.  */
+  fde = dwarf2_frame_find_fde (&fde_pc, &text_offset);
+  if (fde == NULL)
+    error (_("Could not compute CFA; needed to translate this expression"));
+
+  row = dwarf2_frame_find_row (gdbarch, fde, text_offset, pc, 0, 0);
 
   /* Calculate the CFA.  */
-  switch (fs.regs.cfa_how)
+  switch (row->regs.cfa_how)
     {
     case CFA_REG_OFFSET:
       {
-	int regnum = dwarf_reg_to_regnum_or_error (gdbarch, fs.regs.cfa_reg);
+	int regnum = dwarf_reg_to_regnum_or_error (gdbarch, row->regs.cfa_reg);
 
 	*regnum_out = regnum;
-	if (fs.armcc_cfa_offsets_reversed)
-	  *offset_out = -fs.regs.cfa_offset;
+	if (row->armcc_cfa_offsets_reversed)
+	  *offset_out = -row->regs.cfa_offset;
 	else
-	  *offset_out = fs.regs.cfa_offset;
+	  *offset_out = row->regs.cfa_offset;
 	return 1;
       }
 
     case CFA_EXP:
       *text_offset_out = text_offset;
-      *cfa_start_out = fs.regs.cfa_exp;
-      *cfa_end_out = fs.regs.cfa_exp + fs.regs.cfa_exp_len;
+      *cfa_start_out = row->regs.cfa_exp;
+      *cfa_end_out = row->regs.cfa_exp + row->regs.cfa_exp_len;
       return 0;
 
     default:
@@ -997,7 +1193,7 @@ dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
     }
 }
 
-
+
 struct dwarf2_frame_cache
 {
   /* DWARF Call Frame Address.  */
@@ -1054,15 +1250,16 @@ clear_pointer_cleanup (void *arg)
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 {
-  struct cleanup *reset_cache_cleanup, *old_chain;
+  struct cleanup *reset_cache_cleanup;
   struct gdbarch *gdbarch = get_frame_arch (this_frame);
   const int num_regs = gdbarch_num_regs (gdbarch)
 		       + gdbarch_num_pseudo_regs (gdbarch);
   struct dwarf2_frame_cache *cache;
-  struct dwarf2_frame_state *fs;
+  const struct dwarf2_frame_row *row;
+  struct dwarf2_frame_row rules;
   struct dwarf2_fde *fde;
-  CORE_ADDR entry_pc;
-  const gdb_byte *instr;
+  CORE_ADDR pc, fde_pc, entry_pc;
+  int entry_pc_p;
 
   if (*this_cache)
     return (struct dwarf2_frame_cache *) *this_cache;
@@ -1073,10 +1270,6 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   *this_cache = cache;
   reset_cache_cleanup = make_cleanup (clear_pointer_cleanup, this_cache);
 
-  /* Allocate and initialize the frame state.  */
-  fs = XCNEW (struct dwarf2_frame_state);
-  old_chain = make_cleanup (dwarf2_frame_state_free, fs);
-
   /* Unwind the PC.
 
      Note that if the next frame is never supposed to return (i.e. a call
@@ -1092,67 +1285,44 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
      get_frame_address_in_block does just this.  It's not clear how
      reliable the method is though; there is the potential for the
      register state pre-call being different to that on return.  */
-  fs->pc = get_frame_address_in_block (this_frame);
+  pc = get_frame_address_in_block (this_frame);
 
   /* Find the correct FDE.  */
-  fde = dwarf2_frame_find_fde (&fs->pc, &cache->text_offset);
+  fde_pc = pc;
+  fde = dwarf2_frame_find_fde (&fde_pc, &cache->text_offset);
   gdb_assert (fde != NULL);
-
-  /* Extract any interesting information from the CIE.  */
-  fs->data_align = fde->cie->data_alignment_factor;
-  fs->code_align = fde->cie->code_alignment_factor;
-  fs->retaddr_column = fde->cie->return_address_register;
   cache->addr_size = fde->cie->addr_size;
 
-  /* Check for "quirks" - known bugs in producers.  */
-  dwarf2_frame_find_quirks (fs, fde);
-
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), fs);
-
-  /* Save the initialized register set.  */
-  fs->initial = fs->regs;
-  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+  /* Find the rules at PC.  Copy them, as computing the CFA below may
+     unwind other frames and replace the cached row.  */
+  entry_pc_p = get_frame_func_if_available (this_frame, &entry_pc);
+  row = dwarf2_frame_find_row (gdbarch, fde, cache->text_offset, pc,
+			       entry_pc_p, entry_pc_p ? entry_pc : 0);
+  rules = *row;
+  rules.regs.reg = FRAME_OBSTACK_CALLOC (row->regs.num_regs,
+					 struct dwarf2_frame_state_reg);
+  memcpy (rules.regs.reg, row->regs.reg,
+	  row->regs.num_regs * sizeof (struct dwarf2_frame_state_reg));
 
-  if (get_frame_func_if_available (this_frame, &entry_pc))
-    {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program (fde, fde->instructions, fde->end, gdbarch,
-				   entry_pc, fs);
-
-      if (fs->regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs->regs.cfa_reg)
-	      == gdbarch_sp_regnum (gdbarch)))
-	{
-	  cache->entry_cfa_sp_offset = fs->regs.cfa_offset;
-	  cache->entry_cfa_sp_offset_p = 1;
-	}
-    }
-  else
-    instr = fde->instructions;
-
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), fs);
+  cache->entry_cfa_sp_offset = rules.entry_cfa_sp_offset;
+  cache->entry_cfa_sp_offset_p = rules.entry_cfa_sp_offset_p;
 
   TRY
     {
       /* Calculate the CFA.  */
-      switch (fs->regs.cfa_how)
+      switch (rules.regs.cfa_how)
 	{
 	case CFA_REG_OFFSET:
-	  cache->cfa = read_addr_from_reg (this_frame, fs->regs.cfa_reg);
-	  if (fs->armcc_cfa_offsets_reversed)
-	    cache->cfa -= fs->regs.cfa_offset;
+	  cache->cfa = read_addr_from_reg (this_frame, rules.regs.cfa_reg);
+	  if (rules.armcc_cfa_offsets_reversed)
+	    cache->cfa -= rules.regs.cfa_offset;
 	  else
-	    cache->cfa += fs->regs.cfa_offset;
+	    cache->cfa += rules.regs.cfa_offset;
 	  break;
 
 	case CFA_EXP:
 	  cache->cfa =
-	    execute_stack_op (fs->regs.cfa_exp, fs->regs.cfa_exp_len,
+	    execute_stack_op (rules.regs.cfa_exp, rules.regs.cfa_exp_len,
 			      cache->addr_size, cache->text_offset,
 			      this_frame, 0, 0);
 	  break;
@@ -1166,7 +1336,6 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
       if (ex.error == NOT_AVAILABLE_ERROR)
 	{
 	  cache->unavailable_retaddr = 1;
-	  do_cleanups (old_chain);
 	  discard_cleanups (reset_cache_cleanup);
 	  return cache;
 	}
@@ -1190,7 +1359,7 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   {
     int column;		/* CFI speak for "register number".  */
 
-    for (column = 0; column < fs->regs.num_regs; column++)
+    for (column = 0; column < rules.regs.num_regs; column++)
       {
 	/* Use the GDB register number as the destination index.  */
 	int regnum = dwarf_reg_to_regnum (gdbarch, column);
@@ -1210,16 +1379,16 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 	   problems when a debug info register falls outside of the
 	   table.  We need a way of iterating through all the valid
 	   DWARF2 register numbers.  */
-	if (fs->regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
+	if (rules.regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	  {
 	    if (cache->reg[regnum].how == DWARF2_FRAME_REG_UNSPECIFIED)
 	      complaint (&symfile_complaints, _("\
 incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 			 gdbarch_register_name (gdbarch, regnum),
-			 paddress (gdbarch, fs->pc));
+			 paddress (gdbarch, pc));
 	  }
 	else
-	  cache->reg[regnum] = fs->regs.reg[column];
+	  cache->reg[regnum] = rules.regs.reg[column];
       }
   }
 
@@ -1234,7 +1403,7 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	    || cache->reg[regnum].how == DWARF2_FRAME_REG_RA_OFFSET)
 	  {
 	    struct dwarf2_frame_state_reg *retaddr_reg =
-	      &fs->regs.reg[fs->retaddr_column];
+	      &rules.regs.reg[rules.retaddr_column];
 
 	    /* It seems rather bizarre to specify an "empty" column as
                the return adress column.  However, this is exactly
@@ -1243,7 +1412,7 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
                register corresponding to the return address column.
                Incidentally, that's how we should treat a return
                address column specifying "same value" too.  */
-	    if (fs->retaddr_column < fs->regs.num_regs
+	    if (rules.retaddr_column < rules.regs.num_regs
 		&& retaddr_reg->how != DWARF2_FRAME_REG_UNSPECIFIED
 		&& retaddr_reg->how != DWARF2_FRAME_REG_SAME_VALUE)
 	      {
@@ -1256,12 +1425,12 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
 	      {
 		if (cache->reg[regnum].how == DWARF2_FRAME_REG_RA)
 		  {
-		    cache->reg[regnum].loc.reg = fs->retaddr_column;
+		    cache->reg[regnum].loc.reg = rules.retaddr_column;
 		    cache->reg[regnum].how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 		else
 		  {
-		    cache->retaddr_reg.loc.reg = fs->retaddr_column;
+		    cache->retaddr_reg.loc.reg = rules.retaddr_column;
 		    cache->retaddr_reg.how = DWARF2_FRAME_REG_SAVED_REG;
 		  }
 	      }
@@ -1269,11 +1438,10 @@ incomplete CFI data; unspecified registers (e.g., %s) at %s"),
       }
   }
 
-  if (fs->retaddr_column < fs->regs.num_regs
-      && fs->regs.reg[fs->retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
+  if (rules.retaddr_column < rules.regs.num_regs
+      && rules.regs.reg[rules.retaddr_column].how == DWARF2_FRAME_REG_UNDEFINED)
     cache->undefined_retaddr = 1;
 
-  do_cleanups (old_chain);
   discard_cleanups (reset_cache_cleanup);
   return cache;
 }
@@ -1559,6 +1727,18 @@ dwarf2_frame_cfa (struct frame_info *this_frame)
 
 const struct objfile_data *dwarf2_frame_objfile_data;
 
+/* Free the data attached to an objfile's FDE table.  The table itself
+   lives on the objfile obstack.  */
+
+static void
+dwarf2_frame_objfile_data_cleanup (struct objfile *objfile, void *arg)
+{
+  struct dwarf2_fde_table *fde_table = (struct dwarf2_fde_table *) arg;
+
+  if (fde_table->rows != NULL)
+    htab_delete (fde_table->rows);
+}
+
 static unsigned int
 read_1_byte (bfd *abfd, const gdb_byte *buf)
 {
@@ -1789,54 +1969,197 @@ bsearch_fde_cmp (const void *key, const void *element)
   return 1;
 }
 
-/* Find the FDE for *PC.  Return a pointer to the FDE, and store the
-   inital location associated with it into *PC.  */
+/* Return the FDE table of OBJFILE, reading the call frame information
+   of OBJFILE if this was not done yet.  */
 
-static struct dwarf2_fde *
-dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+static struct dwarf2_fde_table *
+dwarf2_frame_fde_table (struct objfile *objfile)
 {
-  struct objfile *objfile;
+  struct dwarf2_fde_table *fde_table;
 
-  ALL_OBJFILES (objfile)
+  fde_table = ((struct dwarf2_fde_table *)
+	       objfile_data (objfile, dwarf2_frame_objfile_data));
+  if (fde_table == NULL)
     {
-      struct dwarf2_fde_table *fde_table;
-      struct dwarf2_fde **p_fde;
-      CORE_ADDR offset;
-      CORE_ADDR seek_pc;
-
+      dwarf2_build_frame_info (objfile);
       fde_table = ((struct dwarf2_fde_table *)
 		   objfile_data (objfile, dwarf2_frame_objfile_data));
-      if (fde_table == NULL)
-	{
-	  dwarf2_build_frame_info (objfile);
-	  fde_table = ((struct dwarf2_fde_table *)
-		       objfile_data (objfile, dwarf2_frame_objfile_data));
-	}
-      gdb_assert (fde_table != NULL);
+    }
+  gdb_assert (fde_table != NULL);
+
+  return fde_table;
+}
+
+/* The range of addresses covered by the FDEs of an objfile.  */
+
+struct dwarf2_fde_range
+{
+  /* The first address covered, and the address following the last
+     one.  */
+  CORE_ADDR low;
+  CORE_ADDR high;
+
+  /* The largest HIGH of this range and of all the ranges before it in
+     the index.  */
+  CORE_ADDR max_high;
+
+  /* The FDE table of the objfile, and its text offset.  */
+  struct dwarf2_fde_table *fde_table;
+  CORE_ADDR offset;
+
+  /* The position of the objfile in the list of objfiles.  When the
+     ranges of several objfiles cover a PC, the first objfile with an FDE
+     for the PC wins, as when searching the objfiles in order.  */
+  int order;
+};
 
+/* An index of the FDE tables of all the objfiles of a program space,
+   sorted by address, so that finding the FDE of a PC does not have to
+   search every objfile.  */
+
+struct dwarf2_fde_index
+{
+  /* True if RANGES was built, and the value of the program space's
+     objfiles generation at the time.  */
+  bool valid;
+  unsigned generation;
+
+  /* The ranges, sorted by LOW.  */
+  std::vector<dwarf2_fde_range> ranges;
+};
+
+static const struct program_space_data *dwarf2_frame_pspace_data;
+
+/* Free the FDE index of a program space.  */
+
+static void
+dwarf2_frame_pspace_data_cleanup (struct program_space *pspace, void *arg)
+{
+  delete (struct dwarf2_fde_index *) arg;
+}
+
+/* Return the FDE index of PSPACE, (re)building it if the objfiles of
+   PSPACE changed since it was last built.  */
+
+static struct dwarf2_fde_index *
+dwarf2_frame_fde_index (struct program_space *pspace)
+{
+  struct dwarf2_fde_index *index;
+  struct objfile *objfile;
+  int order = 0;
+
+  index = ((struct dwarf2_fde_index *)
+	   program_space_data (pspace, dwarf2_frame_pspace_data));
+  if (index == NULL)
+    {
+      index = new dwarf2_fde_index ();
+      set_program_space_data (pspace, dwarf2_frame_pspace_data, index);
+    }
+
+  if (index->valid && index->generation == pspace->objfiles_generation)
+    return index;
+
+  index->valid = false;
+  index->ranges.clear ();
+
+  ALL_PSPACE_OBJFILES (pspace, objfile)
+    {
+      struct dwarf2_fde_table *fde_table = dwarf2_frame_fde_table (objfile);
+      struct dwarf2_fde_range range;
+      int i;
+
+      ++order;
       if (fde_table->num_entries == 0)
 	continue;
 
       gdb_assert (objfile->section_offsets);
-      offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+      range.offset = ANOFFSET (objfile->section_offsets,
+			       SECT_OFF_TEXT (objfile));
+      range.low = range.offset + fde_table->entries[0]->initial_location;
+      range.high = range.low;
+      for (i = 0; i < fde_table->num_entries; i++)
+	{
+	  struct dwarf2_fde *fde = fde_table->entries[i];
+
+	  range.high = std::max (range.high,
+				 (range.offset + fde->initial_location
+				  + fde->address_range));
+	}
+      range.fde_table = fde_table;
+      range.order = order;
+      index->ranges.push_back (range);
+    }
 
-      gdb_assert (fde_table->num_entries > 0);
-      if (*pc < offset + fde_table->entries[0]->initial_location)
-        continue;
+  std::sort (index->ranges.begin (), index->ranges.end (),
+	     [] (const dwarf2_fde_range &a, const dwarf2_fde_range &b)
+	     {
+	       if (a.low != b.low)
+		 return a.low < b.low;
+	       return a.order < b.order;
+	     });
 
-      seek_pc = *pc - offset;
+  CORE_ADDR max_high = 0;
+  for (dwarf2_fde_range &range : index->ranges)
+    {
+      max_high = std::max (max_high, range.high);
+      range.max_high = max_high;
+    }
+
+  index->valid = true;
+  index->generation = pspace->objfiles_generation;
+  return index;
+}
+
+/* Find the FDE for *PC.  Return a pointer to the FDE, and store the
+   inital location associated with it into *PC.  */
+
+static struct dwarf2_fde *
+dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+{
+  struct dwarf2_fde_index *index
+    = dwarf2_frame_fde_index (current_program_space);
+  const struct dwarf2_fde_range *found = NULL;
+  struct dwarf2_fde *found_fde = NULL;
+
+  /* Walk back from the last range starting at or before *PC, until no
+     earlier range can reach *PC.  */
+  auto it = std::upper_bound (index->ranges.begin (), index->ranges.end (),
+			      *pc,
+			      [] (CORE_ADDR pc, const dwarf2_fde_range &range)
+			      {
+				return pc < range.low;
+			      });
+  while (it != index->ranges.begin ())
+    {
+      const struct dwarf2_fde_range &range = *--it;
+      struct dwarf2_fde_table *fde_table = range.fde_table;
+      struct dwarf2_fde **p_fde;
+      CORE_ADDR seek_pc;
+
+      if (range.max_high <= *pc)
+	break;
+      if (range.high <= *pc
+	  || (found != NULL && found->order < range.order))
+	continue;
+
+      seek_pc = *pc - range.offset;
       p_fde = ((struct dwarf2_fde **)
 	       bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
                         sizeof (fde_table->entries[0]), bsearch_fde_cmp));
       if (p_fde != NULL)
-        {
-          *pc = (*p_fde)->initial_location + offset;
-	  if (out_offset)
-	    *out_offset = offset;
-          return *p_fde;
-        }
+	{
+	  found = &range;
+	  found_fde = *p_fde;
+	}
     }
-  return NULL;
+
+  if (found_fde != NULL)
+    {
+      *pc = found_fde->initial_location + found->offset;
+      if (out_offset)
+	*out_offset = found->offset;
+    }
+  return found_fde;
 }
 
 /* Add a pointer to new FDE to the FDE_TABLE, allocating space for it.  */
@@ -2436,6 +2759,7 @@ dwarf2_build_frame_info (struct objfile *objfile)
 
   /* Copy fde_table to obstack: it is needed at runtime.  */
   fde_table2 = XOBNEW (&objfile->objfile_obstack, struct dwarf2_fde_table);
+  fde_table2->rows = NULL;
 
   if (fde_table.num_entries == 0)
     {
@@ -2515,5 +2839,10 @@ void
 _initialize_dwarf2_frame (void)
 {
   dwarf2_frame_data = gdbarch_data_register_pre_init (dwarf2_frame_init);
-  dwarf2_frame_objfile_data = register_objfile_data ();
+  dwarf2_frame_objfile_data
+    = register_objfile_data_with_cleanup (NULL,
+					  dwarf2_frame_objfile_data_cleanup);
+  dwarf2_frame_pspace_data
+    = register_program_space_data_with_cleanup
+	(NULL, dwarf2_frame_pspace_data_cleanup);
 }
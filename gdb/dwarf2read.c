@@ -68,15 +68,31 @@
 #include "source.h"
 #include "filestuff.h"
 #include "build-id.h"
+#include "dwarf-index-cache.h"
 #include "namespace.h"
 #include "common/gdb_unlinker.h"
 #include "common/function-view.h"
 #include "common/gdb_optional.h"
 #include "common/underlying.h"
+#include "event-loop.h"
+#include "observer.h"
+#include "gdbthread.h"
+#include "minsyms.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
 #include <algorithm>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#ifdef CXX_STD_THREAD
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+#include <signal.h>
+#endif
 
 typedef struct symbol *symbolp;
 DEF_VEC_P (symbolp);
@@ -204,6 +220,73 @@ struct mapped_index
   const char *constant_pool;
 };
 
+/* An abbreviation of the .debug_names entry pool.  */
+struct debug_names_abbrev
+{
+  /* One attribute of the abbreviation.  */
+  struct attr
+  {
+    /* The DW_IDX_* index attribute.  */
+    ULONGEST dw_idx;
+
+    /* The DW_FORM_* form of its value.  */
+    ULONGEST form;
+
+    /* The value, for DW_FORM_implicit_const.  */
+    LONGEST implicit_const;
+  };
+
+  /* The DW_TAG_* tag of the entries using this abbreviation.  */
+  ULONGEST dwarf_tag;
+
+  /* The attributes of those entries.  */
+  std::vector<attr> attrs;
+};
+
+/* A description of a mapped DWARF 5 .debug_names section.  The format
+   is described in the DWARF 5 standard, section 6.1.1.  Unlike
+   .gdb_index, it uses the byte order of the objfile.  */
+struct mapped_debug_names
+{
+  /* The BFD whose byte order the section uses.  */
+  bfd *abfd;
+
+  /* 4 for 32-bit DWARF, 8 for 64-bit DWARF.  */
+  unsigned int offset_size;
+
+  /* The counts from the header.  */
+  ULONGEST cu_count;
+  ULONGEST tu_count;
+  ULONGEST bucket_count;
+  ULONGEST name_count;
+
+  /* The CU list, each CU being an OFFSET_SIZE offset into .debug_info.  */
+  const gdb_byte *cu_table;
+
+  /* The local TU list, in the same format as CU_TABLE.  */
+  const gdb_byte *tu_table;
+
+  /* The hash lookup table: BUCKET_COUNT 4-byte 1-based indices into
+     the name table, and NAME_COUNT 4-byte hashes.  */
+  const gdb_byte *bucket_table;
+  const gdb_byte *hash_table;
+
+  /* The name table: NAME_COUNT OFFSET_SIZE offsets into .debug_str,
+     then NAME_COUNT OFFSET_SIZE offsets into the entry pool.  */
+  const gdb_byte *string_offsets;
+  const gdb_byte *entry_offsets;
+
+  /* The entry pool, and the end of this index in the section.  */
+  const gdb_byte *entry_pool;
+  const gdb_byte *end;
+
+  /* The abbreviations, by code.  */
+  std::unordered_map<ULONGEST, debug_names_abbrev> abbrevs;
+
+  /* The units of the local TU list, in the order of the list.  */
+  std::vector<struct dwarf2_per_cu_data *> type_units;
+};
+
 typedef struct dwarf2_per_cu_data *dwarf2_per_cu_ptr;
 DEF_VEC_P (dwarf2_per_cu_ptr);
 
@@ -219,6 +302,10 @@ struct tu_stats
 /* Collection of data recorded per objfile.
    This hangs off of dwarf2_objfile_data_key.  */
 
+#ifdef CXX_STD_THREAD
+template<typename T> class dwarf2_unit_pool;
+#endif
+
 struct dwarf2_per_objfile
 {
   struct dwarf2_section_info info;
@@ -236,6 +323,8 @@ struct dwarf2_per_objfile
   struct dwarf2_section_info frame;
   struct dwarf2_section_info eh_frame;
   struct dwarf2_section_info gdb_index;
+  struct dwarf2_section_info debug_names;
+  struct dwarf2_section_info debug_aranges;
 
   VEC (dwarf2_section_info_def) *types;
 
@@ -301,6 +390,14 @@ struct dwarf2_per_objfile
   /* The mapped index, or NULL if .gdb_index is missing or not being used.  */
   struct mapped_index *index_table;
 
+  /* The mapped .debug_names index, or NULL if it is missing or not
+     being used.  */
+  struct mapped_debug_names *debug_names_table;
+
+  /* If the index was read from the index cache, the open cache file
+     that INDEX_TABLE points into; otherwise NULL.  */
+  class index_cache_resource *index_cache_res;
+
   /* When using index_table, this keeps track of all quick_file_names entries.
      TUs typically share line table entries with a CU, so we maintain a
      separate table of all line table entries to support the sharing.
@@ -314,6 +411,18 @@ struct dwarf2_per_objfile
      symbols.  */
   int reading_partial_symbols;
 
+#ifdef CXX_STD_THREAD
+  /* While a batch of CUs is being expanded, the worker threads that
+     read their full DIEs ahead of the main thread; see
+     dwarf2_preload_scope.  */
+  dwarf2_unit_pool<struct dwarf2_cu> *preload_pool;
+#endif
+
+  /* The progress of background expansion: whether the CU of "main"
+     has been expanded, and the index of the next CU to look at.  */
+  int background_main_done;
+  int background_next;
+
   /* Table mapping type DIEs to their struct type *.
      This is NULL if not allocated yet.
      The mapping is done via (CU/TU + DIE offset) -> type.  */
@@ -326,7 +435,31 @@ struct dwarf2_per_objfile
   htab_t line_header_hash;
 };
 
-static struct dwarf2_per_objfile *dwarf2_per_objfile;
+/* The data of the objfile being read.  This is per-thread, so that
+   the worker threads reading units for one objfile are not affected
+   when the main thread moves on to another.  */
+static thread_local struct dwarf2_per_objfile *dwarf2_per_objfile;
+
+/* While an object of this type is live, worker threads read the full
+   DIEs of a batch of compilation units that the main thread is about
+   to expand, and load_full_comp_unit takes their results rather than
+   reading the units itself.  This does nothing if threads are
+   unavailable or disabled, or if a batch is already being read for
+   dwarf2_per_objfile.  */
+
+class dwarf2_preload_scope
+{
+public:
+
+  explicit dwarf2_preload_scope
+    (const std::vector<struct dwarf2_per_cu_data *> &units);
+  ~dwarf2_preload_scope ();
+
+private:
+
+  /* The objfile data whose preload_pool we set, or NULL.  */
+  struct dwarf2_per_objfile *m_per_objfile;
+};
 
 /* Default names of the debugging sections.  */
 
@@ -351,6 +484,8 @@ static const struct dwarf2_debug_sections dwarf2_elf_names =
   { ".debug_frame", ".zdebug_frame" },
   { ".eh_frame", NULL },
   { ".gdb_index", ".zgdb_index" },
+  { ".debug_names", ".zdebug_names" },
+  { ".debug_aranges", ".zdebug_aranges" },
   23
 };
 
@@ -576,6 +711,10 @@ struct dwarf2_cu
      this information, but later versions do.  */
 
   unsigned int processing_has_namespace_info : 1;
+
+  /* Non-NULL while this CU is being read by a worker thread; see
+     dwarf2_prescan_comp_unit.  */
+  struct dwarf2_prescan *prescan;
 };
 
 /* Persistent data held for a compilation unit, even when not
@@ -1232,6 +1371,11 @@ struct partial_die_info
     /* Flag set if spec_offset uses DW_FORM_GNU_ref_alt.  */
     unsigned int spec_is_dwz : 1;
 
+    /* Flag set if NAME has not been passed through
+       dwarf2_canonicalize_name yet.  This only happens for DIEs read
+       by a worker thread.  */
+    unsigned int raw_name : 1;
+
     /* The name of this DIE.  Normally the value of DW_AT_name, but
        sometimes a default name for unnamed DIEs.  */
     const char *name;
@@ -1496,6 +1640,45 @@ show_dwarf_max_cache_age (struct ui_file *file, int from_tty,
 		    value);
 }
 
+/* The number of worker threads used to read partial DIEs while
+   building partial symbol tables.  -1 means one per CPU; 0 means to
+   read everything on the main thread.  */
+static int dwarf_psymtab_threads = -1;
+static void
+show_dwarf_psymtab_threads (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of threads used to read "
+			    "DWARF partial symbols is %s.\n"),
+		    value);
+}
+
+/* The number of worker threads used to read full DIEs when expanding
+   a batch of compilation units.  -1 means one per CPU; 0 means to read
+   everything on the main thread.  */
+static int dwarf_expansion_threads = -1;
+static void
+show_dwarf_expansion_threads (struct ui_file *file, int from_tty,
+			      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of threads used to read "
+			    "DWARF full symbols is %s.\n"),
+		    value);
+}
+
+/* Nonzero if compilation units should be expanded while GDB is idle;
+   see dwarf2_background_expand.  */
+static int dwarf_background_expansion = 0;
+static void
+show_dwarf_background_expansion (struct ui_file *file, int from_tty,
+				 struct cmd_list_element *c,
+				 const char *value)
+{
+  fprintf_filtered (file, _("Background expansion of DWARF "
+			    "symbol tables is %s.\n"),
+		    value);
+}
+
 /* local function prototypes */
 
 static const char *get_section_name (const struct dwarf2_section_info *);
@@ -1937,6 +2120,11 @@ static struct type *set_die_type (struct die_info *, struct type *,
 
 static void create_all_comp_units (struct objfile *);
 
+static struct dwarf2_per_cu_data *create_per_cu_for_unit
+  (struct objfile *objfile, struct dwarf2_section_info *section,
+   struct dwarf2_section_info *abbrev_section, unsigned int is_dwz,
+   sect_offset sect_off);
+
 static int create_all_type_units (struct objfile *);
 
 static void load_full_comp_unit (struct dwarf2_per_cu_data *,
@@ -2420,6 +2608,16 @@ dwarf2_locate_sections (bfd *abfd, asection *sectp, void *vnames)
       dwarf2_per_objfile->gdb_index.s.section = sectp;
       dwarf2_per_objfile->gdb_index.size = bfd_get_section_size (sectp);
     }
+  else if (section_is_p (sectp->name, &names->debug_names))
+    {
+      dwarf2_per_objfile->debug_names.s.section = sectp;
+      dwarf2_per_objfile->debug_names.size = bfd_get_section_size (sectp);
+    }
+  else if (section_is_p (sectp->name, &names->debug_aranges))
+    {
+      dwarf2_per_objfile->debug_aranges.s.section = sectp;
+      dwarf2_per_objfile->debug_aranges.size = bfd_get_section_size (sectp);
+    }
 
   if ((bfd_get_section_flags (abfd, sectp) & (SEC_LOAD | SEC_ALLOC))
       && bfd_section_vma (abfd, sectp) == 0)
@@ -3137,6 +3335,28 @@ mapped_index_string_hash (int index_version, const void *p)
   return r;
 }
 
+/* Return the form of NAME to look up in an index.  NAME is already
+   canonical, but the indices do not record parameter lists, so drop
+   them for the languages that have them.  If a copy of NAME is
+   needed, *WITHOUT_PARAMS is set to own it.  */
+
+static const char *
+index_lookup_name (const char *name,
+		   gdb::unique_xmalloc_ptr<char> *without_params)
+{
+  if ((current_language->la_language == language_cplus
+       || current_language->la_language == language_fortran
+       || current_language->la_language == language_d)
+      && strchr (name, '(') != NULL)
+    {
+      without_params->reset (cp_remove_params (name));
+      if (*without_params != NULL)
+	return without_params->get ();
+    }
+
+  return name;
+}
+
 /* Find a slot in the mapped index INDEX for the object named NAME.
    If NAME is found, set *VEC_OUT to point to the CU vector in the
    constant pool and return 1.  If NAME cannot be found, return 0.  */
@@ -3145,29 +3365,12 @@ static int
 find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
 			  offset_type **vec_out)
 {
-  struct cleanup *back_to = make_cleanup (null_cleanup, 0);
+  gdb::unique_xmalloc_ptr<char> without_params;
   offset_type hash;
   offset_type slot, step;
   int (*cmp) (const char *, const char *);
 
-  if (current_language->la_language == language_cplus
-      || current_language->la_language == language_fortran
-      || current_language->la_language == language_d)
-    {
-      /* NAME is already canonical.  Drop any qualifiers as .gdb_index does
-	 not contain any.  */
-
-      if (strchr (name, '(') != NULL)
-	{
-	  char *without_params = cp_remove_params (name);
-
-	  if (without_params != NULL)
-	    {
-	      make_cleanup (xfree, without_params);
-	      name = without_params;
-	    }
-	}
-    }
+  name = index_lookup_name (name, &without_params);
 
   /* Index version 4 did not support case insensitive searches.  But the
      indices for case insensitive languages are built in lowercase, therefore
@@ -3187,17 +3390,13 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
       offset_type i = 2 * slot;
       const char *str;
       if (index->symbol_table[i] == 0 && index->symbol_table[i + 1] == 0)
-	{
-	  do_cleanups (back_to);
-	  return 0;
-	}
+	return 0;
 
       str = index->constant_pool + MAYBE_SWAP (index->symbol_table[i]);
       if (!cmp (name, str))
 	{
 	  *vec_out = (offset_type *) (index->constant_pool
 				      + MAYBE_SWAP (index->symbol_table[i + 1]));
-	  do_cleanups (back_to);
 	  return 1;
 	}
 
@@ -3205,44 +3404,36 @@ find_slot_in_mapped_hash (struct mapped_index *index, const char *name,
     }
 }
 
-/* A helper function that reads the .gdb_index from SECTION and fills
-   in MAP.  FILENAME is the name of the file containing the section;
-   it is used for error reporting.  DEPRECATED_OK is nonzero if it is
-   ok to use deprecated sections.
+/* A helper function that reads the index in the SIZE bytes at ADDR
+   and fills in MAP.  FILENAME is the name of the file containing the
+   index; it is used for error reporting.  DEPRECATED_OK is nonzero if
+   it is ok to use deprecated sections.
 
    CU_LIST, CU_LIST_ELEMENTS, TYPES_LIST, and TYPES_LIST_ELEMENTS are
    out parameters that are filled in with information about the CU and
-   TU lists in the section.
+   TU lists in the index.
 
    Returns 1 if all went well, 0 otherwise.  */
 
 static int
-read_index_from_section (struct objfile *objfile,
-			 const char *filename,
-			 int deprecated_ok,
-			 struct dwarf2_section_info *section,
-			 struct mapped_index *map,
-			 const gdb_byte **cu_list,
-			 offset_type *cu_list_elements,
-			 const gdb_byte **types_list,
-			 offset_type *types_list_elements)
+read_index_from_buffer (const char *filename,
+			int deprecated_ok,
+			const gdb_byte *addr,
+			offset_type size,
+			struct mapped_index *map,
+			const gdb_byte **cu_list,
+			offset_type *cu_list_elements,
+			const gdb_byte **types_list,
+			offset_type *types_list_elements)
 {
-  const gdb_byte *addr;
   offset_type version;
   offset_type *metadata;
   int i;
 
-  if (dwarf2_section_empty_p (section))
-    return 0;
-
-  /* Older elfutils strip versions could keep the section in the main
-     executable while splitting it for the separate debug info file.  */
-  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+  /* The header is the version followed by six offsets.  */
+  if (size < 7 * sizeof (offset_type))
     return 0;
 
-  dwarf2_read_section (objfile, section);
-
-  addr = section->buffer;
   /* Version check.  */
   version = MAYBE_SWAP (*(offset_type *) addr);
   /* Versions earlier than 3 emitted every copy of a psymbol.  This
@@ -3295,11 +3486,17 @@ to use the section anyway."),
   if (version > 8)
     return 0;
 
-  map->version = version;
-  map->total_size = section->size;
-
   metadata = (offset_type *) (addr + sizeof (offset_type));
 
+  /* Don't trust a truncated file.  */
+  for (i = 0; i < 6; ++i)
+    if (MAYBE_SWAP (metadata[i]) > size
+	|| (i > 0 && MAYBE_SWAP (metadata[i]) < MAYBE_SWAP (metadata[i - 1])))
+      return 0;
+
+  map->version = version;
+  map->total_size = size;
+
   i = 0;
   *cu_list = addr + MAYBE_SWAP (metadata[i]);
   *cu_list_elements = ((MAYBE_SWAP (metadata[i + 1]) - MAYBE_SWAP (metadata[i]))
@@ -3328,6 +3525,77 @@ to use the section anyway."),
   return 1;
 }
 
+/* A helper function that reads the .gdb_index from SECTION and fills
+   in MAP.  The arguments are as for read_index_from_buffer.  */
+
+static int
+read_index_from_section (struct objfile *objfile,
+			 const char *filename,
+			 int deprecated_ok,
+			 struct dwarf2_section_info *section,
+			 struct mapped_index *map,
+			 const gdb_byte **cu_list,
+			 offset_type *cu_list_elements,
+			 const gdb_byte **types_list,
+			 offset_type *types_list_elements)
+{
+  if (dwarf2_section_empty_p (section))
+    return 0;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return 0;
+
+  dwarf2_read_section (objfile, section);
+
+  return read_index_from_buffer (filename, deprecated_ok,
+				 section->buffer, section->size, map,
+				 cu_list, cu_list_elements,
+				 types_list, types_list_elements);
+}
+
+/* Look for an index for OBJFILE in the index cache, and if there is
+   one, read it as read_index_from_section would.  On success, the
+   cached file is kept open in dwarf2_per_objfile->index_cache_res.  */
+
+static int
+read_index_from_cache (struct objfile *objfile,
+		       struct mapped_index *map,
+		       const gdb_byte **cu_list,
+		       offset_type *cu_list_elements,
+		       const gdb_byte **types_list,
+		       offset_type *types_list_elements)
+{
+  const struct bfd_build_id *build_id;
+
+  if (!global_index_cache.enabled ())
+    return 0;
+
+  /* The cache never holds the index of a file using dwz, which would
+     need a second index for the dwz file.  */
+  if (dwarf2_get_dwz_file () != NULL)
+    return 0;
+
+  build_id = build_id_bfd_get (objfile->obfd);
+  if (build_id == NULL)
+    return 0;
+
+  std::unique_ptr<index_cache_resource> res
+    = global_index_cache.lookup_gdb_index (build_id);
+  if (res == NULL)
+    return 0;
+
+  if (!read_index_from_buffer (res->filename (), 0,
+			       res->data (), res->size (), map,
+			       cu_list, cu_list_elements,
+			       types_list, types_list_elements))
+    return 0;
+
+  dwarf2_per_objfile->index_cache_res = res.release ();
+  return 1;
+}
+
 
 /* Read the index file.  If everything went ok, initialize the "quick"
    elements of all the CUs and return 1.  Otherwise, return 0.  */
@@ -3340,11 +3608,18 @@ dwarf2_read_index (struct objfile *objfile)
   offset_type cu_list_elements, types_list_elements, dwz_list_elements = 0;
   struct dwz_file *dwz;
 
-  if (!read_index_from_section (objfile, objfile_name (objfile),
-				use_deprecated_index_sections,
-				&dwarf2_per_objfile->gdb_index, &local_map,
-				&cu_list, &cu_list_elements,
-				&types_list, &types_list_elements))
+  if (!dwarf2_section_empty_p (&dwarf2_per_objfile->gdb_index))
+    {
+      if (!read_index_from_section (objfile, objfile_name (objfile),
+				    use_deprecated_index_sections,
+				    &dwarf2_per_objfile->gdb_index, &local_map,
+				    &cu_list, &cu_list_elements,
+				    &types_list, &types_list_elements))
+	return 0;
+    }
+  else if (!read_index_from_cache (objfile, &local_map,
+				   &cu_list, &cu_list_elements,
+				   &types_list, &types_list_elements))
     return 0;
 
   /* Don't use the index if it's empty.  */
@@ -3405,91 +3680,549 @@ dwarf2_read_index (struct objfile *objfile)
   return 1;
 }
 
-/* A helper for the "quick" functions which sets the global
-   dwarf2_per_objfile according to OBJFILE.  */
-
-static void
-dw2_setup (struct objfile *objfile)
-{
-  dwarf2_per_objfile = ((struct dwarf2_per_objfile *)
-		        objfile_data (objfile, dwarf2_objfile_data_key));
-  gdb_assert (dwarf2_per_objfile);
-}
-
-/* die_reader_func for dw2_get_file_names.  */
+/* Read the address ranges of the CUs from the .debug_aranges SECTION,
+   and use them to populate the objfile's psymtabs_addrmap.  */
 
 static void
-dw2_get_file_names_reader (const struct die_reader_specs *reader,
-			   const gdb_byte *info_ptr,
-			   struct die_info *comp_unit_die,
-			   int has_children,
-			   void *data)
+create_addrmap_from_aranges (struct objfile *objfile,
+			     struct dwarf2_section_info *section)
 {
-  struct dwarf2_cu *cu = reader->cu;
-  struct dwarf2_per_cu_data *this_cu = cu->per_cu;  
-  struct objfile *objfile = dwarf2_per_objfile->objfile;
-  struct dwarf2_per_cu_data *lh_cu;
-  struct attribute *attr;
+  bfd *abfd = objfile->obfd;
+  struct gdbarch *gdbarch = get_objfile_arch (objfile);
+  enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
+  const gdb_byte *addr, *end;
+  struct obstack temp_obstack;
+  struct addrmap *mutable_map;
+  struct cleanup *cleanup;
+  CORE_ADDR baseaddr;
   int i;
-  void **slot;
-  struct quick_file_names *qfn;
 
-  gdb_assert (! this_cu->is_debug_types);
+  obstack_init (&temp_obstack);
+  cleanup = make_cleanup_obstack_free (&temp_obstack);
+  mutable_map = addrmap_create_mutable (&temp_obstack);
 
-  /* Our callers never want to match partial units -- instead they
-     will match the enclosing full CU.  */
-  if (comp_unit_die->tag == DW_TAG_partial_unit)
+  baseaddr = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+
+  std::unordered_map<ULONGEST, struct dwarf2_per_cu_data *> offset_to_cu;
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
     {
-      this_cu->v.quick->no_file_data = 1;
-      return;
-    }
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
 
-  lh_cu = this_cu;
-  slot = NULL;
+      if (!per_cu->is_debug_types && !per_cu->is_dwz)
+	offset_to_cu[to_underlying (per_cu->sect_off)] = per_cu;
+    }
 
-  line_header_up lh;
-  sect_offset line_offset {};
+  dwarf2_read_section (objfile, section);
+  addr = section->buffer;
+  end = addr + section->size;
 
-  attr = dwarf2_attr (comp_unit_die, DW_AT_stmt_list, cu);
-  if (attr)
+  while (addr < end)
     {
-      struct quick_file_names find_entry;
+      const gdb_byte *set_start = addr;
+      const gdb_byte *set_end;
+      unsigned int bytes_read, offset_size, address_size;
+      ULONGEST set_length, debug_info_offset;
 
-      line_offset = (sect_offset) DW_UNSND (attr);
+      if (end - addr < 4
+	  || (bfd_get_32 (abfd, addr) == 0xffffffff && end - addr < 12))
+	{
+	  complaint (&symfile_complaints,
+		     _(".debug_aranges has a truncated header"));
+	  break;
+	}
+      set_length = read_initial_length (abfd, addr, &bytes_read);
+      addr += bytes_read;
+      offset_size = bytes_read == 4 ? 4 : 8;
+      if (set_length > end - addr || set_length < 4 + offset_size)
+	{
+	  complaint (&symfile_complaints,
+		     _(".debug_aranges set at offset %s has invalid length"),
+		     pulongest (set_start - section->buffer));
+	  break;
+	}
+      set_end = addr + set_length;
 
-      /* We may have already read in this line header (TU line header sharing).
-	 If we have we're done.  */
-      find_entry.hash.dwo_unit = cu->dwo_unit;
-      find_entry.hash.line_sect_off = line_offset;
-      slot = htab_find_slot (dwarf2_per_objfile->quick_file_names_table,
-			     &find_entry, INSERT);
-      if (*slot != NULL)
+      if (read_2_bytes (abfd, addr) != 2)
 	{
-	  lh_cu->v.quick->file_names = (struct quick_file_names *) *slot;
-	  return;
+	  complaint (&symfile_complaints,
+		     _(".debug_aranges set at offset %s has unknown version"),
+		     pulongest (set_start - section->buffer));
+	  addr = set_end;
+	  continue;
+	}
+      addr += 2;
+
+      debug_info_offset = read_offset_1 (abfd, addr, offset_size);
+      addr += offset_size;
+      address_size = read_1_byte (abfd, addr);
+      /* The segment selector size must be zero, and tuples are
+	 aligned to twice the address size.  */
+      if ((address_size != 4 && address_size != 8)
+	  || read_1_byte (abfd, addr + 1) != 0)
+	{
+	  complaint (&symfile_complaints,
+		     _(".debug_aranges set at offset %s has unsupported "
+		       "address or segment size"),
+		     pulongest (set_start - section->buffer));
+	  addr = set_end;
+	  continue;
 	}
+      addr += 2;
+      addr = set_start + align_up (addr - set_start, 2 * address_size);
 
-      lh = dwarf_decode_line_header (line_offset, cu);
-    }
-  if (lh == NULL)
-    {
-      lh_cu->v.quick->no_file_data = 1;
-      return;
-    }
+      auto iter = offset_to_cu.find (debug_info_offset);
+      if (iter == offset_to_cu.end ())
+	{
+	  complaint (&symfile_complaints,
+		     _(".debug_aranges set at offset %s refers to unknown "
+		       "CU at offset %s"),
+		     pulongest (set_start - section->buffer),
+		     pulongest (debug_info_offset));
+	  addr = set_end;
+	  continue;
+	}
 
-  qfn = XOBNEW (&objfile->objfile_obstack, struct quick_file_names);
-  qfn->hash.dwo_unit = cu->dwo_unit;
-  qfn->hash.line_sect_off = line_offset;
-  gdb_assert (slot != NULL);
-  *slot = qfn;
+      while (addr + 2 * address_size <= set_end)
+	{
+	  ULONGEST start, length;
+	  CORE_ADDR lo, hi;
 
-  file_and_directory fnd = find_file_and_directory (comp_unit_die, cu);
+	  start = extract_unsigned_integer (addr, address_size, byte_order);
+	  addr += address_size;
+	  length = extract_unsigned_integer (addr, address_size, byte_order);
+	  addr += address_size;
 
-  qfn->num_file_names = lh->file_names.size ();
-  qfn->file_names =
-    XOBNEWVEC (&objfile->objfile_obstack, const char *, lh->file_names.size ());
-  for (i = 0; i < lh->file_names.size (); ++i)
-    qfn->file_names[i] = file_full_name (i + 1, lh.get (), fnd.comp_dir);
+	  if (start == 0 && length == 0)
+	    break;
+	  /* A range at zero is for code discarded from a COMDAT group,
+	     unless something really is at zero.  */
+	  if (start == 0 && !dwarf2_per_objfile->has_section_at_zero)
+	    continue;
+	  if (length == 0)
+	    continue;
+
+	  lo = gdbarch_adjust_dwarf2_addr (gdbarch, start + baseaddr);
+	  hi = gdbarch_adjust_dwarf2_addr (gdbarch, start + length + baseaddr);
+	  addrmap_set_empty (mutable_map, lo, hi - 1, iter->second);
+	}
+
+      addr = set_end;
+    }
+
+  objfile->psymtabs_addrmap = addrmap_create_fixed (mutable_map,
+						    &objfile->objfile_obstack);
+  do_cleanups (cleanup);
+}
+
+/* The hash function for names in .debug_names, from section 6.1.1.4.5
+   of the DWARF 5 standard.  Names are case folded, so that case
+   insensitive lookups find the same bucket.  */
+
+static uint32_t
+dwarf5_djb_hash (const char *str_)
+{
+  const unsigned char *str = (const unsigned char *) str_;
+  uint32_t hash = 5381;
+  unsigned char c;
+
+  /* Note: tolower ignores UTF-8 here, which is not fully compliant.  */
+  while ((c = *str++) != 0)
+    hash = hash * 33 + tolower (c);
+
+  return hash;
+}
+
+/* Read the .debug_names index in SECTION into MAP.  Return true if
+   all went well, false otherwise.  */
+
+static bool
+read_debug_names_from_section (struct objfile *objfile,
+			       struct dwarf2_section_info *section,
+			       struct mapped_debug_names *map)
+{
+  const gdb_byte *addr, *end, *abbrev_end;
+  unsigned int bytes_read;
+  ULONGEST length, foreign_tu_count, abbrev_table_size, augmentation_size;
+  bfd *abfd;
+
+  if (dwarf2_section_empty_p (section))
+    return false;
+
+  /* Older elfutils strip versions could keep the section in the main
+     executable while splitting it for the separate debug info file.  */
+  if ((get_section_flags (section) & SEC_HAS_CONTENTS) == 0)
+    return false;
+
+  dwarf2_read_section (objfile, section);
+
+  abfd = get_section_bfd_owner (section);
+  map->abfd = abfd;
+  addr = section->buffer;
+  end = addr + section->size;
+
+  if (end - addr < 4
+      || bfd_get_32 (abfd, addr) == 0
+      || (bfd_get_32 (abfd, addr) == 0xffffffff && end - addr < 12))
+    return false;
+  length = read_initial_length (abfd, addr, &bytes_read);
+  addr += bytes_read;
+  map->offset_size = bytes_read == 4 ? 4 : 8;
+
+  /* The linker concatenates the indices of the objects it links
+     rather than merging them; only an index covering the whole
+     section describes all the CUs.  */
+  if (length != end - addr)
+    return false;
+
+  /* The version, padding, and seven 4-byte counts.  */
+  if (length < 2 + 2 + 7 * 4)
+    return false;
+  if (read_2_bytes (abfd, addr) != 5)
+    return false;
+  addr += 4;
+
+  map->cu_count = read_4_bytes (abfd, addr);
+  map->tu_count = read_4_bytes (abfd, addr + 4);
+  foreign_tu_count = read_4_bytes (abfd, addr + 8);
+  map->bucket_count = read_4_bytes (abfd, addr + 12);
+  map->name_count = read_4_bytes (abfd, addr + 16);
+  abbrev_table_size = read_4_bytes (abfd, addr + 20);
+  augmentation_size = read_4_bytes (abfd, addr + 24);
+  addr += 7 * 4;
+
+  /* Foreign type units live in split DWARF files, which this index
+     reader does not handle.  */
+  if (foreign_tu_count != 0)
+    return false;
+
+  /* Lay out the tables, making sure they fit in the section.  */
+  auto take = [&] (ULONGEST size, const gdb_byte **table)
+    {
+      if (size > end - addr)
+	return false;
+      *table = addr;
+      addr += size;
+      return true;
+    };
+  const gdb_byte *augmentation, *abbrevs;
+  if (!take (align_up (augmentation_size, 4), &augmentation)
+      || !take (map->cu_count * map->offset_size, &map->cu_table)
+      || !take (map->tu_count * map->offset_size, &map->tu_table)
+      || !take (map->bucket_count * 4, &map->bucket_table)
+      || (map->bucket_count != 0
+	  && !take (map->name_count * 4, &map->hash_table))
+      || !take (map->name_count * map->offset_size, &map->string_offsets)
+      || !take (map->name_count * map->offset_size, &map->entry_offsets)
+      || !take (abbrev_table_size, &abbrevs))
+    return false;
+  map->entry_pool = addr;
+  map->end = end;
+
+  /* Read the abbreviation table.  */
+  abbrev_end = abbrevs + abbrev_table_size;
+  for (;;)
+    {
+      uint64_t code, tag;
+      debug_names_abbrev abbrev;
+
+      abbrevs = gdb_read_uleb128 (abbrevs, abbrev_end, &code);
+      if (abbrevs == NULL)
+	return false;
+      if (code == 0)
+	break;
+      abbrevs = gdb_read_uleb128 (abbrevs, abbrev_end, &tag);
+      if (abbrevs == NULL)
+	return false;
+      abbrev.dwarf_tag = tag;
+
+      for (;;)
+	{
+	  debug_names_abbrev::attr attr;
+	  uint64_t dw_idx, form;
+	  int64_t implicit_const = 0;
+
+	  abbrevs = gdb_read_uleb128 (abbrevs, abbrev_end, &dw_idx);
+	  if (abbrevs == NULL)
+	    return false;
+	  abbrevs = gdb_read_uleb128 (abbrevs, abbrev_end, &form);
+	  if (abbrevs == NULL)
+	    return false;
+	  if (dw_idx == 0 && form == 0)
+	    break;
+	  if (form == DW_FORM_implicit_const)
+	    {
+	      abbrevs = gdb_read_sleb128 (abbrevs, abbrev_end,
+					  &implicit_const);
+	      if (abbrevs == NULL)
+		return false;
+	    }
+
+	  attr.dw_idx = dw_idx;
+	  attr.form = form;
+	  attr.implicit_const = implicit_const;
+	  abbrev.attrs.push_back (attr);
+	}
+
+      if (!map->abbrevs.emplace (code, std::move (abbrev)).second)
+	return false;
+    }
+
+  return true;
+}
+
+/* Create the CUs of the .debug_names index MAP.  Return false if the
+   CU list is not usable.  */
+
+static bool
+create_cus_from_debug_names (struct objfile *objfile,
+			     const struct mapped_debug_names *map)
+{
+  struct dwarf2_section_info *section = &dwarf2_per_objfile->info;
+  std::vector<struct dwarf2_per_cu_data *> cus;
+  ULONGEST i;
+
+  dwarf2_read_section (objfile, section);
+
+  for (i = 0; i < map->cu_count; ++i)
+    {
+      ULONGEST sect_off = read_offset_1 (map->abfd,
+					 map->cu_table + i * map->offset_size,
+					 map->offset_size);
+
+      /* dwarf2_find_containing_comp_unit needs the CUs sorted.  */
+      if (sect_off >= section->size
+	  || (i > 0 && sect_off <= to_underlying (cus.back ()->sect_off)))
+	return false;
+
+      TRY
+	{
+	  cus.push_back (create_per_cu_for_unit (objfile, section,
+						 &dwarf2_per_objfile->abbrev,
+						 0, (sect_offset) sect_off));
+	}
+      CATCH (except, RETURN_MASK_ERROR)
+	{
+	  return false;
+	}
+      END_CATCH
+
+      cus.back ()->v.quick
+	= OBSTACK_ZALLOC (&objfile->objfile_obstack,
+			  struct dwarf2_per_cu_quick_data);
+    }
+
+  dwarf2_per_objfile->n_comp_units = cus.size ();
+  dwarf2_per_objfile->all_comp_units
+    = XOBNEWVEC (&objfile->objfile_obstack, struct dwarf2_per_cu_data *,
+		 cus.size ());
+  std::copy (cus.begin (), cus.end (), dwarf2_per_objfile->all_comp_units);
+
+  return true;
+}
+
+/* Create the type units of the .debug_names index MAP, and record
+   them in MAP in the order of its TU list.  Like .gdb_index, the
+   offsets refer to the single .debug_types section if there is one,
+   and to .debug_info otherwise.  Return false if the TU list is not
+   usable.  */
+
+static bool
+create_signatured_types_from_debug_names (struct objfile *objfile,
+					  struct mapped_debug_names *map)
+{
+  struct dwarf2_section_info *section;
+  ULONGEST i;
+  int j;
+
+  if (map->tu_count == 0)
+    return true;
+
+  switch (VEC_length (dwarf2_section_info_def, dwarf2_per_objfile->types))
+    {
+    case 0:
+      section = &dwarf2_per_objfile->info;
+      break;
+    case 1:
+      section = VEC_index (dwarf2_section_info_def,
+			   dwarf2_per_objfile->types, 0);
+      break;
+    default:
+      return false;
+    }
+
+  TRY
+    {
+      if (!create_all_type_units (objfile))
+	return false;
+    }
+  CATCH (except, RETURN_MASK_ERROR)
+    {
+      return false;
+    }
+  END_CATCH
+
+  std::unordered_map<ULONGEST, struct dwarf2_per_cu_data *> offset_to_tu;
+  for (j = 0; j < dwarf2_per_objfile->n_type_units; ++j)
+    {
+      struct signatured_type *sig_type = dwarf2_per_objfile->all_type_units[j];
+
+      sig_type->per_cu.v.quick
+	= OBSTACK_ZALLOC (&objfile->objfile_obstack,
+			  struct dwarf2_per_cu_quick_data);
+      if (sig_type->per_cu.section == section)
+	offset_to_tu[to_underlying (sig_type->per_cu.sect_off)]
+	  = &sig_type->per_cu;
+    }
+
+  for (i = 0; i < map->tu_count; ++i)
+    {
+      ULONGEST sect_off = read_offset_1 (map->abfd,
+					 map->tu_table + i * map->offset_size,
+					 map->offset_size);
+      auto iter = offset_to_tu.find (sect_off);
+
+      if (iter == offset_to_tu.end ())
+	return false;
+      map->type_units.push_back (iter->second);
+    }
+
+  return true;
+}
+
+/* Read the .debug_names section and, if it is usable, set up the
+   quick functions to use it.  Return true if all went well.  */
+
+static bool
+dwarf2_read_debug_names (struct objfile *objfile)
+{
+  std::unique_ptr<mapped_debug_names> map (new mapped_debug_names ());
+
+  if (!read_debug_names_from_section (objfile,
+				      &dwarf2_per_objfile->debug_names,
+				      map.get ()))
+    return false;
+
+  /* Don't use the index if it's empty.  */
+  if (map->name_count == 0)
+    return false;
+
+  /* The index of a dwz file would have to be read as well, and the
+     index does not say where the code of each CU is: that comes from
+     .debug_aranges, without which the index is not usable.  */
+  if (dwarf2_get_dwz_file () != NULL
+      || dwarf2_section_empty_p (&dwarf2_per_objfile->debug_aranges))
+    return false;
+
+  if (!create_cus_from_debug_names (objfile, map.get ()))
+    return false;
+
+  if (!create_signatured_types_from_debug_names (objfile, map.get ()))
+    {
+      xfree (dwarf2_per_objfile->all_type_units);
+      dwarf2_per_objfile->all_type_units = NULL;
+      dwarf2_per_objfile->n_type_units = 0;
+      dwarf2_per_objfile->n_allocated_type_units = 0;
+      dwarf2_per_objfile->signatured_types = NULL;
+      dwarf2_per_objfile->all_comp_units = NULL;
+      dwarf2_per_objfile->n_comp_units = 0;
+      return false;
+    }
+
+  create_addrmap_from_aranges (objfile, &dwarf2_per_objfile->debug_aranges);
+
+  dwarf2_per_objfile->debug_names_table = map.release ();
+  dwarf2_per_objfile->using_index = 1;
+  dwarf2_per_objfile->quick_file_names_table =
+    create_quick_file_names_table (dwarf2_per_objfile->n_comp_units);
+
+  return true;
+}
+
+/* A helper for the "quick" functions which sets the global
+   dwarf2_per_objfile according to OBJFILE.  */
+
+static void
+dw2_setup (struct objfile *objfile)
+{
+  dwarf2_per_objfile = ((struct dwarf2_per_objfile *)
+		        objfile_data (objfile, dwarf2_objfile_data_key));
+  gdb_assert (dwarf2_per_objfile);
+}
+
+/* die_reader_func for dw2_get_file_names.  */
+
+static void
+dw2_get_file_names_reader (const struct die_reader_specs *reader,
+			   const gdb_byte *info_ptr,
+			   struct die_info *comp_unit_die,
+			   int has_children,
+			   void *data)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  struct dwarf2_per_cu_data *this_cu = cu->per_cu;  
+  struct objfile *objfile = dwarf2_per_objfile->objfile;
+  struct dwarf2_per_cu_data *lh_cu;
+  struct attribute *attr;
+  int i;
+  void **slot;
+  struct quick_file_names *qfn;
+
+  gdb_assert (! this_cu->is_debug_types);
+
+  /* Our callers never want to match partial units -- instead they
+     will match the enclosing full CU.  */
+  if (comp_unit_die->tag == DW_TAG_partial_unit)
+    {
+      this_cu->v.quick->no_file_data = 1;
+      return;
+    }
+
+  lh_cu = this_cu;
+  slot = NULL;
+
+  line_header_up lh;
+  sect_offset line_offset {};
+
+  attr = dwarf2_attr (comp_unit_die, DW_AT_stmt_list, cu);
+  if (attr)
+    {
+      struct quick_file_names find_entry;
+
+      line_offset = (sect_offset) DW_UNSND (attr);
+
+      /* We may have already read in this line header (TU line header sharing).
+	 If we have we're done.  */
+      find_entry.hash.dwo_unit = cu->dwo_unit;
+      find_entry.hash.line_sect_off = line_offset;
+      slot = htab_find_slot (dwarf2_per_objfile->quick_file_names_table,
+			     &find_entry, INSERT);
+      if (*slot != NULL)
+	{
+	  lh_cu->v.quick->file_names = (struct quick_file_names *) *slot;
+	  return;
+	}
+
+      lh = dwarf_decode_line_header (line_offset, cu);
+    }
+  if (lh == NULL)
+    {
+      lh_cu->v.quick->no_file_data = 1;
+      return;
+    }
+
+  qfn = XOBNEW (&objfile->objfile_obstack, struct quick_file_names);
+  qfn->hash.dwo_unit = cu->dwo_unit;
+  qfn->hash.line_sect_off = line_offset;
+  gdb_assert (slot != NULL);
+  *slot = qfn;
+
+  file_and_directory fnd = find_file_and_directory (comp_unit_die, cu);
+
+  qfn->num_file_names = lh->file_names.size ();
+  qfn->file_names =
+    XOBNEWVEC (&objfile->objfile_obstack, const char *, lh->file_names.size ());
+  for (i = 0; i < lh->file_names.size (); ++i)
+    qfn->file_names[i] = file_full_name (i + 1, lh.get (), fnd.comp_dir);
   qfn->real_names = NULL;
 
   lh_cu->v.quick->file_names = qfn;
@@ -3679,6 +4412,49 @@ dw2_map_symtabs_matching_filename
   return false;
 }
 
+/* Return true if a symbol of kind SYMBOL_KIND, as recorded in an
+   index, may be found when looking up DOMAIN.  */
+
+static bool
+dw2_symbol_kind_matches_domain (gdb_index_symbol_kind symbol_kind,
+				domain_enum domain)
+{
+  switch (domain)
+    {
+    case VAR_DOMAIN:
+      return (symbol_kind == GDB_INDEX_SYMBOL_KIND_VARIABLE
+	      || symbol_kind == GDB_INDEX_SYMBOL_KIND_FUNCTION
+	      /* Some types are also in VAR_DOMAIN.  */
+	      || symbol_kind == GDB_INDEX_SYMBOL_KIND_TYPE);
+    case STRUCT_DOMAIN:
+      return symbol_kind == GDB_INDEX_SYMBOL_KIND_TYPE;
+    case LABEL_DOMAIN:
+      return symbol_kind == GDB_INDEX_SYMBOL_KIND_OTHER;
+    default:
+      return true;
+    }
+}
+
+/* Return true if a symbol of kind SYMBOL_KIND, as recorded in an
+   index, may be found when searching KIND.  */
+
+static bool
+dw2_symbol_kind_matches_search (gdb_index_symbol_kind symbol_kind,
+				enum search_domain kind)
+{
+  switch (kind)
+    {
+    case VARIABLES_DOMAIN:
+      return symbol_kind == GDB_INDEX_SYMBOL_KIND_VARIABLE;
+    case FUNCTIONS_DOMAIN:
+      return symbol_kind == GDB_INDEX_SYMBOL_KIND_FUNCTION;
+    case TYPES_DOMAIN:
+      return symbol_kind == GDB_INDEX_SYMBOL_KIND_TYPE;
+    default:
+      return true;
+    }
+}
+
 /* Struct used to manage iterating over all CUs looking for a symbol.  */
 
 struct dw2_symtab_iterator
@@ -3789,29 +4565,9 @@ dw2_symtab_iter_next (struct dw2_symtab_iterator *iter)
 	}
 
       /* Only check the symbol's kind if it has one.  */
-      if (attrs_valid)
-	{
-	  switch (iter->domain)
-	    {
-	    case VAR_DOMAIN:
-	      if (symbol_kind != GDB_INDEX_SYMBOL_KIND_VARIABLE
-		  && symbol_kind != GDB_INDEX_SYMBOL_KIND_FUNCTION
-		  /* Some types are also in VAR_DOMAIN.  */
-		  && symbol_kind != GDB_INDEX_SYMBOL_KIND_TYPE)
-		continue;
-	      break;
-	    case STRUCT_DOMAIN:
-	      if (symbol_kind != GDB_INDEX_SYMBOL_KIND_TYPE)
-		continue;
-	      break;
-	    case LABEL_DOMAIN:
-	      if (symbol_kind != GDB_INDEX_SYMBOL_KIND_OTHER)
-		continue;
-	      break;
-	    default:
-	      break;
-	    }
-	}
+      if (attrs_valid
+	  && !dw2_symbol_kind_matches_domain (symbol_kind, iter->domain))
+	continue;
 
       ++iter->next;
       return per_cu;
@@ -3820,6 +4576,39 @@ dw2_symtab_iter_next (struct dw2_symtab_iterator *iter)
   return NULL;
 }
 
+/* Expand PER_CU, which an index says may define NAME in DOMAIN, and
+   look for NAME in its BLOCK_INDEX block.  Return the symtab if it
+   defines NAME.  If it only has an opaque definition, set *STAB_BEST
+   to the symtab and return NULL.  */
+
+static struct compunit_symtab *
+dw2_lookup_symbol_in_cu (struct dwarf2_per_cu_data *per_cu, int block_index,
+			 const char *name, domain_enum domain,
+			 struct compunit_symtab **stab_best)
+{
+  struct symbol *sym, *with_opaque = NULL;
+  struct compunit_symtab *stab = dw2_instantiate_symtab (per_cu);
+  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (stab);
+  struct block *block = BLOCKVECTOR_BLOCK (bv, block_index);
+
+  sym = block_find_symbol (block, name, domain,
+			   block_find_non_opaque_type_preferred,
+			   &with_opaque);
+
+  /* Some caution must be observed with overloaded functions
+     and methods, since the index will not contain any overload
+     information (but NAME might contain it).  */
+
+  if (sym != NULL
+      && strcmp_iw (SYMBOL_SEARCH_NAME (sym), name) == 0)
+    return stab;
+  if (with_opaque != NULL
+      && strcmp_iw (SYMBOL_SEARCH_NAME (with_opaque), name) == 0)
+    *stab_best = stab;
+
+  return NULL;
+}
+
 static struct compunit_symtab *
 dw2_lookup_symbol (struct objfile *objfile, int block_index,
 		   const char *name, domain_enum domain)
@@ -3841,25 +4630,12 @@ dw2_lookup_symbol (struct objfile *objfile, int block_index,
 
       while ((per_cu = dw2_symtab_iter_next (&iter)) != NULL)
 	{
-	  struct symbol *sym, *with_opaque = NULL;
-	  struct compunit_symtab *stab = dw2_instantiate_symtab (per_cu);
-	  const struct blockvector *bv = COMPUNIT_BLOCKVECTOR (stab);
-	  struct block *block = BLOCKVECTOR_BLOCK (bv, block_index);
-
-	  sym = block_find_symbol (block, name, domain,
-				   block_find_non_opaque_type_preferred,
-				   &with_opaque);
+	  struct compunit_symtab *stab
+	    = dw2_lookup_symbol_in_cu (per_cu, block_index, name, domain,
+				       &stab_best);
 
-	  /* Some caution must be observed with overloaded functions
-	     and methods, since the index will not contain any overload
-	     information (but NAME might contain it).  */
-
-	  if (sym != NULL
-	      && strcmp_iw (SYMBOL_SEARCH_NAME (sym), name) == 0)
+	  if (stab != NULL)
 	    return stab;
-	  if (with_opaque != NULL
-	      && strcmp_iw (SYMBOL_SEARCH_NAME (with_opaque), name) == 0)
-	    stab_best = stab;
 
 	  /* Keep looking through other CUs.  */
 	}
@@ -3932,35 +4708,45 @@ dw2_expand_symtabs_for_function (struct objfile *objfile,
       struct dw2_symtab_iterator iter;
       struct dwarf2_per_cu_data *per_cu;
 
+      std::vector<struct dwarf2_per_cu_data *> units;
+
       /* Note: It doesn't matter what we pass for block_index here.  */
       dw2_symtab_iter_init (&iter, index, 0, GLOBAL_BLOCK, VAR_DOMAIN,
 			    func_name);
 
       while ((per_cu = dw2_symtab_iter_next (&iter)) != NULL)
-	dw2_instantiate_symtab (per_cu);
+	units.push_back (per_cu);
+
+      dwarf2_preload_scope preload (units);
+
+      for (struct dwarf2_per_cu_data *unit : units)
+	dw2_instantiate_symtab (unit);
     }
 }
 
 static void
 dw2_expand_all_symtabs (struct objfile *objfile)
 {
+  std::vector<struct dwarf2_per_cu_data *> units;
   int i;
 
   dw2_setup (objfile);
 
   for (i = 0; i < (dwarf2_per_objfile->n_comp_units
 		   + dwarf2_per_objfile->n_type_units); ++i)
-    {
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+    units.push_back (dw2_get_cutu (i));
 
-      dw2_instantiate_symtab (per_cu);
-    }
+  dwarf2_preload_scope preload (units);
+
+  for (struct dwarf2_per_cu_data *per_cu : units)
+    dw2_instantiate_symtab (per_cu);
 }
 
 static void
 dw2_expand_symtabs_with_fullname (struct objfile *objfile,
 				  const char *fullname)
 {
+  std::vector<struct dwarf2_per_cu_data *> units;
   int i;
 
   dw2_setup (objfile);
@@ -3990,11 +4776,16 @@ dw2_expand_symtabs_with_fullname (struct objfile *objfile,
 
 	  if (filename_cmp (this_fullname, fullname) == 0)
 	    {
-	      dw2_instantiate_symtab (per_cu);
+	      units.push_back (per_cu);
 	      break;
 	    }
 	}
     }
+
+  dwarf2_preload_scope preload (units);
+
+  for (struct dwarf2_per_cu_data *per_cu : units)
+    dw2_instantiate_symtab (per_cu);
 }
 
 static void
@@ -4011,96 +4802,169 @@ dw2_map_matching_symbols (struct objfile *objfile,
      does not look for non-Ada symbols this function should just return.  */
 }
 
+/* Expand PER_CU, found by the name search of expand_symtabs_matching,
+   if FILE_MATCHER is NULL or PER_CU was marked as matching it.  */
+
 static void
-dw2_expand_symtabs_matching
-  (struct objfile *objfile,
+dw2_expand_symtabs_matching_one
+  (struct dwarf2_per_cu_data *per_cu,
    gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
-   gdb::function_view<expand_symtabs_symbol_matcher_ftype> symbol_matcher,
-   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
-   enum search_domain kind)
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
 {
-  int i;
-  offset_type iter;
-  struct mapped_index *index;
+  if (file_matcher == NULL || per_cu->v.quick->mark)
+    {
+      int symtab_was_null =
+	(per_cu->v.quick->compunit_symtab == NULL);
 
-  dw2_setup (objfile);
+      dw2_instantiate_symtab (per_cu);
 
-  /* index_table is NULL if OBJF_READNOW.  */
-  if (!dwarf2_per_objfile->index_table)
-    return;
-  index = dwarf2_per_objfile->index_table;
+      if (expansion_notify != NULL
+	  && symtab_was_null
+	  && per_cu->v.quick->compunit_symtab != NULL)
+	{
+	  expansion_notify (per_cu->v.quick->compunit_symtab);
+	}
+    }
+}
+
+/* Expand UNITS, found by the name search of expand_symtabs_matching,
+   in order, as dw2_expand_symtabs_matching_one does.  Worker threads
+   read their DIEs ahead of the main thread.  */
 
-  if (file_matcher != NULL)
+static void
+dw2_expand_symtabs_matching_units
+  (const std::vector<struct dwarf2_per_cu_data *> &units,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify)
+{
+  dwarf2_preload_scope preload (units);
+
+  for (struct dwarf2_per_cu_data *per_cu : units)
     {
-      htab_up visited_found (htab_create_alloc (10, htab_hash_pointer,
+      QUIT;
+
+      dw2_expand_symtabs_matching_one (per_cu, file_matcher,
+				       expansion_notify);
+    }
+}
+
+/* Add PER_CU, found by the name search of expand_symtabs_matching, to
+   UNITS if it needs expanding.  */
+
+static void
+dw2_add_matching_unit (std::vector<struct dwarf2_per_cu_data *> *units,
+		       struct dwarf2_per_cu_data *per_cu,
+		       bool have_file_matcher)
+{
+  if ((!have_file_matcher || per_cu->v.quick->mark)
+      && per_cu->v.quick->compunit_symtab == NULL
+      && (units->empty () || units->back () != per_cu))
+    units->push_back (per_cu);
+}
+
+/* Set the mark of each CU whose files match FILE_MATCHER, the first
+   step of expand_symtabs_matching.  */
+
+static void
+dw2_expand_symtabs_matching_file_matcher
+  (struct objfile *objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher)
+{
+  int i;
+
+  if (file_matcher == NULL)
+    return;
+
+  htab_up visited_found (htab_create_alloc (10, htab_hash_pointer,
+					    htab_eq_pointer,
+					    NULL, xcalloc, xfree));
+  htab_up visited_not_found (htab_create_alloc (10, htab_hash_pointer,
 						htab_eq_pointer,
 						NULL, xcalloc, xfree));
-      htab_up visited_not_found (htab_create_alloc (10, htab_hash_pointer,
-						    htab_eq_pointer,
-						    NULL, xcalloc, xfree));
 
-      /* The rule is CUs specify all the files, including those used by
-	 any TU, so there's no need to scan TUs here.  */
+  /* The rule is CUs specify all the files, including those used by
+     any TU, so there's no need to scan TUs here.  */
 
-      for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
-	{
-	  int j;
-	  struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
-	  struct quick_file_names *file_data;
-	  void **slot;
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    {
+      int j;
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
+      struct quick_file_names *file_data;
+      void **slot;
 
-	  QUIT;
+      QUIT;
 
-	  per_cu->v.quick->mark = 0;
+      per_cu->v.quick->mark = 0;
 
-	  /* We only need to look at symtabs not already expanded.  */
-	  if (per_cu->v.quick->compunit_symtab)
-	    continue;
+      /* We only need to look at symtabs not already expanded.  */
+      if (per_cu->v.quick->compunit_symtab)
+	continue;
 
-	  file_data = dw2_get_file_names (per_cu);
-	  if (file_data == NULL)
-	    continue;
+      file_data = dw2_get_file_names (per_cu);
+      if (file_data == NULL)
+	continue;
 
-	  if (htab_find (visited_not_found.get (), file_data) != NULL)
-	    continue;
-	  else if (htab_find (visited_found.get (), file_data) != NULL)
+      if (htab_find (visited_not_found.get (), file_data) != NULL)
+	continue;
+      else if (htab_find (visited_found.get (), file_data) != NULL)
+	{
+	  per_cu->v.quick->mark = 1;
+	  continue;
+	}
+
+      for (j = 0; j < file_data->num_file_names; ++j)
+	{
+	  const char *this_real_name;
+
+	  if (file_matcher (file_data->file_names[j], false))
 	    {
 	      per_cu->v.quick->mark = 1;
-	      continue;
+	      break;
 	    }
 
-	  for (j = 0; j < file_data->num_file_names; ++j)
+	  /* Before we invoke realpath, which can get expensive when many
+	     files are involved, do a quick comparison of the basenames.  */
+	  if (!basenames_may_differ
+	      && !file_matcher (lbasename (file_data->file_names[j]),
+				true))
+	    continue;
+
+	  this_real_name = dw2_get_real_path (objfile, file_data, j);
+	  if (file_matcher (this_real_name, false))
 	    {
-	      const char *this_real_name;
+	      per_cu->v.quick->mark = 1;
+	      break;
+	    }
+	}
 
-	      if (file_matcher (file_data->file_names[j], false))
-		{
-		  per_cu->v.quick->mark = 1;
-		  break;
-		}
+      slot = htab_find_slot (per_cu->v.quick->mark
+			     ? visited_found.get ()
+			     : visited_not_found.get (),
+			     file_data, INSERT);
+      *slot = file_data;
+    }
+}
 
-	      /* Before we invoke realpath, which can get expensive when many
-		 files are involved, do a quick comparison of the basenames.  */
-	      if (!basenames_may_differ
-		  && !file_matcher (lbasename (file_data->file_names[j]),
-				    true))
-		continue;
+static void
+dw2_expand_symtabs_matching
+  (struct objfile *objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   gdb::function_view<expand_symtabs_symbol_matcher_ftype> symbol_matcher,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
+   enum search_domain kind)
+{
+  offset_type iter;
+  struct mapped_index *index;
+  std::vector<struct dwarf2_per_cu_data *> units;
 
-	      this_real_name = dw2_get_real_path (objfile, file_data, j);
-	      if (file_matcher (this_real_name, false))
-		{
-		  per_cu->v.quick->mark = 1;
-		  break;
-		}
-	    }
+  dw2_setup (objfile);
 
-	  slot = htab_find_slot (per_cu->v.quick->mark
-				 ? visited_found.get ()
-				 : visited_not_found.get (),
-				 file_data, INSERT);
-	  *slot = file_data;
-	}
-    }
+  /* index_table is NULL if OBJF_READNOW.  */
+  if (!dwarf2_per_objfile->index_table)
+    return;
+  index = dwarf2_per_objfile->index_table;
+
+  dw2_expand_symtabs_matching_file_matcher (objfile, file_matcher);
 
   for (iter = 0; iter < index->symbol_table_slots; ++iter)
     {
@@ -4151,26 +5015,9 @@ dw2_expand_symtabs_matching
 	    }
 
 	  /* Only check the symbol's kind if it has one.  */
-	  if (attrs_valid)
-	    {
-	      switch (kind)
-		{
-		case VARIABLES_DOMAIN:
-		  if (symbol_kind != GDB_INDEX_SYMBOL_KIND_VARIABLE)
-		    continue;
-		  break;
-		case FUNCTIONS_DOMAIN:
-		  if (symbol_kind != GDB_INDEX_SYMBOL_KIND_FUNCTION)
-		    continue;
-		  break;
-		case TYPES_DOMAIN:
-		  if (symbol_kind != GDB_INDEX_SYMBOL_KIND_TYPE)
-		    continue;
-		  break;
-		default:
-		  break;
-		}
-	    }
+	  if (attrs_valid
+	      && !dw2_symbol_kind_matches_search (symbol_kind, kind))
+	    continue;
 
 	  /* Don't crash on bad data.  */
 	  if (cu_index >= (dwarf2_per_objfile->n_comp_units
@@ -4182,178 +5029,694 @@ dw2_expand_symtabs_matching
 	      continue;
 	    }
 
-	  per_cu = dw2_get_cutu (cu_index);
-	  if (file_matcher == NULL || per_cu->v.quick->mark)
-	    {
-	      int symtab_was_null =
-		(per_cu->v.quick->compunit_symtab == NULL);
+	  per_cu = dw2_get_cutu (cu_index);
+	  dw2_add_matching_unit (&units, per_cu, file_matcher != NULL);
+	}
+    }
+
+  dw2_expand_symtabs_matching_units (units, file_matcher, expansion_notify);
+}
+
+/* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
+   symtab.  */
+
+static struct compunit_symtab *
+recursively_find_pc_sect_compunit_symtab (struct compunit_symtab *cust,
+					  CORE_ADDR pc)
+{
+  int i;
+
+  if (COMPUNIT_BLOCKVECTOR (cust) != NULL
+      && blockvector_contains_pc (COMPUNIT_BLOCKVECTOR (cust), pc))
+    return cust;
+
+  if (cust->includes == NULL)
+    return NULL;
+
+  for (i = 0; cust->includes[i]; ++i)
+    {
+      struct compunit_symtab *s = cust->includes[i];
+
+      s = recursively_find_pc_sect_compunit_symtab (s, pc);
+      if (s != NULL)
+	return s;
+    }
+
+  return NULL;
+}
+
+static struct compunit_symtab *
+dw2_find_pc_sect_compunit_symtab (struct objfile *objfile,
+				  struct bound_minimal_symbol msymbol,
+				  CORE_ADDR pc,
+				  struct obj_section *section,
+				  int warn_if_readin)
+{
+  struct dwarf2_per_cu_data *data;
+  struct compunit_symtab *result;
+
+  dw2_setup (objfile);
+
+  if (!objfile->psymtabs_addrmap)
+    return NULL;
+
+  data = (struct dwarf2_per_cu_data *) addrmap_find (objfile->psymtabs_addrmap,
+						     pc);
+  if (!data)
+    return NULL;
+
+  if (warn_if_readin && data->v.quick->compunit_symtab)
+    warning (_("(Internal error: pc %s in read in CU, but not in symtab.)"),
+	     paddress (get_objfile_arch (objfile), pc));
+
+  result
+    = recursively_find_pc_sect_compunit_symtab (dw2_instantiate_symtab (data),
+						pc);
+  gdb_assert (result != NULL);
+  return result;
+}
+
+static void
+dw2_map_symbol_filenames (struct objfile *objfile, symbol_filename_ftype *fun,
+			  void *data, int need_fullname)
+{
+  int i;
+  htab_up visited (htab_create_alloc (10, htab_hash_pointer, htab_eq_pointer,
+				      NULL, xcalloc, xfree));
+
+  dw2_setup (objfile);
+
+  /* The rule is CUs specify all the files, including those used by
+     any TU, so there's no need to scan TUs here.
+     We can ignore file names coming from already-expanded CUs.  */
+
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    {
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+
+      if (per_cu->v.quick->compunit_symtab)
+	{
+	  void **slot = htab_find_slot (visited.get (),
+					per_cu->v.quick->file_names,
+					INSERT);
+
+	  *slot = per_cu->v.quick->file_names;
+	}
+    }
+
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    {
+      int j;
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
+      struct quick_file_names *file_data;
+      void **slot;
+
+      /* We only need to look at symtabs not already expanded.  */
+      if (per_cu->v.quick->compunit_symtab)
+	continue;
+
+      file_data = dw2_get_file_names (per_cu);
+      if (file_data == NULL)
+	continue;
+
+      slot = htab_find_slot (visited.get (), file_data, INSERT);
+      if (*slot)
+	{
+	  /* Already visited.  */
+	  continue;
+	}
+      *slot = file_data;
+
+      for (j = 0; j < file_data->num_file_names; ++j)
+	{
+	  const char *this_real_name;
+
+	  if (need_fullname)
+	    this_real_name = dw2_get_real_path (objfile, file_data, j);
+	  else
+	    this_real_name = NULL;
+	  (*fun) (file_data->file_names[j], this_real_name, data);
+	}
+    }
+}
+
+static int
+dw2_has_symbols (struct objfile *objfile)
+{
+  return 1;
+}
+
+const struct quick_symbol_functions dwarf2_gdb_index_functions =
+{
+  dw2_has_symbols,
+  dw2_find_last_source_symtab,
+  dw2_forget_cached_source_info,
+  dw2_map_symtabs_matching_filename,
+  dw2_lookup_symbol,
+  dw2_print_stats,
+  dw2_dump,
+  dw2_relocate,
+  dw2_expand_symtabs_for_function,
+  dw2_expand_all_symtabs,
+  dw2_expand_symtabs_with_fullname,
+  dw2_map_matching_symbols,
+  dw2_expand_symtabs_matching,
+  dw2_find_pc_sect_compunit_symtab,
+  dw2_map_symbol_filenames
+};
+
+/* Return the kind of symbol named by a .debug_names entry with tag
+   TAG.  */
+
+static gdb_index_symbol_kind
+debug_names_tag_kind (ULONGEST tag)
+{
+  switch (tag)
+    {
+    case DW_TAG_subprogram:
+    case DW_TAG_inlined_subroutine:
+    case DW_TAG_entry_point:
+      return GDB_INDEX_SYMBOL_KIND_FUNCTION;
+    case DW_TAG_variable:
+    case DW_TAG_constant:
+    case DW_TAG_enumerator:
+    case DW_TAG_member:
+      return GDB_INDEX_SYMBOL_KIND_VARIABLE;
+    case DW_TAG_namespace:
+    case DW_TAG_base_type:
+    case DW_TAG_class_type:
+    case DW_TAG_enumeration_type:
+    case DW_TAG_interface_type:
+    case DW_TAG_structure_type:
+    case DW_TAG_subrange_type:
+    case DW_TAG_typedef:
+    case DW_TAG_union_type:
+    case DW_TAG_unspecified_type:
+      return GDB_INDEX_SYMBOL_KIND_TYPE;
+    default:
+      return GDB_INDEX_SYMBOL_KIND_OTHER;
+    }
+}
+
+/* Return the name of entry NAMEI of the name table of MAP, or NULL if
+   its string offset is invalid.  */
+
+static const char *
+debug_names_namei_to_name (const struct mapped_debug_names *map,
+			   ULONGEST namei)
+{
+  struct dwarf2_section_info *str = &dwarf2_per_objfile->str;
+  ULONGEST str_off = read_offset_1 (map->abfd,
+				    map->string_offsets
+				    + namei * map->offset_size,
+				    map->offset_size);
+
+  dwarf2_read_section (dwarf2_per_objfile->objfile, str);
+  if (str_off >= str->size
+      || memchr (str->buffer + str_off, '\0', str->size - str_off) == NULL)
+    {
+      complaint (&symfile_complaints,
+		 _(".debug_names name %s has invalid string offset %s "
+		   "[in module %s]"),
+		 pulongest (namei), pulongest (str_off),
+		 objfile_name (dwarf2_per_objfile->objfile));
+      return NULL;
+    }
+
+  return (const char *) str->buffer + str_off;
+}
+
+/* Return the start of the entries of name NAMEI of MAP in its entry
+   pool, or NULL if the entry offset is invalid.  */
+
+static const gdb_byte *
+debug_names_namei_to_entries (const struct mapped_debug_names *map,
+			      ULONGEST namei)
+{
+  ULONGEST entry_off = read_offset_1 (map->abfd,
+				      map->entry_offsets
+				      + namei * map->offset_size,
+				      map->offset_size);
+
+  if (entry_off >= map->end - map->entry_pool)
+    {
+      complaint (&symfile_complaints,
+		 _(".debug_names name %s has invalid entry offset %s "
+		   "[in module %s]"),
+		 pulongest (namei), pulongest (entry_off),
+		 objfile_name (dwarf2_per_objfile->objfile));
+      return NULL;
+    }
+
+  return map->entry_pool + entry_off;
+}
+
+/* Look up NAME in MAP.  Return the start of its entries in the entry
+   pool, or NULL if it is not there.  */
+
+static const gdb_byte *
+debug_names_find_name (const struct mapped_debug_names *map,
+		       const char *name)
+{
+  gdb::unique_xmalloc_ptr<char> without_params;
+  int (*cmp) (const char *, const char *);
+  ULONGEST namei;
+
+  name = index_lookup_name (name, &without_params);
+  cmp = (case_sensitivity == case_sensitive_on ? strcmp : strcasecmp);
+
+  /* Without a hash table, the names can only be searched linearly.  */
+  if (map->bucket_count == 0)
+    {
+      for (namei = 0; namei < map->name_count; ++namei)
+	{
+	  const char *str = debug_names_namei_to_name (map, namei);
+
+	  if (str != NULL && cmp (name, str) == 0)
+	    return debug_names_namei_to_entries (map, namei);
+	}
+      return NULL;
+    }
+
+  uint32_t hash = dwarf5_djb_hash (name);
+  ULONGEST bucket = hash % map->bucket_count;
+
+  /* The bucket holds the 1-based index of its first name; the names of
+     a bucket are contiguous, and end where the hashes stop belonging
+     to the bucket.  */
+  namei = read_4_bytes (map->abfd, map->bucket_table + bucket * 4);
+  if (namei == 0)
+    return NULL;
+  for (--namei; namei < map->name_count; ++namei)
+    {
+      uint32_t namei_hash = read_4_bytes (map->abfd,
+					  map->hash_table + namei * 4);
+      const char *str;
+
+      if (namei_hash % map->bucket_count != bucket)
+	break;
+      if (namei_hash != hash)
+	continue;
+
+      str = debug_names_namei_to_name (map, namei);
+      if (str != NULL && cmp (name, str) == 0)
+	return debug_names_namei_to_entries (map, namei);
+    }
+
+  return NULL;
+}
+
+/* Read a value of FORM from *ADDR in the entry pool of MAP into
+   *VALUE, and advance *ADDR past it.  IMPLICIT_CONST is the value of
+   DW_FORM_implicit_const.  Return false if the form is unknown or the
+   value runs past the end of the pool.  */
+
+static bool
+debug_names_read_value (const struct mapped_debug_names *map,
+			ULONGEST form, LONGEST implicit_const,
+			const gdb_byte **addr, ULONGEST *value)
+{
+  const gdb_byte *ptr = *addr;
+  size_t size;
+
+  switch (form)
+    {
+    case DW_FORM_flag_present:
+      *value = 1;
+      return true;
+    case DW_FORM_implicit_const:
+      *value = implicit_const;
+      return true;
+    case DW_FORM_udata:
+    case DW_FORM_ref_udata:
+      {
+	uint64_t uval;
+
+	ptr = gdb_read_uleb128 (ptr, map->end, &uval);
+	if (ptr == NULL)
+	  return false;
+	*value = uval;
+	*addr = ptr;
+	return true;
+      }
+    case DW_FORM_sdata:
+      {
+	int64_t sval;
+
+	ptr = gdb_read_sleb128 (ptr, map->end, &sval);
+	if (ptr == NULL)
+	  return false;
+	*value = sval;
+	*addr = ptr;
+	return true;
+      }
+    case DW_FORM_flag:
+    case DW_FORM_data1:
+    case DW_FORM_ref1:
+      size = 1;
+      break;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:
+      size = 2;
+      break;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:
+      size = 4;
+      break;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:
+      size = 8;
+      break;
+    case DW_FORM_strp:
+    case DW_FORM_sec_offset:
+      size = map->offset_size;
+      break;
+    default:
+      return false;
+    }
+
+  if (size > map->end - ptr)
+    return false;
+  *value = extract_unsigned_integer (ptr, size,
+				     bfd_big_endian (map->abfd)
+				     ? BFD_ENDIAN_BIG : BFD_ENDIAN_LITTLE);
+  *addr = ptr + size;
+  return true;
+}
+
+/* One entry of the .debug_names entry pool, as read by
+   debug_names_read_entry.  */
+
+struct debug_names_entry
+{
+  /* The unit of the entry, or NULL if it names none that we know.  */
+  struct dwarf2_per_cu_data *per_cu;
+
+  /* The kind of symbol the entry describes.  */
+  gdb_index_symbol_kind symbol_kind;
+
+  /* 1 if the symbol is static, 0 if it is global, and -1 if the
+     entry does not say.  */
+  int is_static;
+};
+
+/* Read the entry at *ADDR in the entry pool of MAP into *ENTRY, and
+   advance *ADDR past it.  Return false at the end of the entries of a
+   name, or if the entry is invalid.  */
+
+static bool
+debug_names_read_entry (const struct mapped_debug_names *map,
+			const gdb_byte **addr, struct debug_names_entry *entry)
+{
+  uint64_t code;
+  ULONGEST cu_index = (ULONGEST) -1, tu_index = (ULONGEST) -1;
+
+  *addr = gdb_read_uleb128 (*addr, map->end, &code);
+  if (*addr == NULL || code == 0)
+    return false;
+
+  auto iter = map->abbrevs.find (code);
+  if (iter == map->abbrevs.end ())
+    {
+      complaint (&symfile_complaints,
+		 _(".debug_names entry has unknown abbreviation %s "
+		   "[in module %s]"),
+		 pulongest (code),
+		 objfile_name (dwarf2_per_objfile->objfile));
+      return false;
+    }
+  const debug_names_abbrev &abbrev = iter->second;
+
+  entry->symbol_kind = debug_names_tag_kind (abbrev.dwarf_tag);
+  entry->is_static = -1;
+  for (const debug_names_abbrev::attr &attr : abbrev.attrs)
+    {
+      ULONGEST value;
+
+      if (!debug_names_read_value (map, attr.form, attr.implicit_const,
+				   addr, &value))
+	{
+	  complaint (&symfile_complaints,
+		     _(".debug_names entry has unsupported form %s "
+		       "[in module %s]"),
+		     dwarf_form_name (attr.form),
+		     objfile_name (dwarf2_per_objfile->objfile));
+	  return false;
+	}
+
+      switch (attr.dw_idx)
+	{
+	case DW_IDX_compile_unit:
+	  cu_index = value;
+	  break;
+	case DW_IDX_type_unit:
+	  tu_index = value;
+	  break;
+	case DW_IDX_GNU_internal:
+	  entry->is_static = 1;
+	  break;
+	case DW_IDX_GNU_external:
+	  entry->is_static = 0;
+	  break;
+	}
+    }
+
+  /* An index of a single CU need not say which CU an entry is in.  */
+  if (cu_index == (ULONGEST) -1 && tu_index == (ULONGEST) -1
+      && map->cu_count == 1)
+    cu_index = 0;
+
+  if (tu_index < map->type_units.size ())
+    entry->per_cu = map->type_units[tu_index];
+  else if (cu_index < map->cu_count)
+    entry->per_cu = dw2_get_cu (cu_index);
+  else
+    {
+      complaint (&symfile_complaints,
+		 _(".debug_names entry has bad CU index [in module %s]"),
+		 objfile_name (dwarf2_per_objfile->objfile));
+      entry->per_cu = NULL;
+    }
+
+  return true;
+}
+
+/* Struct used to manage iterating over the CUs that a .debug_names
+   index lists for a name.  */
 
-	      dw2_instantiate_symtab (per_cu);
+struct dw2_debug_names_iterator
+{
+  /* The internalized form of .debug_names.  */
+  const struct mapped_debug_names *map;
+  /* If non-zero, only look for symbols that match BLOCK_INDEX.  */
+  int want_specific_block;
+  /* One of GLOBAL_BLOCK or STATIC_BLOCK.
+     Unused if !WANT_SPECIFIC_BLOCK.  */
+  int block_index;
+  /* The kind of symbol we're looking for.  */
+  domain_enum domain;
+  /* The next entry to read in the entry pool, or NULL if there are
+     no more.  */
+  const gdb_byte *addr;
+};
 
-	      if (expansion_notify != NULL
-		  && symtab_was_null
-		  && per_cu->v.quick->compunit_symtab != NULL)
-		{
-		  expansion_notify (per_cu->v.quick->compunit_symtab);
-		}
-	    }
-	}
-    }
+/* Initialize the .debug_names iterator ITER, as dw2_symtab_iter_init
+   does for .gdb_index.  */
+
+static void
+dw2_debug_names_iter_init (struct dw2_debug_names_iterator *iter,
+			   const struct mapped_debug_names *map,
+			   int want_specific_block,
+			   int block_index,
+			   domain_enum domain,
+			   const char *name)
+{
+  iter->map = map;
+  iter->want_specific_block = want_specific_block;
+  iter->block_index = block_index;
+  iter->domain = domain;
+  iter->addr = debug_names_find_name (map, name);
 }
 
-/* A helper for dw2_find_pc_sect_compunit_symtab which finds the most specific
-   symtab.  */
+/* Return the next matching CU or NULL if there are no more.  */
 
-static struct compunit_symtab *
-recursively_find_pc_sect_compunit_symtab (struct compunit_symtab *cust,
-					  CORE_ADDR pc)
+static struct dwarf2_per_cu_data *
+dw2_debug_names_iter_next (struct dw2_debug_names_iterator *iter)
 {
-  int i;
+  struct debug_names_entry entry;
 
-  if (COMPUNIT_BLOCKVECTOR (cust) != NULL
-      && blockvector_contains_pc (COMPUNIT_BLOCKVECTOR (cust), pc))
-    return cust;
+  while (iter->addr != NULL)
+    {
+      if (!debug_names_read_entry (iter->map, &iter->addr, &entry))
+	{
+	  iter->addr = NULL;
+	  break;
+	}
 
-  if (cust->includes == NULL)
-    return NULL;
+      if (entry.per_cu == NULL)
+	continue;
 
-  for (i = 0; cust->includes[i]; ++i)
-    {
-      struct compunit_symtab *s = cust->includes[i];
+      /* Skip if already read in.  */
+      if (entry.per_cu->v.quick->compunit_symtab)
+	continue;
 
-      s = recursively_find_pc_sect_compunit_symtab (s, pc);
-      if (s != NULL)
-	return s;
+      /* Check static vs global.  */
+      if (iter->want_specific_block
+	  && entry.is_static != -1
+	  && (iter->block_index != GLOBAL_BLOCK) != entry.is_static)
+	continue;
+
+      if (!dw2_symbol_kind_matches_domain (entry.symbol_kind, iter->domain))
+	continue;
+
+      return entry.per_cu;
     }
 
   return NULL;
 }
 
 static struct compunit_symtab *
-dw2_find_pc_sect_compunit_symtab (struct objfile *objfile,
-				  struct bound_minimal_symbol msymbol,
-				  CORE_ADDR pc,
-				  struct obj_section *section,
-				  int warn_if_readin)
+dw2_debug_names_lookup_symbol (struct objfile *objfile, int block_index,
+			       const char *name, domain_enum domain)
 {
-  struct dwarf2_per_cu_data *data;
-  struct compunit_symtab *result;
+  struct compunit_symtab *stab_best = NULL;
+  const struct mapped_debug_names *map;
+  struct dw2_debug_names_iterator iter;
+  struct dwarf2_per_cu_data *per_cu;
 
   dw2_setup (objfile);
 
-  if (!objfile->psymtabs_addrmap)
-    return NULL;
+  map = dwarf2_per_objfile->debug_names_table;
+  gdb_assert (map != NULL);
 
-  data = (struct dwarf2_per_cu_data *) addrmap_find (objfile->psymtabs_addrmap,
-						     pc);
-  if (!data)
-    return NULL;
+  dw2_debug_names_iter_init (&iter, map, 1, block_index, domain, name);
 
-  if (warn_if_readin && data->v.quick->compunit_symtab)
-    warning (_("(Internal error: pc %s in read in CU, but not in symtab.)"),
-	     paddress (get_objfile_arch (objfile), pc));
+  while ((per_cu = dw2_debug_names_iter_next (&iter)) != NULL)
+    {
+      struct compunit_symtab *stab
+	= dw2_lookup_symbol_in_cu (per_cu, block_index, name, domain,
+				   &stab_best);
 
-  result
-    = recursively_find_pc_sect_compunit_symtab (dw2_instantiate_symtab (data),
-						pc);
-  gdb_assert (result != NULL);
-  return result;
+      if (stab != NULL)
+	return stab;
+
+      /* Keep looking through other CUs.  */
+    }
+
+  return stab_best;
 }
 
+/* This dumps minimal information about .debug_names.  It is called
+   via "mt print objfiles".  */
+
 static void
-dw2_map_symbol_filenames (struct objfile *objfile, symbol_filename_ftype *fun,
-			  void *data, int need_fullname)
+dw2_debug_names_dump (struct objfile *objfile)
 {
-  int i;
-  htab_up visited (htab_create_alloc (10, htab_hash_pointer, htab_eq_pointer,
-				      NULL, xcalloc, xfree));
+  dw2_setup (objfile);
+  gdb_assert (dwarf2_per_objfile->using_index);
+  printf_filtered (".debug_names:");
+  if (dwarf2_per_objfile->debug_names_table != NULL)
+    printf_filtered (" exists\n");
+  else
+    printf_filtered (" faked for \"readnow\"\n");
+  printf_filtered ("\n");
+}
+
+static void
+dw2_debug_names_expand_symtabs_for_function (struct objfile *objfile,
+					     const char *func_name)
+{
+  struct dw2_debug_names_iterator iter;
+  struct dwarf2_per_cu_data *per_cu;
+  std::vector<struct dwarf2_per_cu_data *> units;
 
   dw2_setup (objfile);
 
-  /* The rule is CUs specify all the files, including those used by
-     any TU, so there's no need to scan TUs here.
-     We can ignore file names coming from already-expanded CUs.  */
+  /* Note: It doesn't matter what we pass for block_index here.  */
+  dw2_debug_names_iter_init (&iter, dwarf2_per_objfile->debug_names_table,
+			     0, GLOBAL_BLOCK, VAR_DOMAIN, func_name);
 
-  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
-    {
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+  while ((per_cu = dw2_debug_names_iter_next (&iter)) != NULL)
+    units.push_back (per_cu);
 
-      if (per_cu->v.quick->compunit_symtab)
-	{
-	  void **slot = htab_find_slot (visited.get (),
-					per_cu->v.quick->file_names,
-					INSERT);
+  dwarf2_preload_scope preload (units);
 
-	  *slot = per_cu->v.quick->file_names;
-	}
-    }
+  for (struct dwarf2_per_cu_data *unit : units)
+    dw2_instantiate_symtab (unit);
+}
 
-  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+static void
+dw2_debug_names_expand_symtabs_matching
+  (struct objfile *objfile,
+   gdb::function_view<expand_symtabs_file_matcher_ftype> file_matcher,
+   gdb::function_view<expand_symtabs_symbol_matcher_ftype> symbol_matcher,
+   gdb::function_view<expand_symtabs_exp_notify_ftype> expansion_notify,
+   enum search_domain kind)
+{
+  const struct mapped_debug_names *map;
+  ULONGEST namei;
+  std::vector<struct dwarf2_per_cu_data *> units;
+
+  dw2_setup (objfile);
+
+  map = dwarf2_per_objfile->debug_names_table;
+  gdb_assert (map != NULL);
+
+  dw2_expand_symtabs_matching_file_matcher (objfile, file_matcher);
+
+  for (namei = 0; namei < map->name_count; ++namei)
     {
-      int j;
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cu (i);
-      struct quick_file_names *file_data;
-      void **slot;
+      struct debug_names_entry entry;
+      const gdb_byte *addr;
+      const char *name;
 
-      /* We only need to look at symtabs not already expanded.  */
-      if (per_cu->v.quick->compunit_symtab)
-	continue;
+      QUIT;
 
-      file_data = dw2_get_file_names (per_cu);
-      if (file_data == NULL)
+      name = debug_names_namei_to_name (map, namei);
+      if (name == NULL || !symbol_matcher (name))
 	continue;
 
-      slot = htab_find_slot (visited.get (), file_data, INSERT);
-      if (*slot)
-	{
-	  /* Already visited.  */
-	  continue;
-	}
-      *slot = file_data;
-
-      for (j = 0; j < file_data->num_file_names; ++j)
+      /* The name was matched, now expand corresponding CUs that were
+	 marked.  */
+      addr = debug_names_namei_to_entries (map, namei);
+      while (addr != NULL && debug_names_read_entry (map, &addr, &entry))
 	{
-	  const char *this_real_name;
+	  if (entry.per_cu == NULL
+	      || !dw2_symbol_kind_matches_search (entry.symbol_kind, kind))
+	    continue;
 
-	  if (need_fullname)
-	    this_real_name = dw2_get_real_path (objfile, file_data, j);
-	  else
-	    this_real_name = NULL;
-	  (*fun) (file_data->file_names[j], this_real_name, data);
+	  dw2_add_matching_unit (&units, entry.per_cu, file_matcher != NULL);
 	}
     }
-}
 
-static int
-dw2_has_symbols (struct objfile *objfile)
-{
-  return 1;
+  dw2_expand_symtabs_matching_units (units, file_matcher, expansion_notify);
 }
 
-const struct quick_symbol_functions dwarf2_gdb_index_functions =
+const struct quick_symbol_functions dwarf2_debug_names_functions =
 {
   dw2_has_symbols,
   dw2_find_last_source_symtab,
   dw2_forget_cached_source_info,
   dw2_map_symtabs_matching_filename,
-  dw2_lookup_symbol,
+  dw2_debug_names_lookup_symbol,
   dw2_print_stats,
-  dw2_dump,
+  dw2_debug_names_dump,
   dw2_relocate,
-  dw2_expand_symtabs_for_function,
+  dw2_debug_names_expand_symtabs_for_function,
   dw2_expand_all_symtabs,
   dw2_expand_symtabs_with_fullname,
   dw2_map_matching_symbols,
-  dw2_expand_symtabs_matching,
+  dw2_debug_names_expand_symtabs_matching,
   dw2_find_pc_sect_compunit_symtab,
   dw2_map_symbol_filenames
 };
 
-/* Initialize for reading DWARF for this objfile.  Return 0 if this
-   file will use psymtabs, or 1 if using the GNU index.  */
+/* See symfile.h.  */
 
-int
-dwarf2_initialize_objfile (struct objfile *objfile)
+bool
+dwarf2_initialize_objfile (struct objfile *objfile,
+			   dw_index_kind *index_kind)
 {
   /* If we're about to read full symbols, don't bother with the
      indices.  In this case we also don't care if some other debug
@@ -4378,16 +5741,26 @@ dwarf2_initialize_objfile (struct objfile *objfile)
 					    struct dwarf2_per_cu_quick_data);
 	}
 
-      /* Return 1 so that gdb sees the "quick" functions.  However,
+      /* Return true so that gdb sees the "quick" functions.  However,
 	 these functions will be no-ops because we will have expanded
 	 all symtabs.  */
-      return 1;
+      *index_kind = dw_index_kind::GDB_INDEX;
+      return true;
+    }
+
+  if (dwarf2_read_debug_names (objfile))
+    {
+      *index_kind = dw_index_kind::DEBUG_NAMES;
+      return true;
     }
 
   if (dwarf2_read_index (objfile))
-    return 1;
+    {
+      *index_kind = dw_index_kind::GDB_INDEX;
+      return true;
+    }
 
-  return 0;
+  return false;
 }
 
 
@@ -4411,6 +5784,11 @@ dwarf2_build_psymtabs (struct objfile *objfile)
       psymtab_discarder psymtabs (objfile);
       dwarf2_build_psymtabs_hard (objfile);
       psymtabs.keep ();
+
+      /* Save an index so that the next session can skip all this.
+	 The index cache cannot describe dwz files.  */
+      if (dwarf2_per_objfile->dwz_file == NULL)
+	global_index_cache.store (objfile);
     }
   CATCH (except, RETURN_MASK_ERROR)
     {
@@ -6051,51 +7429,159 @@ get_type_unit_group (struct dwarf2_cu *cu, const struct attribute *stmt_list)
       ++tu_stats->nr_stmt_less_type_units;
     }
 
-  type_unit_group_for_lookup.hash.dwo_unit = cu->dwo_unit;
-  type_unit_group_for_lookup.hash.line_sect_off = (sect_offset) line_offset;
-  slot = htab_find_slot (dwarf2_per_objfile->type_unit_groups,
-			 &type_unit_group_for_lookup, INSERT);
-  if (*slot != NULL)
-    {
-      tu_group = (struct type_unit_group *) *slot;
-      gdb_assert (tu_group != NULL);
-    }
-  else
+  type_unit_group_for_lookup.hash.dwo_unit = cu->dwo_unit;
+  type_unit_group_for_lookup.hash.line_sect_off = (sect_offset) line_offset;
+  slot = htab_find_slot (dwarf2_per_objfile->type_unit_groups,
+			 &type_unit_group_for_lookup, INSERT);
+  if (*slot != NULL)
+    {
+      tu_group = (struct type_unit_group *) *slot;
+      gdb_assert (tu_group != NULL);
+    }
+  else
+    {
+      sect_offset line_offset_struct = (sect_offset) line_offset;
+      tu_group = create_type_unit_group (cu, line_offset_struct);
+      *slot = tu_group;
+      ++tu_stats->nr_symtabs;
+    }
+
+  return tu_group;
+}
+
+/* Partial symbol tables.  */
+
+/* Create a psymtab named NAME and assign it to PER_CU.
+
+   The caller must fill in the following details:
+   dirname, textlow, texthigh.  */
+
+static struct partial_symtab *
+create_partial_symtab (struct dwarf2_per_cu_data *per_cu, const char *name)
+{
+  struct objfile *objfile = per_cu->objfile;
+  struct partial_symtab *pst;
+
+  pst = start_psymtab_common (objfile, name, 0,
+			      objfile->global_psymbols.next,
+			      objfile->static_psymbols.next);
+
+  pst->psymtabs_addrmap_supported = 1;
+
+  /* This is the glue that links PST into GDB's symbol API.  */
+  pst->read_symtab_private = per_cu;
+  pst->read_symtab = dwarf2_read_symtab;
+  per_cu->v.psymtab = pst;
+
+  return pst;
+}
+
+/* A partial symbol that load_partial_dies would have added directly
+   while reading a CU in a worker thread.  Worker threads may not touch
+   the objfile's psymbol lists, so these are recorded here and added
+   by the main thread, in the same order, when it takes over the CU.  */
+
+struct prescan_psymbol
+{
+  /* The name, which needs canonicalizing if RAW_NAME is set.  */
+  const char *name;
+  unsigned int raw_name : 1;
+
+  /* Nonzero if the symbol goes in the global psymbol list.  */
+  unsigned int global : 1;
+
+  domain_enum domain;
+  enum address_class aclass;
+};
+
+/* The partial DIEs of a compilation unit, as read by a worker thread
+   ahead of dwarf2_build_psymtabs_hard.  This holds everything that
+   init_cutu_and_read_dies would pass to process_psymtab_comp_unit_reader,
+   plus the result of load_partial_dies.  */
+
+struct dwarf2_prescan
+{
+  /* The CU.  It is not linked to its per_cu, nor in the read_in_chain,
+     until the main thread takes it over.  */
+  struct dwarf2_cu *cu;
+
+  struct die_reader_specs reader;
+  struct die_info *comp_unit_die;
+  int has_children;
+
+  /* Pointer to the first child of COMP_UNIT_DIE.  */
+  const gdb_byte *info_ptr;
+
+  /* The result of load_partial_dies, if HAS_CHILDREN.  */
+  struct partial_die_info *first_die;
+
+  /* Symbols to add before calling scan_partial_symbols.  */
+  std::vector<prescan_psymbol> psymbols;
+};
+
+/* Free PRESCAN, including its CU.  */
+
+static void
+dwarf2_free_prescan (struct dwarf2_prescan *prescan)
+{
+  struct dwarf2_cu *cu = prescan->cu;
+
+  dwarf2_free_abbrev_table (cu);
+  obstack_free (&cu->comp_unit_obstack, NULL);
+  xfree (cu);
+  delete prescan;
+}
+
+/* Canonicalize the names of PDI, its siblings and their children that
+   were left alone by a worker thread.  */
+
+static void
+canonicalize_prescan_names (struct partial_die_info *pdi,
+			    struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+
+  for (; pdi != NULL; pdi = pdi->die_sibling)
     {
-      sect_offset line_offset_struct = (sect_offset) line_offset;
-      tu_group = create_type_unit_group (cu, line_offset_struct);
-      *slot = tu_group;
-      ++tu_stats->nr_symtabs;
+      if (pdi->raw_name)
+	{
+	  pdi->name
+	    = dwarf2_canonicalize_name (pdi->name, cu,
+					&objfile->per_bfd->storage_obstack);
+	  pdi->raw_name = 0;
+	}
+      canonicalize_prescan_names (pdi->die_child, cu);
     }
-
-  return tu_group;
 }
-
-/* Partial symbol tables.  */
-
-/* Create a psymtab named NAME and assign it to PER_CU.
 
-   The caller must fill in the following details:
-   dirname, textlow, texthigh.  */
+/* Do the parts of load_partial_dies that a worker thread left to the
+   main thread for PRESCAN, whose CU has been taken over by now, and
+   return the first partial DIE.  */
 
-static struct partial_symtab *
-create_partial_symtab (struct dwarf2_per_cu_data *per_cu, const char *name)
+static struct partial_die_info *
+finish_prescan (struct dwarf2_prescan *prescan)
 {
-  struct objfile *objfile = per_cu->objfile;
-  struct partial_symtab *pst;
+  struct dwarf2_cu *cu = prescan->cu;
+  struct objfile *objfile = cu->objfile;
 
-  pst = start_psymtab_common (objfile, name, 0,
-			      objfile->global_psymbols.next,
-			      objfile->static_psymbols.next);
+  for (const prescan_psymbol &psym : prescan->psymbols)
+    {
+      const char *name = psym.name;
 
-  pst->psymtabs_addrmap_supported = 1;
+      if (psym.raw_name)
+	name = dwarf2_canonicalize_name (name, cu,
+					 &objfile->per_bfd->storage_obstack);
+      add_psymbol_to_list (name, strlen (name), 0,
+			   psym.domain, psym.aclass,
+			   psym.global
+			   ? &objfile->global_psymbols
+			   : &objfile->static_psymbols,
+			   0, cu->language, objfile);
+    }
 
-  /* This is the glue that links PST into GDB's symbol API.  */
-  pst->read_symtab_private = per_cu;
-  pst->read_symtab = dwarf2_read_symtab;
-  per_cu->v.psymtab = pst;
+  canonicalize_prescan_names (prescan->first_die, cu);
 
-  return pst;
+  return prescan->first_die;
 }
 
 /* The DATA object passed to process_psymtab_comp_unit_reader has this
@@ -6111,6 +7597,10 @@ struct process_psymtab_comp_unit_data
      language.  */
 
   enum language pretend_language;
+
+  /* If the CU was read by a worker thread, the result.  */
+
+  struct dwarf2_prescan *prescan;
 };
 
 /* die_reader_func for process_psymtab_comp_unit.  */
@@ -6182,7 +7672,10 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
       lowpc = ((CORE_ADDR) -1);
       highpc = ((CORE_ADDR) 0);
 
-      first_die = load_partial_dies (reader, info_ptr, 1);
+      if (info->prescan != NULL)
+	first_die = finish_prescan (info->prescan);
+      else
+	first_die = load_partial_dies (reader, info_ptr, 1);
 
       scan_partial_symbols (first_die, &lowpc, &highpc,
 			    cu_bounds_kind <= PC_BOUNDS_INVALID, cu);
@@ -6244,13 +7737,59 @@ process_psymtab_comp_unit_reader (const struct die_reader_specs *reader,
     }
 }
 
+/* Cleanup function to delete a struct dwarf2_prescan, but not its
+   CU.  */
+
+static void
+delete_prescan_cleanup (void *arg)
+{
+  delete (struct dwarf2_prescan *) arg;
+}
+
+/* Subroutine of process_psymtab_comp_unit.  Take over the CU that a
+   worker thread read for THIS_CU into PRESCAN, and pass it to
+   process_psymtab_comp_unit_reader as init_cutu_and_read_dies would
+   have.  PRESCAN is freed.  */
+
+static void
+process_prescanned_comp_unit (struct dwarf2_per_cu_data *this_cu,
+			      struct dwarf2_prescan *prescan,
+			      process_psymtab_comp_unit_data *info)
+{
+  struct dwarf2_cu *cu = prescan->cu;
+  struct cleanup *cleanups;
+
+  gdb_assert (this_cu->cu == NULL);
+  gdb_assert (this_cu->sect_off == cu->header.sect_off);
+  gdb_assert (this_cu->length == get_cu_length (&cu->header));
+
+  cleanups = make_cleanup (delete_prescan_cleanup, prescan);
+  make_cleanup (free_heap_comp_unit, cu);
+  make_cleanup (dwarf2_free_abbrev_table, cu);
+
+  this_cu->cu = cu;
+  this_cu->dwarf_version = cu->header.version;
+  cu->per_cu = this_cu;
+  cu->prescan = NULL;
+
+  info->prescan = prescan;
+  process_psymtab_comp_unit_reader (&prescan->reader, prescan->info_ptr,
+				    prescan->comp_unit_die,
+				    prescan->has_children, info);
+
+  do_cleanups (cleanups);
+}
+
 /* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
-   Process compilation unit THIS_CU for a psymtab.  */
+   Process compilation unit THIS_CU for a psymtab.  If PRESCAN is not
+   NULL, it holds the partial DIEs of THIS_CU as read by a worker
+   thread; it is freed.  */
 
 static void
 process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
 			   int want_partial_unit,
-			   enum language pretend_language)
+			   enum language pretend_language,
+			   struct dwarf2_prescan *prescan)
 {
   /* If this compilation unit was already read in, free the
      cached copy in order to read it in again.	This is
@@ -6260,6 +7799,14 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
   if (this_cu->cu != NULL)
     free_one_cached_comp_unit (this_cu);
 
+  /* The same goes for a CU read by a worker thread, if reading an
+     earlier CU found that we need all of its DIEs.  */
+  if (prescan != NULL && this_cu->load_all_dies)
+    {
+      dwarf2_free_prescan (prescan);
+      prescan = NULL;
+    }
+
   if (this_cu->is_debug_types)
     init_cutu_and_read_dies (this_cu, NULL, 0, 0, build_type_psymtabs_reader,
 			     NULL);
@@ -6268,8 +7815,12 @@ process_psymtab_comp_unit (struct dwarf2_per_cu_data *this_cu,
       process_psymtab_comp_unit_data info;
       info.want_partial_unit = want_partial_unit;
       info.pretend_language = pretend_language;
-      init_cutu_and_read_dies (this_cu, NULL, 0, 0,
-			       process_psymtab_comp_unit_reader, &info);
+      info.prescan = NULL;
+      if (prescan != NULL)
+	process_prescanned_comp_unit (this_cu, prescan, &info);
+      else
+	init_cutu_and_read_dies (this_cu, NULL, 0, 0,
+				 process_psymtab_comp_unit_reader, &info);
     }
 
   /* Age out any secondary CUs.  */
@@ -6500,130 +8051,519 @@ build_type_psymtab_dependencies (void **slot, void *info)
       iter->type_unit_group = tu_group;
     }
 
-  VEC_free (sig_type_ptr, tu_group->tus);
+  VEC_free (sig_type_ptr, tu_group->tus);
+
+  return 1;
+}
+
+/* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
+   Build partial symbol tables for the .debug_types comp-units.  */
+
+static void
+build_type_psymtabs (struct objfile *objfile)
+{
+  if (! create_all_type_units (objfile))
+    return;
+
+  build_type_psymtabs_1 ();
+}
+
+/* Traversal function for process_skeletonless_type_unit.
+   Read a TU in a DWO file and build partial symbols for it.  */
+
+static int
+process_skeletonless_type_unit (void **slot, void *info)
+{
+  struct dwo_unit *dwo_unit = (struct dwo_unit *) *slot;
+  struct objfile *objfile = (struct objfile *) info;
+  struct signatured_type find_entry, *entry;
+
+  /* If this TU doesn't exist in the global table, add it and read it in.  */
+
+  if (dwarf2_per_objfile->signatured_types == NULL)
+    {
+      dwarf2_per_objfile->signatured_types
+	= allocate_signatured_type_table (objfile);
+    }
+
+  find_entry.signature = dwo_unit->signature;
+  slot = htab_find_slot (dwarf2_per_objfile->signatured_types, &find_entry,
+			 INSERT);
+  /* If we've already seen this type there's nothing to do.  What's happening
+     is we're doing our own version of comdat-folding here.  */
+  if (*slot != NULL)
+    return 1;
+
+  /* This does the job that create_all_type_units would have done for
+     this TU.  */
+  entry = add_type_unit (dwo_unit->signature, slot);
+  fill_in_sig_entry_from_dwo_entry (objfile, entry, dwo_unit);
+  *slot = entry;
+
+  /* This does the job that build_type_psymtabs_1 would have done.  */
+  init_cutu_and_read_dies (&entry->per_cu, NULL, 0, 0,
+			   build_type_psymtabs_reader, NULL);
+
+  return 1;
+}
+
+/* Traversal function for process_skeletonless_type_units.  */
+
+static int
+process_dwo_file_for_skeletonless_type_units (void **slot, void *info)
+{
+  struct dwo_file *dwo_file = (struct dwo_file *) *slot;
+
+  if (dwo_file->tus != NULL)
+    {
+      htab_traverse_noresize (dwo_file->tus,
+			      process_skeletonless_type_unit, info);
+    }
+
+  return 1;
+}
+
+/* Scan all TUs of DWO files, verifying we've processed them.
+   This is needed in case a TU was emitted without its skeleton.
+   Note: This can't be done until we know what all the DWO files are.  */
+
+static void
+process_skeletonless_type_units (struct objfile *objfile)
+{
+  /* Skeletonless TUs in DWP files without .gdb_index is not supported yet.  */
+  if (get_dwp_file () == NULL
+      && dwarf2_per_objfile->dwo_files != NULL)
+    {
+      htab_traverse_noresize (dwarf2_per_objfile->dwo_files,
+			      process_dwo_file_for_skeletonless_type_units,
+			      objfile);
+    }
+}
+
+/* A cleanup function that clears objfile's psymtabs_addrmap field.  */
+
+static void
+psymtabs_addrmap_cleanup (void *o)
+{
+  struct objfile *objfile = (struct objfile *) o;
+
+  objfile->psymtabs_addrmap = NULL;
+}
+
+/* Compute the 'user' field for each psymtab in OBJFILE.  */
+
+static void
+set_partial_user (struct objfile *objfile)
+{
+  int i;
+
+  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+    {
+      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+      struct partial_symtab *pst = per_cu->v.psymtab;
+      int j;
+
+      if (pst == NULL)
+	continue;
+
+      for (j = 0; j < pst->number_of_dependencies; ++j)
+	{
+	  /* Set the 'user' field only if it is not already set.  */
+	  if (pst->dependencies[j]->user == NULL)
+	    pst->dependencies[j]->user = pst;
+	}
+    }
+}
+
+#ifdef CXX_STD_THREAD
+
+/* Return nonzero if the CU whose abbrevs are ABBREV_TABLE can be read
+   by a worker thread.  Some forms need state that only the main thread
+   may touch: DWO sections, or a dwz file that has not been opened.  */
+
+static int
+prescan_abbrevs_ok (const struct abbrev_table *abbrev_table)
+{
+  unsigned int i, j;
+
+  for (i = 0; i < ABBREV_HASH_SIZE; ++i)
+    {
+      const struct abbrev_info *abbrev;
+
+      for (abbrev = abbrev_table->abbrevs[i];
+	   abbrev != NULL;
+	   abbrev = abbrev->next)
+	for (j = 0; j < abbrev->num_attrs; ++j)
+	  switch (abbrev->attrs[j].form)
+	    {
+	    case DW_FORM_indirect:
+	    case DW_FORM_GNU_addr_index:
+	    case DW_FORM_GNU_str_index:
+	    case DW_FORM_addrx:
+	    case DW_FORM_strx:
+	      return 0;
+	    case DW_FORM_GNU_ref_alt:
+	    case DW_FORM_GNU_strp_alt:
+	      if (dwarf2_per_objfile->dwz_file == NULL)
+		return 0;
+	      break;
+	    default:
+	      break;
+	    }
+    }
+
+  return 1;
+}
+
+/* Read the partial DIEs of compilation unit PER_CU, which is a private
+   copy of the real one, as process_psymtab_comp_unit would.  This runs
+   in a worker thread, so it only reads the DIEs: it does not create
+   symbols, canonicalize C++ names, or change anything outside the new
+   CU.  Return NULL if the CU has to be read by the main thread
+   instead; this is the case for anything unusual, including any CU
+   that provokes a complaint or an error, so that those are still
+   reported by the main thread in the usual order.  */
+
+static struct dwarf2_prescan *
+dwarf2_prescan_comp_unit (struct dwarf2_per_cu_data *per_cu)
+{
+  struct dwarf2_section_info *section = per_cu->section;
+  struct dwarf2_section_info *abbrev_section
+    = get_abbrev_section_for_cu (per_cu);
+  bfd *abfd = get_section_bfd_owner (section);
+  struct dwarf2_prescan *prescan = new struct dwarf2_prescan ();
+  struct dwarf2_cu *cu = XNEW (struct dwarf2_cu);
+  complaint_interceptor interceptor;
+  int ok = 0;
+
+  memset (cu, 0, sizeof (*cu));
+  cu->per_cu = per_cu;
+  cu->objfile = per_cu->objfile;
+  cu->prescan = prescan;
+  obstack_init (&cu->comp_unit_obstack);
+  prescan->cu = cu;
+
+  TRY
+    {
+      const gdb_byte *begin_info_ptr, *info_ptr;
+      struct die_info *comp_unit_die;
+
+      begin_info_ptr = section->buffer + to_underlying (per_cu->sect_off);
+      info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+						abbrev_section,
+						begin_info_ptr,
+						rcuh_kind::COMPILE);
+
+      if (info_ptr < begin_info_ptr + per_cu->length
+	  && peek_abbrev_code (abfd, info_ptr) != 0)
+	{
+	  dwarf2_read_abbrevs (cu, abbrev_section);
+	  if (prescan_abbrevs_ok (cu->abbrev_table))
+	    {
+	      init_cu_die_reader (&prescan->reader, cu, section, NULL);
+	      info_ptr = read_full_die (&prescan->reader, &comp_unit_die,
+					info_ptr, &prescan->has_children);
+	      prescan->comp_unit_die = comp_unit_die;
+	      prescan->info_ptr = info_ptr;
+
+	      /* dwarf2_attr follows DW_AT_specification and
+		 DW_AT_abstract_origin, which could lead to another
+		 CU.  */
+	      if (comp_unit_die->tag == DW_TAG_compile_unit
+		  && (dwarf2_attr_no_follow (comp_unit_die,
+					     DW_AT_GNU_dwo_name) == NULL)
+		  && (dwarf2_attr_no_follow (comp_unit_die,
+					     DW_AT_specification) == NULL)
+		  && (dwarf2_attr_no_follow (comp_unit_die,
+					     DW_AT_abstract_origin) == NULL))
+		{
+		  prepare_one_comp_unit (cu, comp_unit_die, language_minimal);
+		  if (prescan->has_children)
+		    prescan->first_die = load_partial_dies (&prescan->reader,
+							    info_ptr, 1);
+		  ok = 1;
+		}
+	    }
+	}
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      ok = 0;
+    }
+  END_CATCH
+
+  if (!ok || interceptor.complained ())
+    {
+      dwarf2_free_prescan (prescan);
+      return NULL;
+    }
+
+  return prescan;
+}
+
+/* A pool of worker threads that read a list of units ahead of the main
+   thread.  Each worker calls READER on a private copy of a unit's
+   per_cu, since the main thread updates the real ones as it goes, and
+   READER returns a T, or NULL if the main thread has to read the unit
+   itself.  Workers start on the units in list order, staying a bounded
+   distance ahead of the units the main thread has taken.  */
+
+template<typename T>
+class dwarf2_unit_pool
+{
+public:
+
+  typedef T *(reader_ftype) (struct dwarf2_per_cu_data *per_cu);
+  typedef void (free_result_ftype) (T *result);
+
+  /* Start N_THREADS workers reading UNITS of OBJFILE with READER.
+     FREE_RESULT frees the results the main thread does not take.  */
+  dwarf2_unit_pool (struct objfile *objfile,
+		    const std::vector<struct dwarf2_per_cu_data *> &units,
+		    int n_threads, reader_ftype *reader,
+		    free_result_ftype *free_result);
+  ~dwarf2_unit_pool ();
+
+  /* Return the result for unit INDEX of the list, waiting for it if
+     necessary.  Return NULL if the main thread should read the unit
+     itself, either because a worker could not, or because no worker
+     has started on it yet.  Each result can only be taken once.  */
+  T *take (int index);
+
+  /* Return the index of PER_CU in the list, or -1 if it is not
+     there.  */
+  int find (struct dwarf2_per_cu_data *per_cu) const
+  {
+    auto iter = m_index.find (per_cu);
+
+    return iter == m_index.end () ? -1 : iter->second;
+  }
+
+private:
+
+  void worker ();
+
+  enum unit_state : char
+  {
+    /* Nobody has started on the unit.  */
+    PENDING,
+    /* A worker is reading the unit.  */
+    STARTED,
+    /* The result is ready.  */
+    DONE,
+    /* The main thread has taken the result, or is reading the unit
+       itself.  */
+    TAKEN
+  };
+
+  reader_ftype *m_reader;
+  free_result_ftype *m_free_result;
 
-  return 1;
-}
+  /* The dwarf2_per_objfile global of the main thread, which the
+     workers use too.  */
+  struct dwarf2_per_objfile *m_per_objfile;
 
-/* Subroutine of dwarf2_build_psymtabs_hard to simplify it.
-   Build partial symbol tables for the .debug_types comp-units.  */
+  /* Private copies of the per_cu objects, and a map from the real
+     ones to their index.  */
+  std::vector<struct dwarf2_per_cu_data> m_per_cus;
+  std::unordered_map<struct dwarf2_per_cu_data *, int> m_index;
 
-static void
-build_type_psymtabs (struct objfile *objfile)
-{
-  if (! create_all_type_units (objfile))
-    return;
+  /* The results, and the state of each unit.  */
+  std::vector<T *> m_results;
+  std::vector<unit_state> m_state;
 
-  build_type_psymtabs_1 ();
-}
+  /* No unit before this one is PENDING.  */
+  int m_next;
 
-/* Traversal function for process_skeletonless_type_unit.
-   Read a TU in a DWO file and build partial symbols for it.  */
+  /* One more than the highest index the main thread has asked for.
+     Workers do not start a unit more than M_WINDOW ahead of this, to
+     bound the memory used by results.  */
+  int m_taken;
+  int m_window;
 
-static int
-process_skeletonless_type_unit (void **slot, void *info)
-{
-  struct dwo_unit *dwo_unit = (struct dwo_unit *) *slot;
-  struct objfile *objfile = (struct objfile *) info;
-  struct signatured_type find_entry, *entry;
+  /* Set when the workers should exit.  */
+  bool m_stop;
 
-  /* If this TU doesn't exist in the global table, add it and read it in.  */
+  std::mutex m_mutex;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+  std::vector<std::thread> m_threads;
+};
 
-  if (dwarf2_per_objfile->signatured_types == NULL)
+template<typename T>
+dwarf2_unit_pool<T>::dwarf2_unit_pool
+  (struct objfile *objfile,
+   const std::vector<struct dwarf2_per_cu_data *> &units,
+   int n_threads, reader_ftype *reader, free_result_ftype *free_result)
+  : m_reader (reader),
+    m_free_result (free_result),
+    m_per_objfile (dwarf2_per_objfile),
+    m_next (0),
+    m_taken (0),
+    m_window (n_threads * 4),
+    m_stop (false)
+{
+  int i, n_units = units.size ();
+
+  /* Read in every section a worker might need, since
+     dwarf2_read_section may only be called by the main thread.  */
+  m_per_cus.reserve (n_units);
+  for (i = 0; i < n_units; ++i)
+    {
+      struct dwarf2_per_cu_data *per_cu = units[i];
+
+      dwarf2_read_section (objfile, per_cu->section);
+      dwarf2_read_section (objfile, get_abbrev_section_for_cu (per_cu));
+      m_per_cus.push_back (*per_cu);
+      m_index.emplace (per_cu, i);
+    }
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->str);
+  dwarf2_read_section (objfile, &dwarf2_per_objfile->line_str);
+  if (dwarf2_per_objfile->dwz_file != NULL)
+    dwarf2_read_section (objfile, &dwarf2_per_objfile->dwz_file->str);
+
+  m_results.resize (n_units, NULL);
+  m_state.resize (n_units, PENDING);
+
+  /* Signals should be handled by the main thread, so block them all
+     while the workers inherit our mask.  */
+#ifdef HAVE_SIGPROCMASK
+  sigset_t all_signals, old_mask;
+
+  sigfillset (&all_signals);
+  sigprocmask (SIG_BLOCK, &all_signals, &old_mask);
+#endif
+
+  for (i = 0; i < n_threads; ++i)
     {
-      dwarf2_per_objfile->signatured_types
-	= allocate_signatured_type_table (objfile);
+      try
+	{
+	  m_threads.emplace_back ([this] () { worker (); });
+	}
+      catch (const std::system_error &)
+	{
+	  /* Make do with the threads we have.  */
+	  break;
+	}
     }
 
-  find_entry.signature = dwo_unit->signature;
-  slot = htab_find_slot (dwarf2_per_objfile->signatured_types, &find_entry,
-			 INSERT);
-  /* If we've already seen this type there's nothing to do.  What's happening
-     is we're doing our own version of comdat-folding here.  */
-  if (*slot != NULL)
-    return 1;
+#ifdef HAVE_SIGPROCMASK
+  sigprocmask (SIG_SETMASK, &old_mask, NULL);
+#endif
+}
 
-  /* This does the job that create_all_type_units would have done for
-     this TU.  */
-  entry = add_type_unit (dwo_unit->signature, slot);
-  fill_in_sig_entry_from_dwo_entry (objfile, entry, dwo_unit);
-  *slot = entry;
+template<typename T>
+dwarf2_unit_pool<T>::~dwarf2_unit_pool ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
 
-  /* This does the job that build_type_psymtabs_1 would have done.  */
-  init_cutu_and_read_dies (&entry->per_cu, NULL, 0, 0,
-			   build_type_psymtabs_reader, NULL);
+    m_stop = true;
+  }
+  m_work_cv.notify_all ();
 
-  return 1;
-}
+  for (std::thread &thread : m_threads)
+    thread.join ();
 
-/* Traversal function for process_skeletonless_type_units.  */
+  for (T *result : m_results)
+    if (result != NULL)
+      m_free_result (result);
+}
 
-static int
-process_dwo_file_for_skeletonless_type_units (void **slot, void *info)
+template<typename T>
+T *
+dwarf2_unit_pool<T>::take (int index)
 {
-  struct dwo_file *dwo_file = (struct dwo_file *) *slot;
+  std::unique_lock<std::mutex> lock (m_mutex);
+  T *result = NULL;
 
-  if (dwo_file->tus != NULL)
+  if (index >= m_taken)
+    m_taken = index + 1;
+
+  switch (m_state[index])
     {
-      htab_traverse_noresize (dwo_file->tus,
-			      process_skeletonless_type_unit, info);
+    case PENDING:
+      /* Nobody has started on this one; the main thread is faster at
+	 reading it than waiting would be.  */
+      m_state[index] = TAKEN;
+      break;
+
+    case STARTED:
+    case DONE:
+      while (m_state[index] != DONE)
+	m_done_cv.wait (lock);
+      result = m_results[index];
+      m_results[index] = NULL;
+      m_state[index] = TAKEN;
+      break;
+
+    case TAKEN:
+      break;
     }
 
-  return 1;
-}
+  m_work_cv.notify_all ();
 
-/* Scan all TUs of DWO files, verifying we've processed them.
-   This is needed in case a TU was emitted without its skeleton.
-   Note: This can't be done until we know what all the DWO files are.  */
+  return result;
+}
 
-static void
-process_skeletonless_type_units (struct objfile *objfile)
+template<typename T>
+void
+dwarf2_unit_pool<T>::worker ()
 {
-  /* Skeletonless TUs in DWP files without .gdb_index is not supported yet.  */
-  if (get_dwp_file () == NULL
-      && dwarf2_per_objfile->dwo_files != NULL)
+  std::unique_lock<std::mutex> lock (m_mutex);
+  int n_units = m_per_cus.size ();
+
+  dwarf2_per_objfile = m_per_objfile;
+
+  while (1)
     {
-      htab_traverse_noresize (dwarf2_per_objfile->dwo_files,
-			      process_dwo_file_for_skeletonless_type_units,
-			      objfile);
-    }
-}
+      int index;
+      T *result;
 
-/* A cleanup function that clears objfile's psymtabs_addrmap field.  */
+      while (m_next < n_units && m_state[m_next] != PENDING)
+	++m_next;
+      if (m_stop || m_next >= n_units)
+	return;
+      if (m_next >= m_taken + m_window)
+	{
+	  m_work_cv.wait (lock);
+	  continue;
+	}
 
-static void
-psymtabs_addrmap_cleanup (void *o)
-{
-  struct objfile *objfile = (struct objfile *) o;
+      index = m_next++;
+      m_state[index] = STARTED;
+      lock.unlock ();
+      result = m_reader (&m_per_cus[index]);
+      lock.lock ();
 
-  objfile->psymtabs_addrmap = NULL;
+      m_results[index] = result;
+      m_state[index] = DONE;
+      m_done_cv.notify_all ();
+    }
 }
 
-/* Compute the 'user' field for each psymtab in OBJFILE.  */
+/* Return the number of worker threads to use for reading N_UNITS units
+   of dwarf2_per_objfile, given the user's SETTING, or zero to read them
+   all on the main thread.  */
 
-static void
-set_partial_user (struct objfile *objfile)
+static int
+dwarf2_worker_thread_count (int setting, int n_units)
 {
-  int i;
+  int n_threads = setting;
 
-  for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
-    {
-      struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
-      struct partial_symtab *pst = per_cu->v.psymtab;
-      int j;
+  /* The debugging output would be interleaved.  */
+  if (dwarf_read_debug || dwarf_die_debug)
+    return 0;
 
-      if (pst == NULL)
-	continue;
+  if (n_threads < 0)
+    n_threads = std::thread::hardware_concurrency ();
+  if (n_threads > n_units - 1)
+    n_threads = n_units - 1;
 
-      for (j = 0; j < pst->number_of_dependencies; ++j)
-	{
-	  /* Set the 'user' field only if it is not already set.  */
-	  if (pst->dependencies[j]->user == NULL)
-	    pst->dependencies[j]->user = pst;
-	}
-    }
+  return n_threads;
 }
 
+#endif /* CXX_STD_THREAD */
 /* Build the partial symbol table by doing a quick pass through the
    .debug_info and .debug_abbrev sections.  */
 
@@ -6633,6 +8573,10 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
   struct cleanup *back_to, *addrmap_cleanup;
   struct obstack temp_obstack;
   int i;
+#ifdef CXX_STD_THREAD
+  std::unique_ptr<dwarf2_unit_pool<dwarf2_prescan>> pool;
+  int n_threads;
+#endif
 
   if (dwarf_read_debug)
     {
@@ -6659,13 +8603,38 @@ dwarf2_build_psymtabs_hard (struct objfile *objfile)
   objfile->psymtabs_addrmap = addrmap_create_mutable (&temp_obstack);
   addrmap_cleanup = make_cleanup (psymtabs_addrmap_cleanup, objfile);
 
+#ifdef CXX_STD_THREAD
+  n_threads = dwarf2_worker_thread_count (dwarf_psymtab_threads,
+					  dwarf2_per_objfile->n_comp_units);
+  if (n_threads > 0)
+    {
+      std::vector<struct dwarf2_per_cu_data *> units;
+
+      for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
+	units.push_back (dw2_get_cutu (i));
+      pool.reset (new dwarf2_unit_pool<dwarf2_prescan>
+		  (objfile, units, n_threads, dwarf2_prescan_comp_unit,
+		   dwarf2_free_prescan));
+    }
+#endif
+
   for (i = 0; i < dwarf2_per_objfile->n_comp_units; ++i)
     {
       struct dwarf2_per_cu_data *per_cu = dw2_get_cutu (i);
+      struct dwarf2_prescan *prescan = NULL;
+
+#ifdef CXX_STD_THREAD
+      if (pool != NULL)
+	prescan = pool->take (i);
+#endif
 
-      process_psymtab_comp_unit (per_cu, 0, language_minimal);
+      process_psymtab_comp_unit (per_cu, 0, language_minimal, prescan);
     }
 
+#ifdef CXX_STD_THREAD
+  pool.reset ();
+#endif
+
   /* This has to wait until we read the CUs, we need the list of DWOs.  */
   process_skeletonless_type_units (objfile);
 
@@ -6722,6 +8691,48 @@ load_partial_comp_unit (struct dwarf2_per_cu_data *this_cu)
 			   load_partial_comp_unit_reader, NULL);
 }
 
+/* Read the header of the unit at SECT_OFF in SECTION, which must
+   already have been read in, and create its dwarf2_per_cu_data.
+   Throws an error if the header is invalid.  */
+
+static struct dwarf2_per_cu_data *
+create_per_cu_for_unit (struct objfile *objfile,
+			struct dwarf2_section_info *section,
+			struct dwarf2_section_info *abbrev_section,
+			unsigned int is_dwz, sect_offset sect_off)
+{
+  struct dwarf2_per_cu_data *this_cu;
+  comp_unit_head cu_header;
+
+  read_and_check_comp_unit_head (&cu_header, section, abbrev_section,
+				 section->buffer + to_underlying (sect_off),
+				 rcuh_kind::COMPILE);
+
+  if (cu_header.unit_type != DW_UT_type)
+    {
+      this_cu = XOBNEW (&objfile->objfile_obstack,
+			struct dwarf2_per_cu_data);
+      memset (this_cu, 0, sizeof (*this_cu));
+    }
+  else
+    {
+      auto sig_type = XOBNEW (&objfile->objfile_obstack,
+			      struct signatured_type);
+      memset (sig_type, 0, sizeof (*sig_type));
+      sig_type->signature = cu_header.signature;
+      sig_type->type_offset_in_tu = cu_header.type_cu_offset_in_tu;
+      this_cu = &sig_type->per_cu;
+    }
+  this_cu->is_debug_types = (cu_header.unit_type == DW_UT_type);
+  this_cu->sect_off = sect_off;
+  this_cu->length = cu_header.length + cu_header.initial_length_size;
+  this_cu->is_dwz = is_dwz;
+  this_cu->objfile = objfile;
+  this_cu->section = section;
+
+  return this_cu;
+}
+
 static void
 read_comp_units_from_section (struct objfile *objfile,
 			      struct dwarf2_section_info *section,
@@ -6732,7 +8743,6 @@ read_comp_units_from_section (struct objfile *objfile,
 			      struct dwarf2_per_cu_data ***all_comp_units)
 {
   const gdb_byte *info_ptr;
-  bfd *abfd = get_section_bfd_owner (section);
 
   if (dwarf_read_debug)
     fprintf_unfiltered (gdb_stdlog, "Reading %s for %s\n",
@@ -6745,36 +8755,12 @@ read_comp_units_from_section (struct objfile *objfile,
 
   while (info_ptr < section->buffer + section->size)
     {
-      struct dwarf2_per_cu_data *this_cu;
-
       sect_offset sect_off = (sect_offset) (info_ptr - section->buffer);
 
-      comp_unit_head cu_header;
-      read_and_check_comp_unit_head (&cu_header, section, abbrev_section,
-				     info_ptr, rcuh_kind::COMPILE);
-
       /* Save the compilation unit for later lookup.  */
-      if (cu_header.unit_type != DW_UT_type)
-	{
-	  this_cu = XOBNEW (&objfile->objfile_obstack,
-			    struct dwarf2_per_cu_data);
-	  memset (this_cu, 0, sizeof (*this_cu));
-	}
-      else
-	{
-	  auto sig_type = XOBNEW (&objfile->objfile_obstack,
-				  struct signatured_type);
-	  memset (sig_type, 0, sizeof (*sig_type));
-	  sig_type->signature = cu_header.signature;
-	  sig_type->type_offset_in_tu = cu_header.type_cu_offset_in_tu;
-	  this_cu = &sig_type->per_cu;
-	}
-      this_cu->is_debug_types = (cu_header.unit_type == DW_UT_type);
-      this_cu->sect_off = sect_off;
-      this_cu->length = cu_header.length + cu_header.initial_length_size;
-      this_cu->is_dwz = is_dwz;
-      this_cu->objfile = objfile;
-      this_cu->section = section;
+      struct dwarf2_per_cu_data *this_cu
+	= create_per_cu_for_unit (objfile, section, abbrev_section, is_dwz,
+				  sect_off);
 
       if (*n_comp_units == *n_allocated)
 	{
@@ -6913,7 +8899,7 @@ scan_partial_symbols (struct partial_die_info *first_die, CORE_ADDR *lowpc,
 
 		/* Go read the partial unit, if needed.  */
 		if (per_cu->v.psymtab == NULL)
-		  process_psymtab_comp_unit (per_cu, 1, cu->language);
+		  process_psymtab_comp_unit (per_cu, 1, cu->language, NULL);
 
 		VEC_safe_push (dwarf2_per_cu_ptr,
 			       cu->per_cu->imported_symtabs, per_cu);
@@ -7877,58 +9863,220 @@ die_hash (const void *item)
 {
   const struct die_info *die = (const struct die_info *) item;
 
-  return to_underlying (die->sect_off);
+  return to_underlying (die->sect_off);
+}
+
+/* Trivial comparison function for die_info structures: two DIEs
+   are equal if they have the same offset.  */
+
+static int
+die_eq (const void *item_lhs, const void *item_rhs)
+{
+  const struct die_info *die_lhs = (const struct die_info *) item_lhs;
+  const struct die_info *die_rhs = (const struct die_info *) item_rhs;
+
+  return die_lhs->sect_off == die_rhs->sect_off;
+}
+
+/* die_reader_func for load_full_comp_unit.
+   This is identical to read_signatured_type_reader,
+   but is kept separate for now.  */
+
+static void
+load_full_comp_unit_reader (const struct die_reader_specs *reader,
+			    const gdb_byte *info_ptr,
+			    struct die_info *comp_unit_die,
+			    int has_children,
+			    void *data)
+{
+  struct dwarf2_cu *cu = reader->cu;
+  enum language *language_ptr = (enum language *) data;
+
+  gdb_assert (cu->die_hash == NULL);
+  cu->die_hash =
+    htab_create_alloc_ex (cu->header.length / 12,
+			  die_hash,
+			  die_eq,
+			  NULL,
+			  &cu->comp_unit_obstack,
+			  hashtab_obstack_allocate,
+			  dummy_obstack_deallocate);
+
+  if (has_children)
+    comp_unit_die->child = read_die_and_siblings (reader, info_ptr,
+						  &info_ptr, comp_unit_die);
+  cu->dies = comp_unit_die;
+  /* comp_unit_die is not stored in die_hash, no need.  */
+
+  /* We try not to read any attributes in this function, because not
+     all CUs needed for references have been loaded yet, and symbol
+     table processing isn't initialized.  But we have to set the CU language,
+     or we won't be able to build types correctly.
+     Similarly, if we do not read the producer, we can not apply
+     producer-specific interpretation.  */
+  prepare_one_comp_unit (cu, cu->dies, *language_ptr);
+}
+
+#ifdef CXX_STD_THREAD
+
+/* Read the full DIEs of compilation unit PER_CU, which is a private
+   copy of the real one, as load_full_comp_unit would.  This runs in a
+   worker thread, so it only reads the DIEs; the main thread does the
+   rest when load_full_comp_unit takes the CU over.  Return NULL if the
+   main thread has to read the CU instead, for the same reasons as in
+   dwarf2_prescan_comp_unit.  */
+
+static struct dwarf2_cu *
+dwarf2_preload_comp_unit (struct dwarf2_per_cu_data *per_cu)
+{
+  struct dwarf2_section_info *section = per_cu->section;
+  struct dwarf2_section_info *abbrev_section
+    = get_abbrev_section_for_cu (per_cu);
+  bfd *abfd = get_section_bfd_owner (section);
+  struct dwarf2_cu *cu = XNEW (struct dwarf2_cu);
+  complaint_interceptor interceptor;
+  int ok = 0;
+
+  init_one_comp_unit (cu, per_cu);
+
+  TRY
+    {
+      const gdb_byte *begin_info_ptr, *info_ptr;
+      struct die_reader_specs reader;
+      struct die_info *comp_unit_die;
+      int has_children;
+
+      begin_info_ptr = section->buffer + to_underlying (per_cu->sect_off);
+      info_ptr = read_and_check_comp_unit_head (&cu->header, section,
+						abbrev_section,
+						begin_info_ptr,
+						rcuh_kind::COMPILE);
+
+      if (info_ptr < begin_info_ptr + per_cu->length
+	  && peek_abbrev_code (abfd, info_ptr) != 0)
+	{
+	  dwarf2_read_abbrevs (cu, abbrev_section);
+	  if (prescan_abbrevs_ok (cu->abbrev_table))
+	    {
+	      init_cu_die_reader (&reader, cu, section, NULL);
+	      info_ptr = read_full_die (&reader, &comp_unit_die, info_ptr,
+					&has_children);
+
+	      if (dwarf2_attr_no_follow (comp_unit_die,
+					 DW_AT_GNU_dwo_name) == NULL)
+		{
+		  cu->die_hash =
+		    htab_create_alloc_ex (cu->header.length / 12,
+					  die_hash,
+					  die_eq,
+					  NULL,
+					  &cu->comp_unit_obstack,
+					  hashtab_obstack_allocate,
+					  dummy_obstack_deallocate);
+
+		  if (has_children)
+		    comp_unit_die->child
+		      = read_die_and_siblings (&reader, info_ptr, &info_ptr,
+					       comp_unit_die);
+		  cu->dies = comp_unit_die;
+		  ok = 1;
+		}
+	    }
+	}
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      ok = 0;
+    }
+  END_CATCH
+
+  dwarf2_free_abbrev_table (cu);
+
+  if (!ok || interceptor.complained ())
+    {
+      free_heap_comp_unit (cu);
+      return NULL;
+    }
+
+  return cu;
+}
+
+/* Free CU, as returned by dwarf2_preload_comp_unit.  */
+
+static void
+dwarf2_free_preloaded_comp_unit (struct dwarf2_cu *cu)
+{
+  free_heap_comp_unit (cu);
+}
+
+/* Take over CU, which a worker thread read for THIS_CU, as if
+   load_full_comp_unit had read it.  */
+
+static void
+adopt_preloaded_comp_unit (struct dwarf2_per_cu_data *this_cu,
+			   struct dwarf2_cu *cu,
+			   enum language pretend_language)
+{
+  gdb_assert (this_cu->cu == NULL);
+  gdb_assert (this_cu->sect_off == cu->header.sect_off);
+  gdb_assert (this_cu->length == get_cu_length (&cu->header));
+
+  this_cu->cu = cu;
+  this_cu->dwarf_version = cu->header.version;
+  cu->per_cu = this_cu;
+
+  prepare_one_comp_unit (cu, cu->dies, pretend_language);
+
+  /* Link this CU into read_in_chain.  */
+  cu->read_in_chain = dwarf2_per_objfile->read_in_chain;
+  dwarf2_per_objfile->read_in_chain = this_cu;
 }
 
-/* Trivial comparison function for die_info structures: two DIEs
-   are equal if they have the same offset.  */
+#endif /* CXX_STD_THREAD */
 
-static int
-die_eq (const void *item_lhs, const void *item_rhs)
+dwarf2_preload_scope::dwarf2_preload_scope
+  (const std::vector<struct dwarf2_per_cu_data *> &units)
+  : m_per_objfile (NULL)
 {
-  const struct die_info *die_lhs = (const struct die_info *) item_lhs;
-  const struct die_info *die_rhs = (const struct die_info *) item_rhs;
+#ifdef CXX_STD_THREAD
+  std::vector<struct dwarf2_per_cu_data *> wanted;
+  std::unordered_set<struct dwarf2_per_cu_data *> seen;
+  int n_threads;
 
-  return die_lhs->sect_off == die_rhs->sect_off;
-}
+  gdb_assert (dwarf2_per_objfile->using_index);
 
-/* die_reader_func for load_full_comp_unit.
-   This is identical to read_signatured_type_reader,
-   but is kept separate for now.  */
+  if (dwarf2_per_objfile->preload_pool != NULL)
+    return;
 
-static void
-load_full_comp_unit_reader (const struct die_reader_specs *reader,
-			    const gdb_byte *info_ptr,
-			    struct die_info *comp_unit_die,
-			    int has_children,
-			    void *data)
-{
-  struct dwarf2_cu *cu = reader->cu;
-  enum language *language_ptr = (enum language *) data;
+  for (struct dwarf2_per_cu_data *per_cu : units)
+    if (!per_cu->is_debug_types
+	&& per_cu->cu == NULL
+	&& per_cu->v.quick->compunit_symtab == NULL
+	&& seen.insert (per_cu).second)
+      wanted.push_back (per_cu);
 
-  gdb_assert (cu->die_hash == NULL);
-  cu->die_hash =
-    htab_create_alloc_ex (cu->header.length / 12,
-			  die_hash,
-			  die_eq,
-			  NULL,
-			  &cu->comp_unit_obstack,
-			  hashtab_obstack_allocate,
-			  dummy_obstack_deallocate);
+  n_threads = dwarf2_worker_thread_count (dwarf_expansion_threads,
+					  wanted.size ());
+  if (n_threads <= 0)
+    return;
 
-  if (has_children)
-    comp_unit_die->child = read_die_and_siblings (reader, info_ptr,
-						  &info_ptr, comp_unit_die);
-  cu->dies = comp_unit_die;
-  /* comp_unit_die is not stored in die_hash, no need.  */
+  m_per_objfile = dwarf2_per_objfile;
+  m_per_objfile->preload_pool
+    = new dwarf2_unit_pool<struct dwarf2_cu>
+	(m_per_objfile->objfile, wanted, n_threads,
+	 dwarf2_preload_comp_unit, dwarf2_free_preloaded_comp_unit);
+#endif
+}
 
-  /* We try not to read any attributes in this function, because not
-     all CUs needed for references have been loaded yet, and symbol
-     table processing isn't initialized.  But we have to set the CU language,
-     or we won't be able to build types correctly.
-     Similarly, if we do not read the producer, we can not apply
-     producer-specific interpretation.  */
-  prepare_one_comp_unit (cu, cu->dies, *language_ptr);
+dwarf2_preload_scope::~dwarf2_preload_scope ()
+{
+#ifdef CXX_STD_THREAD
+  if (m_per_objfile != NULL)
+    {
+      delete m_per_objfile->preload_pool;
+      m_per_objfile->preload_pool = NULL;
+    }
+#endif
 }
 
 /* Load the DIEs associated with PER_CU into memory.  */
@@ -7939,6 +10087,27 @@ load_full_comp_unit (struct dwarf2_per_cu_data *this_cu,
 {
   gdb_assert (! this_cu->is_debug_types);
 
+#ifdef CXX_STD_THREAD
+  /* If a worker thread read the DIEs already, use them.  */
+  if (this_cu->cu == NULL && dwarf2_per_objfile->preload_pool != NULL)
+    {
+      dwarf2_unit_pool<struct dwarf2_cu> *pool
+	= dwarf2_per_objfile->preload_pool;
+      int index = pool->find (this_cu);
+
+      if (index >= 0)
+	{
+	  struct dwarf2_cu *cu = pool->take (index);
+
+	  if (cu != NULL)
+	    {
+	      adopt_preloaded_comp_unit (this_cu, cu, pretend_language);
+	      return;
+	    }
+	}
+    }
+#endif
+
   init_cutu_and_read_dies (this_cu, NULL, 1, 1,
 			   load_full_comp_unit_reader, &pretend_language);
 }
@@ -15891,6 +18060,39 @@ is_type_tag_for_partial (int tag)
     }
 }
 
+/* Subroutine of load_partial_dies.  Add a partial symbol for PART_DIE
+   to the global list if GLOBAL, else to the static list.  If CU is
+   being read by a worker thread, just record the symbol in
+   CU->prescan instead.  */
+
+static void
+add_partial_die_psymbol (struct partial_die_info *part_die,
+			 domain_enum domain, enum address_class aclass,
+			 int global, struct dwarf2_cu *cu)
+{
+  struct objfile *objfile = cu->objfile;
+
+  if (cu->prescan != NULL)
+    {
+      prescan_psymbol psym;
+
+      psym.name = part_die->name;
+      psym.raw_name = part_die->raw_name;
+      psym.global = global;
+      psym.domain = domain;
+      psym.aclass = aclass;
+      cu->prescan->psymbols.push_back (psym);
+      return;
+    }
+
+  add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
+		       domain, aclass,
+		       global
+		       ? &objfile->global_psymbols
+		       : &objfile->static_psymbols,
+		       0, cu->language, objfile);
+}
+
 /* Load all DIEs that are interesting for partial symbols into memory.  */
 
 static struct partial_die_info *
@@ -15910,7 +18112,7 @@ load_partial_dies (const struct die_reader_specs *reader,
   last_die = NULL;
 
   gdb_assert (cu->per_cu != NULL);
-  if (cu->per_cu->load_all_dies)
+  if (cu->per_cu->load_all_dies && cu->prescan == NULL)
     load_all = 1;
 
   cu->partial_dies
@@ -16024,10 +18226,8 @@ load_partial_dies (const struct die_reader_specs *reader,
 	      || part_die->tag == DW_TAG_subrange_type))
 	{
 	  if (building_psymtab && part_die->name != NULL)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_TYPEDEF,
-				 &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    add_partial_die_psymbol (part_die, VAR_DOMAIN, LOC_TYPEDEF,
+				     0, cu);
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
 	}
@@ -16060,12 +18260,8 @@ load_partial_dies (const struct die_reader_specs *reader,
 	    complaint (&symfile_complaints,
 		       _("malformed enumerator DIE ignored"));
 	  else if (building_psymtab)
-	    add_psymbol_to_list (part_die->name, strlen (part_die->name), 0,
-				 VAR_DOMAIN, LOC_CONST,
-				 cu->language == language_cplus
-				 ? &objfile->global_psymbols
-				 : &objfile->static_psymbols,
-				 0, cu->language, objfile);
+	    add_partial_die_psymbol (part_die, VAR_DOMAIN, LOC_CONST,
+				     cu->language == language_cplus, cu);
 
 	  info_ptr = locate_pdi_sibling (reader, part_die, info_ptr);
 	  continue;
@@ -16218,9 +18414,17 @@ read_partial_die (const struct die_reader_specs *reader,
 	      part_die->name = DW_STRING (&attr);
 	      break;
 	    default:
-	      part_die->name
-		= dwarf2_canonicalize_name (DW_STRING (&attr), cu,
-					    &objfile->per_bfd->storage_obstack);
+	      if (cu->prescan != NULL && cu->language == language_cplus)
+		{
+		  /* The C++ name parser is not reentrant; leave this to
+		     the main thread.  See canonicalize_prescan_names.  */
+		  part_die->name = DW_STRING (&attr);
+		  part_die->raw_name = 1;
+		}
+	      else
+		part_die->name
+		  = dwarf2_canonicalize_name (DW_STRING (&attr), cu,
+					      &objfile->per_bfd->storage_obstack);
 	      break;
 	    }
 	  break;
@@ -23225,6 +25429,9 @@ dwarf2_per_objfile_free (struct objfile *objfile, void *d)
 
   if (data->dwz_file && data->dwz_file->dwz_bfd)
     gdb_bfd_unref (data->dwz_file->dwz_bfd);
+
+  delete data->index_cache_res;
+  delete data->debug_names_table;
 }
 
 
@@ -23900,17 +26107,267 @@ recursively_write_psymbols (struct objfile *objfile,
 		  1);
 }
 
-/* Create an index file for OBJFILE in the directory DIR.  */
+/* Write the contents of the obstacks PARTS, in order, to the file
+   FILENAME.  The file is written under a temporary name and then
+   renamed, so that other processes never see a partial file.  */
+
+static void
+write_index_file (const std::string &filename,
+		  const std::vector<struct obstack *> &parts)
+{
+  std::string tmp_filename = string_printf ("%s.%ld.tmp", filename.c_str (),
+					    (long) getpid ());
+  FILE *out_file;
+
+  out_file = gdb_fopen_cloexec (tmp_filename.c_str (), "wb");
+  if (!out_file)
+    error (_("Can't open `%s' for writing"), tmp_filename.c_str ());
+
+  gdb::unlinker unlink_file (tmp_filename.c_str ());
+
+  TRY
+    {
+      for (struct obstack *part : parts)
+	write_obstack (out_file, part);
+    }
+  CATCH (except, RETURN_MASK_ALL)
+    {
+      fclose (out_file);
+      throw_exception (except);
+    }
+  END_CATCH
+
+  if (fclose (out_file) != 0)
+    error (_("Can't write `%s': %s"), tmp_filename.c_str (),
+	   safe_strerror (errno));
+
+  if (rename (tmp_filename.c_str (), filename.c_str ()) != 0)
+    error (_("Can't rename `%s' to `%s': %s"), tmp_filename.c_str (),
+	   filename.c_str (), safe_strerror (errno));
+
+  /* We want to keep the file.  */
+  unlink_file.keep ();
+}
+
+/* Append VALUE to OBSTACK as an unsigned LEB128 number.  */
+
+static void
+obstack_grow_uleb128 (struct obstack *obstack, ULONGEST value)
+{
+  do
+    {
+      gdb_byte byte = value & 0x7f;
+
+      value >>= 7;
+      if (value != 0)
+	byte |= 0x80;
+      obstack_1grow (obstack, byte);
+    }
+  while (value != 0);
+}
+
+/* Return the DWARF tag that a .debug_names index written by GDB uses
+   for symbols of KIND.  debug_names_tag_kind maps it back.  */
+
+static int
+debug_names_kind_tag (gdb_index_symbol_kind kind)
+{
+  switch (kind)
+    {
+    case GDB_INDEX_SYMBOL_KIND_FUNCTION:
+      return DW_TAG_subprogram;
+    case GDB_INDEX_SYMBOL_KIND_VARIABLE:
+      return DW_TAG_variable;
+    case GDB_INDEX_SYMBOL_KIND_TYPE:
+      return DW_TAG_typedef;
+    default:
+      return DW_TAG_label;
+    }
+}
+
+/* Write a DWARF 5 .debug_names index for OBJFILE to CONTENTS, from the
+   names collected in SYMTAB and the type units listed in
+   TYPES_CU_LIST in the .gdb_index format.  The names themselves are
+   written to STR_POOL, which is meant to be appended to the
+   .debug_str section of OBJFILE; the index refers to them at offsets
+   past the end of that section.  */
+
+static void
+write_debug_names (struct objfile *objfile, struct mapped_symtab *symtab,
+		   struct obstack *types_cu_list, struct obstack *contents,
+		   struct obstack *str_pool)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (get_objfile_arch (objfile));
+  struct dwarf2_section_info *str = &dwarf2_per_objfile->str;
+  struct obstack tables, abbrevs, entry_pool;
+  const offset_type n_cus = dwarf2_per_objfile->n_comp_units;
+  const offset_type n_tus = obstack_object_size (types_cu_list) / 24;
+  const gdb_byte *types_list = (const gdb_byte *) obstack_base (types_cu_list);
+  offset_type i;
+
+  auto put_4 = [byte_order] (struct obstack *obstack, ULONGEST value)
+    {
+      gdb_byte buf[4];
+
+      store_unsigned_integer (buf, 4, byte_order, value);
+      obstack_grow (obstack, buf, 4);
+    };
+
+  dwarf2_read_section (objfile, str);
+
+  /* Sort the names into their hash buckets, using one bucket per
+     name.  */
+  std::vector<std::pair<uint32_t, struct symtab_index_entry *>> names;
+  for (i = 0; i < symtab->size; ++i)
+    if (symtab->data[i] != NULL)
+      names.emplace_back (dwarf5_djb_hash (symtab->data[i]->name),
+			  symtab->data[i]);
+  const uint32_t bucket_count = names.size ();
+  std::sort (names.begin (), names.end (),
+	     [bucket_count] (const std::pair<uint32_t,
+					     struct symtab_index_entry *> &a,
+			     const std::pair<uint32_t,
+					     struct symtab_index_entry *> &b)
+    {
+      if (a.first % bucket_count != b.first % bucket_count)
+	return a.first % bucket_count < b.first % bucket_count;
+      if (a.first != b.first)
+	return a.first < b.first;
+      return strcmp (a.second->name, b.second->name) < 0;
+    });
+
+  obstack_init (&tables);
+  struct cleanup *cleanup = make_cleanup_obstack_free (&tables);
+  obstack_init (&abbrevs);
+  make_cleanup_obstack_free (&abbrevs);
+  obstack_init (&entry_pool);
+  make_cleanup_obstack_free (&entry_pool);
+
+  /* The CU and TU lists.  */
+  for (i = 0; i < n_cus; ++i)
+    put_4 (&tables,
+	   to_underlying (dwarf2_per_objfile->all_comp_units[i]->sect_off));
+  for (i = 0; i < n_tus; ++i)
+    put_4 (&tables,
+	   extract_unsigned_integer (types_list + i * 24, 8,
+				     BFD_ENDIAN_LITTLE));
+
+  /* The buckets, holding the 1-based index of their first name.  */
+  std::vector<offset_type> buckets (bucket_count, 0);
+  for (i = names.size (); i > 0; --i)
+    buckets[names[i - 1].first % bucket_count] = i;
+  for (offset_type bucket : buckets)
+    put_4 (&tables, bucket);
+
+  /* The hashes.  */
+  for (const auto &name : names)
+    put_4 (&tables, name.first);
+
+  /* The string offsets.  */
+  for (const auto &name : names)
+    {
+      ULONGEST str_off = str->size + obstack_object_size (str_pool);
+
+      if (str_off > 0xffffffff)
+	error (_("Too many names for a 32-bit DWARF .debug_names index"));
+      put_4 (&tables, str_off);
+      obstack_grow_str0 (str_pool, name.second->name);
+    }
+
+  /* The entry offsets, and the entries themselves.  Each combination
+     of tag, linkage, and unit kind gets its own abbreviation.  */
+  std::unordered_map<ULONGEST, ULONGEST> abbrev_codes;
+  for (const auto &name : names)
+    {
+      VEC (offset_type) *cu_indices = name.second->cu_indices;
+      offset_type cu_index_and_attrs;
+      int j;
+
+      put_4 (&tables, obstack_object_size (&entry_pool));
+
+      for (j = 0;
+	   VEC_iterate (offset_type, cu_indices, j, cu_index_and_attrs);
+	   ++j)
+	{
+	  offset_type cu_index = GDB_INDEX_CU_VALUE (cu_index_and_attrs);
+	  int is_static = GDB_INDEX_SYMBOL_STATIC_VALUE (cu_index_and_attrs);
+	  gdb_index_symbol_kind kind
+	    = GDB_INDEX_SYMBOL_KIND_VALUE (cu_index_and_attrs);
+	  int is_tu = cu_index >= n_cus;
+	  int tag = debug_names_kind_tag (kind);
+	  ULONGEST key = ((ULONGEST) tag << 2) | (is_static << 1) | is_tu;
+
+	  auto inserted = abbrev_codes.emplace (key, abbrev_codes.size () + 1);
+	  if (inserted.second)
+	    {
+	      obstack_grow_uleb128 (&abbrevs, inserted.first->second);
+	      obstack_grow_uleb128 (&abbrevs, tag);
+	      obstack_grow_uleb128 (&abbrevs, (is_tu ? DW_IDX_type_unit
+					       : DW_IDX_compile_unit));
+	      obstack_grow_uleb128 (&abbrevs, DW_FORM_udata);
+	      obstack_grow_uleb128 (&abbrevs, (is_static ? DW_IDX_GNU_internal
+					       : DW_IDX_GNU_external));
+	      obstack_grow_uleb128 (&abbrevs, DW_FORM_flag_present);
+	      obstack_grow_uleb128 (&abbrevs, 0);
+	      obstack_grow_uleb128 (&abbrevs, 0);
+	    }
+
+	  obstack_grow_uleb128 (&entry_pool, inserted.first->second);
+	  obstack_grow_uleb128 (&entry_pool, is_tu ? cu_index - n_cus : cu_index);
+	}
+
+      obstack_grow_uleb128 (&entry_pool, 0);
+    }
+  obstack_grow_uleb128 (&abbrevs, 0);
+
+  /* The header, which uses the 32-bit DWARF format.  */
+  static const char augmentation[4] = "GDB";
+  ULONGEST length = (2 + 2 + 7 * 4 + sizeof (augmentation)
+		     + obstack_object_size (&tables)
+		     + obstack_object_size (&abbrevs)
+		     + obstack_object_size (&entry_pool));
+  gdb_byte buf[2];
+
+  if (length >= 0xfffffff0)
+    error (_("Index too large for a 32-bit DWARF .debug_names index"));
+  put_4 (contents, length);
+  store_unsigned_integer (buf, 2, byte_order, 5);
+  obstack_grow (contents, buf, 2);
+  store_unsigned_integer (buf, 2, byte_order, 0);
+  obstack_grow (contents, buf, 2);
+  put_4 (contents, n_cus);
+  put_4 (contents, n_tus);
+  put_4 (contents, 0);
+  put_4 (contents, bucket_count);
+  put_4 (contents, names.size ());
+  put_4 (contents, obstack_object_size (&abbrevs));
+  put_4 (contents, sizeof (augmentation));
+  obstack_grow (contents, augmentation, sizeof (augmentation));
+
+  obstack_grow (contents, obstack_base (&tables),
+		obstack_object_size (&tables));
+  obstack_grow (contents, obstack_base (&abbrevs),
+		obstack_object_size (&abbrevs));
+  obstack_grow (contents, obstack_base (&entry_pool),
+		obstack_object_size (&entry_pool));
+
+  do_cleanups (cleanup);
+}
+
+/* Create an index file for OBJFILE in the directory DIR, named after
+   BASENAME.  For INDEX_KIND dw_index_kind::GDB_INDEX, the file is
+   BASENAME.gdb-index.  For dw_index_kind::DEBUG_NAMES, it is
+   BASENAME.debug_names, along with BASENAME.debug_str holding the
+   names it refers to.  */
 
 static void
-write_psymtabs_to_index (struct objfile *objfile, const char *dir)
+write_psymtabs_to_index (struct objfile *objfile, const char *dir,
+			 const char *basename, dw_index_kind index_kind)
 {
   struct cleanup *cleanup;
-  char *filename;
   struct obstack contents, addr_obstack, constant_pool, symtab_obstack;
   struct obstack cu_list, types_cu_list;
   int i;
-  FILE *out_file;
   struct mapped_symtab *symtab;
   offset_type val, size_of_contents, total_len;
   struct stat st;
@@ -23925,21 +26382,19 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
   if (!objfile->psymtabs || !objfile->psymtabs_addrmap)
     return;
 
+  /* A .debug_names index only describes the units of its own
+     file.  */
+  if (index_kind == dw_index_kind::DEBUG_NAMES
+      && dwarf2_get_dwz_file () != NULL)
+    error (_("Cannot make a .debug_names index for a file using dwz"));
+
   if (stat (objfile_name (objfile), &st) < 0)
     perror_with_name (objfile_name (objfile));
 
-  filename = concat (dir, SLASH_STRING, lbasename (objfile_name (objfile)),
-		     INDEX_SUFFIX, (char *) NULL);
-  cleanup = make_cleanup (xfree, filename);
-
-  out_file = gdb_fopen_cloexec (filename, "wb");
-  if (!out_file)
-    error (_("Can't open `%s' for writing"), filename);
-
-  gdb::unlinker unlink_file (filename);
+  std::string filename = std::string (dir) + SLASH_STRING + basename;
 
   symtab = create_mapped_symtab ();
-  make_cleanup (cleanup_mapped_symtab, symtab);
+  cleanup = make_cleanup (cleanup_mapped_symtab, symtab);
 
   obstack_init (&addr_obstack);
   make_cleanup_obstack_free (&addr_obstack);
@@ -24024,6 +26479,27 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
      lists.  */
   uniquify_cu_indices (symtab);
 
+  if (index_kind == dw_index_kind::DEBUG_NAMES)
+    {
+      struct obstack str_pool;
+
+      obstack_init (&contents);
+      make_cleanup_obstack_free (&contents);
+      obstack_init (&str_pool);
+      make_cleanup_obstack_free (&str_pool);
+
+      write_debug_names (objfile, symtab, &types_cu_list, &contents,
+			 &str_pool);
+
+      /* Write the names first, so that an index never refers to names
+	 missing from the file next to it.  */
+      write_index_file (filename + ".debug_str", { &str_pool });
+      write_index_file (filename + ".debug_names", { &contents });
+
+      do_cleanups (cleanup);
+      return;
+    }
+
   obstack_init (&constant_pool);
   make_cleanup_obstack_free (&constant_pool);
   obstack_init (&symtab_obstack);
@@ -24066,19 +26542,26 @@ write_psymtabs_to_index (struct objfile *objfile, const char *dir)
 
   gdb_assert (obstack_object_size (&contents) == size_of_contents);
 
-  write_obstack (out_file, &contents);
-  write_obstack (out_file, &cu_list);
-  write_obstack (out_file, &types_cu_list);
-  write_obstack (out_file, &addr_obstack);
-  write_obstack (out_file, &symtab_obstack);
-  write_obstack (out_file, &constant_pool);
+  write_index_file (filename + INDEX_SUFFIX,
+		    { &contents, &cu_list, &types_cu_list, &addr_obstack,
+		      &symtab_obstack, &constant_pool });
+
+  do_cleanups (cleanup);
+}
 
-  fclose (out_file);
+/* See symfile.h.  */
 
-  /* We want to keep the file.  */
-  unlink_file.keep ();
+void
+dwarf2_write_index (struct objfile *objfile, const char *dir,
+		    const char *basename, dw_index_kind index_kind)
+{
+  dwarf2_per_objfile
+    = (struct dwarf2_per_objfile *) objfile_data (objfile,
+						  dwarf2_objfile_data_key);
+  if (dwarf2_per_objfile == NULL)
+    error (_("No DWARF information in `%s'"), objfile_name (objfile));
 
-  do_cleanups (cleanup);
+  write_psymtabs_to_index (objfile, dir, basename, index_kind);
 }
 
 /* Implementation of the `save gdb-index' command.
@@ -24090,9 +26573,22 @@ static void
 save_gdb_index_command (char *arg, int from_tty)
 {
   struct objfile *objfile;
+  const char dwarf5space[] = "-dwarf-5 ";
+  dw_index_kind index_kind = dw_index_kind::GDB_INDEX;
+
+  if (!arg)
+    arg = (char *) "";
 
-  if (!arg || !*arg)
-    error (_("usage: save gdb-index DIRECTORY"));
+  arg = skip_spaces (arg);
+  if (strncmp (arg, dwarf5space, strlen (dwarf5space)) == 0)
+    {
+      index_kind = dw_index_kind::DEBUG_NAMES;
+      arg += strlen (dwarf5space);
+      arg = skip_spaces (arg);
+    }
+
+  if (!*arg)
+    error (_("usage: save gdb-index [-dwarf-5] DIRECTORY"));
 
   ALL_OBJFILES (objfile)
   {
@@ -24110,7 +26606,9 @@ save_gdb_index_command (char *arg, int from_tty)
 
 	TRY
 	  {
-	    write_psymtabs_to_index (objfile, arg);
+	    const char *basename = lbasename (objfile_name (objfile));
+
+	    write_psymtabs_to_index (objfile, arg, basename, index_kind);
 	  }
 	CATCH (except, RETURN_MASK_ERROR)
 	  {
@@ -24125,6 +26623,154 @@ save_gdb_index_command (char *arg, int from_tty)
 
 
 
+/* The event handler that runs dwarf2_background_expand.  */
+static struct async_event_handler *dwarf2_background_handler;
+
+/* Expand one compilation unit of OBJFILE that has not been expanded
+   yet, for background expansion.  The CU containing "main" goes
+   first, since it is the one most likely to be needed; then the
+   others, in order.  Return false if there is nothing left to
+   expand.  */
+
+static bool
+dwarf2_background_expand_one (struct objfile *objfile)
+{
+  struct dwarf2_per_objfile *data
+    = ((struct dwarf2_per_objfile *)
+       objfile_data (objfile, dwarf2_objfile_data_key));
+
+  /* Leave objfiles whose partial symbols have not been needed yet
+     alone; reading them is no cheaper in the background.  */
+  if (data == NULL
+      || (!data->using_index && (objfile->flags & OBJF_PSYMTABS_READ) == 0))
+    return false;
+
+  dwarf2_per_objfile = data;
+
+  if (!data->background_main_done)
+    {
+      struct bound_minimal_symbol msym
+	= lookup_minimal_symbol (main_name (), NULL, objfile);
+
+      data->background_main_done = 1;
+      if (msym.minsym != NULL)
+	{
+	  find_pc_sect_compunit_symtab (BMSYMBOL_VALUE_ADDRESS (msym),
+					MSYMBOL_OBJ_SECTION (msym.objfile,
+							     msym.minsym));
+	  return true;
+	}
+    }
+
+  while (data->background_next < data->n_comp_units)
+    {
+      struct dwarf2_per_cu_data *per_cu
+	= data->all_comp_units[data->background_next++];
+
+      if (data->using_index)
+	{
+	  if (per_cu->v.quick->compunit_symtab != NULL)
+	    continue;
+	  dw2_instantiate_symtab (per_cu);
+	}
+      else
+	{
+	  struct partial_symtab *pst = per_cu->v.psymtab;
+
+	  if (pst == NULL)
+	    continue;
+	  while (pst->user != NULL)
+	    pst = pst->user;
+	  if (pst->readin)
+	    continue;
+
+	  scoped_restore decrementer = increment_reading_symtab ();
+	  (*pst->read_symtab) (pst, objfile);
+	}
+
+      return true;
+    }
+
+  return false;
+}
+
+/* Expand one compilation unit in the background, and reschedule
+   ourselves if there may be more.  Expanding one unit at a time lets
+   the event loop handle user input between them, so that GDB stays
+   responsive while the symbol tables most likely to be needed are
+   built ahead of time.  */
+
+static void
+dwarf2_background_expand (gdb_client_data client_data)
+{
+  struct objfile *objfile;
+
+  if (!dwarf_background_expansion)
+    return;
+
+  /* Leave the CPU to the inferior; the normal_stop observer brings us
+     back.  */
+  if (threads_are_executing ())
+    return;
+
+  ALL_OBJFILES (objfile)
+    {
+      bool expanded;
+
+      TRY
+	{
+	  expanded = dwarf2_background_expand_one (objfile);
+	}
+      CATCH (except, RETURN_MASK_ALL)
+	{
+	  /* Skip the unit.  The error will show up again if its
+	     symbols are really needed.  */
+	  expanded = true;
+	}
+      END_CATCH
+
+      if (expanded)
+	{
+	  mark_async_event_handler (dwarf2_background_handler);
+	  return;
+	}
+    }
+}
+
+/* Schedule background expansion, if it is enabled.  */
+
+static void
+dwarf2_schedule_background_expansion (void)
+{
+  if (dwarf_background_expansion)
+    mark_async_event_handler (dwarf2_background_handler);
+}
+
+/* The new_objfile observer.  */
+
+static void
+dwarf2_background_new_objfile (struct objfile *objfile)
+{
+  dwarf2_schedule_background_expansion ();
+}
+
+/* The normal_stop observer.  */
+
+static void
+dwarf2_background_normal_stop (struct bpstats *bs, int print_frame)
+{
+  dwarf2_schedule_background_expansion ();
+}
+
+/* The "set" function of "maint set dwarf background-expansion".  */
+
+static void
+set_dwarf_background_expansion (char *args, int from_tty,
+				struct cmd_list_element *c)
+{
+  dwarf2_schedule_background_expansion ();
+}
+
 int dwarf_always_disassemble;
 
 static void
@@ -24180,6 +26826,50 @@ caching, which can slow down startup."),
 			    &set_dwarf_cmdlist,
 			    &show_dwarf_cmdlist);
 
+  add_setshow_zuinteger_unlimited_cmd ("psymtab-threads", class_obscure,
+				       &dwarf_psymtab_threads, _("\
+Set the number of threads used to read DWARF partial symbols."), _("\
+Show the number of threads used to read DWARF partial symbols."), _("\
+When building partial symbol tables, worker threads read the debug\n\
+information entries of compilation units ahead of the main thread.\n\
+Zero means to read everything on the main thread.  \"unlimited\" means\n\
+to use one thread per CPU."),
+				       NULL,
+				       show_dwarf_psymtab_threads,
+				       &set_dwarf_cmdlist,
+				       &show_dwarf_cmdlist);
+
+  add_setshow_zuinteger_unlimited_cmd ("expansion-threads", class_obscure,
+				       &dwarf_expansion_threads, _("\
+Set the number of threads used to read DWARF full symbols."), _("\
+Show the number of threads used to read DWARF full symbols."), _("\
+When a lookup needs the full symbols of several compilation units,\n\
+worker threads read their debug information entries ahead of the main\n\
+thread, which builds the symbol tables.  Zero means to read everything\n\
+on the main thread.  \"unlimited\" means to use one thread per CPU."),
+				       NULL,
+				       show_dwarf_expansion_threads,
+				       &set_dwarf_cmdlist,
+				       &show_dwarf_cmdlist);
+
+  add_setshow_boolean_cmd ("background-expansion", class_obscure,
+			   &dwarf_background_expansion, _("\
+Set whether DWARF symbol tables are expanded while GDB is idle."), _("\
+Show whether DWARF symbol tables are expanded while GDB is idle."), _("\
+When enabled, GDB expands the full symbol tables of the compilation\n\
+units of each program and library, one at a time, whenever it has\n\
+nothing else to do, starting with the unit containing \"main\".\n\
+This makes later lookups faster at the cost of memory."),
+			   set_dwarf_background_expansion,
+			   show_dwarf_background_expansion,
+			   &set_dwarf_cmdlist,
+			   &show_dwarf_cmdlist);
+
+  dwarf2_background_handler
+    = create_async_event_handler (dwarf2_background_expand, NULL);
+  observer_attach_new_objfile (dwarf2_background_new_objfile);
+  observer_attach_normal_stop (dwarf2_background_normal_stop);
+
   add_setshow_boolean_cmd ("always-disassemble", class_obscure,
 			   &dwarf_always_disassemble, _("\
 Set whether `info address' always disassembles DWARF expressions."), _("\
@@ -24244,7 +26934,11 @@ Warning: This option must be enabled before gdb reads the file."),
   c = add_cmd ("gdb-index", class_files, save_gdb_index_command,
 	       _("\
 Save a gdb-index file.\n\
-Usage: save gdb-index DIRECTORY"),
+Usage: save gdb-index [-dwarf-5] DIRECTORY\n\
+\n\
+No options create one file with .gdb-index extension for pre-DWARF-5\n\
+compatible .gdb_index section.  With -dwarf-5 creates two files with\n\
+extension .debug_names and .debug_str for DWARF-5 .debug_names section."),
 	       &save_cmdlist);
   set_cmd_completer (c, filename_completer);
 
@@ -31,6 +31,14 @@
 #endif
 #endif
 
+/* On hosts that have it, epoll is used on top of poll.  */
+#if defined (HAVE_POLL) && defined (HAVE_SYS_EPOLL_H) \
+  && defined (HAVE_EPOLL_CREATE1)
+#define HAVE_EPOLL 1
+#include <sys/epoll.h>
+#include <vector>
+#endif
+
 #include <sys/types.h>
 #include "gdb_sys_time.h"
 #include "gdb_select.h"
@@ -157,6 +165,27 @@ async_event_handler;
 
 static unsigned char use_poll = USE_POLL;
 
+#ifdef HAVE_EPOLL
+/* Do we use epoll?  When we do, the poll structures of gdb_notifier
+   are still kept up to date, so that we can go back to poll if a file
+   descriptor turns out not to be supported by epoll (e.g., a regular
+   file used as stdin).  */
+static unsigned char use_epoll = 1;
+
+/* The epoll instance, or -1 if it has not been created yet.  */
+static int epoll_fd = -1;
+
+/* The file handlers monitored with epoll, indexed by file
+   descriptor.  Events carry the file descriptor rather than the file
+   handler, so that an event for a file descriptor that was deleted
+   meanwhile finds no handler here instead of a dangling pointer.  */
+static std::vector<file_handler *> epoll_handlers;
+
+/* The maximum number of ready file descriptors collected by a single
+   call to epoll_wait.  The others are collected by the next call.  */
+#define EPOLL_MAX_EVENTS 64
+#endif
+
 #ifdef USE_WIN32API
 #include <windows.h>
 #include <io.h>
@@ -205,6 +234,14 @@ static struct
 
     /* Flag to tell whether the timeout should be used.  */
     int timeout_valid;
+
+#ifdef HAVE_EPOLL
+    /* Incremented whenever a file handler is added or removed, and
+       whenever epoll_wait is called.  While dispatching the events
+       returned by epoll_wait, a change means that the rest of the
+       events may be stale.  */
+    unsigned int epoll_epoch;
+#endif
   }
 gdb_notifier;
 
@@ -406,6 +443,94 @@ start_event_loop (void)
 }
 
 
+#ifdef HAVE_EPOLL
+
+/* Stop using epoll, and go back to poll.  */
+
+static void
+disable_epoll (void)
+{
+  use_epoll = 0;
+  epoll_handlers.clear ();
+  if (epoll_fd >= 0)
+    {
+      close (epoll_fd);
+      epoll_fd = -1;
+    }
+}
+
+/* Convert the poll events in MASK to epoll events.  */
+
+static uint32_t
+poll_to_epoll_events (int mask)
+{
+  uint32_t events = 0;
+
+  if (mask & (POLLIN | POLLRDNORM | POLLRDBAND))
+    events |= EPOLLIN;
+  if (mask & POLLPRI)
+    events |= EPOLLPRI;
+  if (mask & (POLLOUT | POLLWRNORM | POLLWRBAND))
+    events |= EPOLLOUT;
+  return events;
+}
+
+/* Convert the epoll events in EVENTS to poll events.  */
+
+static int
+epoll_to_poll_events (uint32_t events)
+{
+  int mask = 0;
+
+  if (events & EPOLLIN)
+    mask |= POLLIN;
+  if (events & EPOLLPRI)
+    mask |= POLLPRI;
+  if (events & EPOLLOUT)
+    mask |= POLLOUT;
+  if (events & EPOLLERR)
+    mask |= POLLERR;
+  if (events & EPOLLHUP)
+    mask |= POLLHUP;
+  return mask;
+}
+
+/* Start monitoring FILE_PTR with epoll, creating the epoll instance
+   if needed.  If epoll cannot be used, go back to poll.  */
+
+static void
+epoll_add_file_handler (file_handler *file_ptr)
+{
+  struct epoll_event event;
+
+  if (epoll_fd < 0)
+    {
+      epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+      if (epoll_fd < 0)
+	{
+	  disable_epoll ();
+	  return;
+	}
+    }
+
+  /* Level-triggered, since handlers are free not to consume all the
+     data available on their file descriptor.  */
+  memset (&event, 0, sizeof (event));
+  event.events = poll_to_epoll_events (file_ptr->mask);
+  event.data.fd = file_ptr->fd;
+  if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, file_ptr->fd, &event) != 0)
+    {
+      disable_epoll ();
+      return;
+    }
+
+  if (epoll_handlers.size () <= (size_t) file_ptr->fd)
+    epoll_handlers.resize (file_ptr->fd + 1);
+  epoll_handlers[file_ptr->fd] = file_ptr;
+}
+
+#endif /* HAVE_EPOLL */
+
 /* Wrapper function for create_file_handler, so that the caller
    doesn't have to know implementation details about the use of poll
    vs. select.  */
@@ -501,6 +626,12 @@ create_file_handler (int fd, int mask, handler_func * proc,
 	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->fd = fd;
 	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->events = mask;
 	  (gdb_notifier.poll_fds + gdb_notifier.num_fds - 1)->revents = 0;
+#ifdef HAVE_EPOLL
+	  file_ptr->mask = mask;
+	  if (use_epoll)
+	    epoll_add_file_handler (file_ptr);
+	  gdb_notifier.epoll_epoch++;
+#endif
 #else
 	  internal_error (__FILE__, __LINE__,
 			  _("use_poll without HAVE_POLL"));
@@ -525,6 +656,11 @@ create_file_handler (int fd, int mask, handler_func * proc,
 
 	  if (gdb_notifier.num_fds <= fd)
 	    gdb_notifier.num_fds = fd + 1;
+
+#ifdef HAVE_EPOLL
+	  /* Only the poll masks are translated for epoll.  */
+	  disable_epoll ();
+#endif
 	}
     }
 
@@ -605,6 +741,18 @@ delete_file_handler (int fd)
       xfree (gdb_notifier.poll_fds);
       gdb_notifier.poll_fds = new_poll_fds;
       gdb_notifier.num_fds--;
+
+#ifdef HAVE_EPOLL
+      /* This fails if FD was closed already, in which case epoll
+	 stopped monitoring it by itself.  */
+      if (use_epoll && epoll_fd >= 0)
+	{
+	  epoll_ctl (epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+	  if ((size_t) fd < epoll_handlers.size ())
+	    epoll_handlers[fd] = NULL;
+	}
+      gdb_notifier.epoll_epoch++;
+#endif
 #else
       internal_error (__FILE__, __LINE__,
 		      _("use_poll without HAVE_POLL"));
@@ -735,6 +883,64 @@ handle_file_event (file_handler *file_ptr, int ready_mask)
     }
 }
 
+#ifdef HAVE_EPOLL
+
+/* The epoll variant of gdb_wait_for_event.  Unlike poll and select,
+   which are rescanned and then run one handler, this runs the
+   handlers of all the file descriptors found ready by a single
+   epoll_wait, finding them in constant time through EPOLL_HANDLERS.
+   A handler may add or remove file handlers, or run a nested event
+   loop, which may make the remaining events stale; in that case we
+   stop there and leave them to the next epoll_wait, which reports
+   them again as long as they are still pending.  */
+
+static int
+epoll_wait_for_event (int block)
+{
+  struct epoll_event events[EPOLL_MAX_EVENTS];
+  unsigned int epoch;
+  int timeout;
+  int num_found;
+  int i;
+
+  if (block)
+    timeout = gdb_notifier.timeout_valid ? gdb_notifier.poll_timeout : -1;
+  else
+    timeout = 0;
+
+  num_found = epoll_wait (epoll_fd, events, EPOLL_MAX_EVENTS, timeout);
+
+  /* Don't print anything if we get out of epoll_wait because of a
+     signal.  */
+  if (num_found == -1 && errno != EINTR)
+    perror_with_name (("epoll_wait"));
+
+  if (num_found <= 0)
+    return 0;
+
+  epoch = ++gdb_notifier.epoll_epoch;
+  for (i = 0; i < num_found; i++)
+    {
+      int fd = events[i].data.fd;
+      file_handler *file_ptr;
+
+      if ((size_t) fd >= epoll_handlers.size ())
+	continue;
+      file_ptr = epoll_handlers[fd];
+      if (file_ptr == NULL)
+	continue;
+
+      handle_file_event (file_ptr, epoll_to_poll_events (events[i].events));
+
+      if (gdb_notifier.epoll_epoch != epoch)
+	break;
+    }
+
+  return 1;
+}
+
+#endif /* HAVE_EPOLL */
+
 /* Wait for new events on the monitored file descriptors.  Run the
    event handler if the first descriptor that is detected by the poll.
    If BLOCK and if there are no events, this function will block in
@@ -758,6 +964,11 @@ gdb_wait_for_event (int block)
   if (block)
     update_wait_timeout ();
 
+#ifdef HAVE_EPOLL
+  if (use_poll && use_epoll && epoll_fd >= 0)
+    return epoll_wait_for_event (block);
+#endif
+
   if (use_poll)
     {
 #ifdef HAVE_POLL
@@ -543,6 +543,72 @@ objfile_find_memory_regions (struct target_ops *self,
   return 0;
 }
 
+/* The granularity at which gcore_write_sparse looks for memory that
+   is all zeros.  */
+#define GCORE_HOLE_SIZE 4096
+
+/* Return true if the LEN bytes at BUF are all zero.  */
+
+static bool
+gcore_all_zero (const gdb_byte *buf, size_t len)
+{
+  /* Comparing the buffer with itself shifted by one byte lets memcmp
+     do the work, which it does a word or a vector at a time.  */
+  return len == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
+/* Write the SIZE bytes at MEMHUNK to OSEC at OFFSET in OBFD, leaving
+   out the blocks that are all zero.  The core file is created empty,
+   so these read back as zeros, and take no space on file systems that
+   support sparse files.  If LAST, MEMHUNK ends the section, and its
+   last byte is written regardless, so that the file is not cut short
+   by a hole at its end.  Return false on failure.  */
+
+static bool
+gcore_write_sparse (bfd *obfd, asection *osec, const gdb_byte *memhunk,
+		    file_ptr offset, bfd_size_type size, bool last)
+{
+  bfd_size_type start = 0;
+  bool end_written = false;
+
+  while (start < size)
+    {
+      bfd_size_type end;
+
+      end = start + std::min (size - start, (bfd_size_type) GCORE_HOLE_SIZE);
+      if (gcore_all_zero (memhunk + start, end - start))
+	{
+	  start = end;
+	  continue;
+	}
+
+      /* Extend the run of blocks with data as far as possible, to
+	 write it at once.  */
+      while (end < size)
+	{
+	  bfd_size_type next
+	    = end + std::min (size - end, (bfd_size_type) GCORE_HOLE_SIZE);
+
+	  if (gcore_all_zero (memhunk + end, next - end))
+	    break;
+	  end = next;
+	}
+
+      if (!bfd_set_section_contents (obfd, osec, memhunk + start,
+				     offset + start, end - start))
+	return false;
+
+      end_written = end == size;
+      start = end;
+    }
+
+  if (last && size > 0 && !end_written)
+    return bfd_set_section_contents (obfd, osec, memhunk + size - 1,
+				     offset + size - 1, 1);
+
+  return true;
+}
+
 static void
 gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 {
@@ -577,7 +643,8 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 		   paddress (target_gdbarch (), bfd_section_vma (obfd, osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk, offset, size))
+      if (!gcore_write_sparse (obfd, osec, memhunk, offset, size,
+			       size == total_size))
 	{
 	  warning (_("Failed to write corefile contents (%s)."),
 		   bfd_errmsg (bfd_get_error ()));
@@ -372,6 +372,41 @@ emit_le_goto (int *offset_p, int *size_p)
   target_emit_ops ()->emit_le_goto (offset_p, size_p);
 }
 
+/* Emit code for the division or remainder operation OP.  Return false
+   if the target cannot compile it.  */
+
+static bool
+emit_div_rem (enum gdb_agent_op op)
+{
+  struct emit_ops *ops = target_emit_ops ();
+  void (*emit) (void);
+
+  switch (op)
+    {
+    case gdb_agent_op_div_signed:
+      emit = ops->emit_div_signed;
+      break;
+    case gdb_agent_op_div_unsigned:
+      emit = ops->emit_div_unsigned;
+      break;
+    case gdb_agent_op_rem_signed:
+      emit = ops->emit_rem_signed;
+      break;
+    case gdb_agent_op_rem_unsigned:
+      emit = ops->emit_rem_unsigned;
+      break;
+    default:
+      emit = NULL;
+      break;
+    }
+
+  if (emit == NULL)
+    return false;
+
+  emit ();
+  return true;
+}
+
 /* Scan an agent expression for any evidence that the given PC is the
    target of a jump bytecode in the expression.  */
 
@@ -459,19 +494,11 @@ compile_bytecodes (struct agent_expr *aexpr)
 	  break;
 
 	case gdb_agent_op_div_signed:
-	  UNHANDLED;
-	  break;
-
 	case gdb_agent_op_div_unsigned:
-	  UNHANDLED;
-	  break;
-
 	case gdb_agent_op_rem_signed:
-	  UNHANDLED;
-	  break;
-
 	case gdb_agent_op_rem_unsigned:
-	  UNHANDLED;
+	  if (!emit_div_rem ((enum gdb_agent_op) op))
+	    UNHANDLED;
 	  break;
 
 	case gdb_agent_op_lsh:
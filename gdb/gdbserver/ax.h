@@ -137,6 +137,15 @@ struct emit_ops
   void (*emit_le_goto) (int *offset_p, int *size_p);
   void (*emit_gt_goto) (int *offset_p, int *size_p);
   void (*emit_ge_goto) (int *offset_p, int *size_p);
+
+  /* Emit code for division and remainder.  The code must make the
+     compiled expression return expr_eval_divide_by_zero if the divisor
+     is zero.  These may be NULL, in which case expressions using them
+     are left to the interpreter.  */
+  void (*emit_div_signed) (void);
+  void (*emit_div_unsigned) (void);
+  void (*emit_rem_signed) (void);
+  void (*emit_rem_unsigned) (void);
 };
 
 extern CORE_ADDR current_insn_ptr;
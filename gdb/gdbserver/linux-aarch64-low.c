@@ -1341,6 +1341,50 @@ emit_mul (uint32_t *buf, struct aarch64_register rd,
   return emit_data_processing_reg (buf, MUL, rd, rn, rm);
 }
 
+/* Write a MSUB instruction into *BUF.
+
+     MSUB rd, rn, rm, ra
+
+   RD is the destination register, set to RA - RN * RM.
+   RN, RM and RA are the source registers.  */
+
+static int
+emit_msub (uint32_t *buf, struct aarch64_register rd,
+	   struct aarch64_register rn, struct aarch64_register rm,
+	   struct aarch64_register ra)
+{
+  return emit_data_processing_reg (buf, MSUB | ENCODE (ra.num, 5, 10),
+				   rd, rn, rm);
+}
+
+/* Write a SDIV instruction into *BUF.
+
+     SDIV rd, rn, rm
+
+   RD is the destination register.
+   RN and RM are the source registers.  */
+
+static int
+emit_sdiv (uint32_t *buf, struct aarch64_register rd,
+	   struct aarch64_register rn, struct aarch64_register rm)
+{
+  return emit_data_processing_reg (buf, SDIV, rd, rn, rm);
+}
+
+/* Write a UDIV instruction into *BUF.
+
+     UDIV rd, rn, rm
+
+   RD is the destination register.
+   RN and RM are the source registers.  */
+
+static int
+emit_udiv (uint32_t *buf, struct aarch64_register rd,
+	   struct aarch64_register rn, struct aarch64_register rm)
+{
+  return emit_data_processing_reg (buf, UDIV, rd, rn, rm);
+}
+
 /* Write a MRS instruction into *BUF.  The register size is 64-bit.
 
      MRS xt, system_reg
@@ -2351,6 +2395,85 @@ aarch64_emit_rsh_unsigned (void)
   emit_ops_insns (buf, p - buf);
 }
 
+/* Pop the dividend into x1 and check the divisor on top of the stack,
+   in x0.  If it is zero, return expr_eval_divide_by_zero from the
+   compiled expression, restoring the state saved by the prologue.
+   Division instructions do not trap on AArch64, so this check is what
+   keeps the result in line with the interpreter.  */
+
+static uint32_t *
+emit_div_prologue (uint32_t *p)
+{
+  p += emit_pop (p, x1);
+  /* Branch over the 4 instructions below if x0 != 0.  */
+  p += emit_cb (p, 1, x0, 5 * 4);
+
+  p += emit_add (p, sp, fp, immediate_operand (2 * 8));
+  p += emit_ldp (p, fp, lr, fp, offset_memory_operand (0));
+  p += emit_mov (p, x0, immediate_operand (expr_eval_divide_by_zero));
+  p += emit_ret (p, lr);
+
+  return p;
+}
+
+/* Implementation of emit_ops method "emit_div_signed".  */
+
+static void
+aarch64_emit_div_signed (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  p = emit_div_prologue (p);
+  p += emit_sdiv (p, x0, x1, x0);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_div_unsigned".  */
+
+static void
+aarch64_emit_div_unsigned (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  p = emit_div_prologue (p);
+  p += emit_udiv (p, x0, x1, x0);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_rem_signed".  */
+
+static void
+aarch64_emit_rem_signed (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  p = emit_div_prologue (p);
+  p += emit_sdiv (p, x2, x1, x0);
+  p += emit_msub (p, x0, x2, x0, x1);
+
+  emit_ops_insns (buf, p - buf);
+}
+
+/* Implementation of emit_ops method "emit_rem_unsigned".  */
+
+static void
+aarch64_emit_rem_unsigned (void)
+{
+  uint32_t buf[16];
+  uint32_t *p = buf;
+
+  p = emit_div_prologue (p);
+  p += emit_udiv (p, x2, x1, x0);
+  p += emit_msub (p, x0, x2, x0, x1);
+
+  emit_ops_insns (buf, p - buf);
+}
+
 /* Implementation of emit_ops method "emit_ext".  */
 
 static void
@@ -2895,6 +3018,10 @@ static struct emit_ops aarch64_emit_ops_impl =
   aarch64_emit_le_goto,
   aarch64_emit_gt_goto,
   aarch64_emit_ge_got,
+  aarch64_emit_div_signed,
+  aarch64_emit_div_unsigned,
+  aarch64_emit_rem_signed,
+  aarch64_emit_rem_unsigned,
 };
 
 /* Implementation of linux_target_ops method "emit_ops".  */
@@ -1645,25 +1645,121 @@ amd64_emit_sub (void)
 static void
 amd64_emit_mul (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_mul,
+	    "imul (%rsp),%rax\n\t"
+	    "lea 0x8(%rsp),%rsp");
 }
 
 static void
 amd64_emit_lsh (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_lsh,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "shl %cl,%rax");
 }
 
 static void
 amd64_emit_rsh_signed (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_rsh_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "sar %cl,%rax");
 }
 
 static void
 amd64_emit_rsh_unsigned (void)
 {
-  emit_error = 1;
+  EMIT_ASM (amd64_rsh_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "shr %cl,%rax");
+}
+
+/* The division and remainder sequences below leave the compiled
+   expression with this value in %rax when the divisor is zero, as the
+   interpreter does.  Dividing the most negative number by -1 would
+   trap, so the signed sequences handle a divisor of -1 by hand.  */
+
+gdb_static_assert (expr_eval_divide_by_zero == 7);
+
+static void
+amd64_emit_div_signed (void)
+{
+  EMIT_ASM (amd64_div_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "test %rcx,%rcx\n\t"
+	    "jne .Lamd64_div_signed_nonzero\n\t"
+	    "mov $7,%eax\n\t"
+	    "leave\n\t"
+	    "ret\n\t"
+	    ".Lamd64_div_signed_nonzero:\n\t"
+	    "cmp $-1,%rcx\n\t"
+	    "jne .Lamd64_div_signed_divide\n\t"
+	    "neg %rax\n\t"
+	    "jmp .Lamd64_div_signed_end\n\t"
+	    ".Lamd64_div_signed_divide:\n\t"
+	    "cqo\n\t"
+	    "idiv %rcx\n\t"
+	    ".Lamd64_div_signed_end:");
+}
+
+static void
+amd64_emit_div_unsigned (void)
+{
+  EMIT_ASM (amd64_div_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "test %rcx,%rcx\n\t"
+	    "jne .Lamd64_div_unsigned_nonzero\n\t"
+	    "mov $7,%eax\n\t"
+	    "leave\n\t"
+	    "ret\n\t"
+	    ".Lamd64_div_unsigned_nonzero:\n\t"
+	    "xor %edx,%edx\n\t"
+	    "div %rcx");
+}
+
+static void
+amd64_emit_rem_signed (void)
+{
+  EMIT_ASM (amd64_rem_signed,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "test %rcx,%rcx\n\t"
+	    "jne .Lamd64_rem_signed_nonzero\n\t"
+	    "mov $7,%eax\n\t"
+	    "leave\n\t"
+	    "ret\n\t"
+	    ".Lamd64_rem_signed_nonzero:\n\t"
+	    "cmp $-1,%rcx\n\t"
+	    "jne .Lamd64_rem_signed_divide\n\t"
+	    "xor %eax,%eax\n\t"
+	    "jmp .Lamd64_rem_signed_end\n\t"
+	    ".Lamd64_rem_signed_divide:\n\t"
+	    "cqo\n\t"
+	    "idiv %rcx\n\t"
+	    "mov %rdx,%rax\n\t"
+	    ".Lamd64_rem_signed_end:");
+}
+
+static void
+amd64_emit_rem_unsigned (void)
+{
+  EMIT_ASM (amd64_rem_unsigned,
+	    "mov %rax,%rcx\n\t"
+	    "pop %rax\n\t"
+	    "test %rcx,%rcx\n\t"
+	    "jne .Lamd64_rem_unsigned_nonzero\n\t"
+	    "mov $7,%eax\n\t"
+	    "leave\n\t"
+	    "ret\n\t"
+	    ".Lamd64_rem_unsigned_nonzero:\n\t"
+	    "xor %edx,%edx\n\t"
+	    "div %rcx\n\t"
+	    "mov %rdx,%rax");
 }
 
 static void
@@ -2182,7 +2278,11 @@ struct emit_ops amd64_emit_ops =
     amd64_emit_lt_goto,
     amd64_emit_le_goto,
     amd64_emit_gt_goto,
-    amd64_emit_ge_goto
+    amd64_emit_ge_goto,
+    amd64_emit_div_signed,
+    amd64_emit_div_unsigned,
+    amd64_emit_rem_signed,
+    amd64_emit_rem_unsigned
   };
 
 #endif /* __x86_64__ */
@@ -2035,6 +2035,103 @@ supported_btrace_packets (char *buf)
   strcat (buf, ";qXfer:btrace-conf:read+");
 }
 
+/* Write the reply to a 'g' packet to BUF, which must have room for
+   all the registers.  */
+
+static void
+handle_g_packet (char *buf)
+{
+  if (current_traceframe >= 0)
+    {
+      struct regcache *regcache
+	= new_register_cache (current_target_desc ());
+
+      if (fetch_traceframe_registers (current_traceframe,
+				      regcache, -1) == 0)
+	registers_to_string (regcache, buf);
+      else
+	write_enn (buf);
+      free_register_cache (regcache);
+    }
+  else
+    {
+      struct regcache *regcache;
+
+      if (!set_desired_thread (1))
+	write_enn (buf);
+      else
+	{
+	  regcache = get_thread_regcache (current_thread, 1);
+	  registers_to_string (regcache, buf);
+	}
+    }
+}
+
+/* Handle the 'm' packet in BUF, replacing it with the reply.  */
+
+static void
+handle_m_packet (char *buf)
+{
+  CORE_ADDR mem_addr;
+  unsigned int len;
+  int res;
+
+  decode_m_packet (&buf[1], &mem_addr, &len);
+  if (len > (PBUFSIZ - 1) / 2)
+    len = (PBUFSIZ - 1) / 2;
+  res = gdb_read_memory (mem_addr, mem_buf, len);
+  if (res < 0)
+    write_enn (buf);
+  else
+    bin2hex (mem_buf, buf, res);
+}
+
+/* Handle a qBatch packet, whose requests start at REQUESTS.  The
+   requests are 'g' and 'm' packets separated by ';'; reply to each
+   in turn, separating the replies with ';' too, in OWN_BUF.  Any
+   other request fails the whole batch.  */
+
+static void
+handle_qbatch (char *own_buf, const char *requests)
+{
+  std::string reply;
+  /* The replies of the individual requests.  Each fits in a packet
+     on its own.  */
+  gdb::unique_xmalloc_ptr<char> one_reply ((char *) xmalloc (PBUFSIZ + 1));
+  gdb::unique_xmalloc_ptr<char> copy (xstrdup (requests));
+  char *saveptr;
+
+  for (char *request = strtok_r (copy.get (), ";", &saveptr);
+       request != NULL;
+       request = strtok_r (NULL, ";", &saveptr))
+    {
+      if (strcmp (request, "g") == 0)
+	handle_g_packet (one_reply.get ());
+      else if (request[0] == 'm')
+	{
+	  strcpy (one_reply.get (), request);
+	  handle_m_packet (one_reply.get ());
+	}
+      else
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+
+      if (!reply.empty ())
+	reply += ';';
+      reply += one_reply.get ();
+
+      if (reply.size () > PBUFSIZ - 1)
+	{
+	  write_enn (own_buf);
+	  return;
+	}
+    }
+
+  strcpy (own_buf, reply.c_str ());
+}
+
 /* Handle all of the extended 'q' packets.  */
 
 static void
@@ -2042,6 +2139,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 {
   static struct inferior_list_entry *thread_ptr;
 
+  if (startswith (own_buf, "qBatch:"))
+    {
+      require_running (own_buf);
+      handle_qbatch (own_buf, own_buf + strlen ("qBatch:"));
+      return;
+    }
+
   /* Reply the current thread id.  */
   if (strcmp ("qC", own_buf) == 0 && !disable_packet_qC)
     {
@@ -2372,6 +2476,10 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";no-resumed+");
 
+      /* We process the packets GDB sends one after the other, so
+	 accepting pipelined requests comes for free.  */
+      strcat (own_buf, ";qBatch+");
+
       /* Reinitialize components as needed for the new connection.  */
       hostio_handle_new_gdb_connection ();
       target_handle_new_gdb_connection ();
@@ -4105,30 +4213,7 @@ process_serial_event (void)
       break;
     case 'g':
       require_running (own_buf);
-      if (current_traceframe >= 0)
-	{
-	  struct regcache *regcache
-	    = new_register_cache (current_target_desc ());
-
-	  if (fetch_traceframe_registers (current_traceframe,
-					  regcache, -1) == 0)
-	    registers_to_string (regcache, own_buf);
-	  else
-	    write_enn (own_buf);
-	  free_register_cache (regcache);
-	}
-      else
-	{
-	  struct regcache *regcache;
-
-	  if (!set_desired_thread (1))
-	    write_enn (own_buf);
-	  else
-	    {
-	      regcache = get_thread_regcache (current_thread, 1);
-	      registers_to_string (regcache, own_buf);
-	    }
-	}
+      handle_g_packet (own_buf);
       break;
     case 'G':
       require_running (own_buf);
@@ -4150,12 +4235,7 @@ process_serial_event (void)
       break;
     case 'm':
       require_running (own_buf);
-      decode_m_packet (&own_buf[1], &mem_addr, &len);
-      res = gdb_read_memory (mem_addr, mem_buf, len);
-      if (res < 0)
-	write_enn (own_buf);
-      else
-	bin2hex (mem_buf, own_buf, res);
+      handle_m_packet (own_buf);
       break;
     case 'M':
       require_running (own_buf);
@@ -66,6 +66,10 @@
 #include "objfiles.h"
 #include "nat/linux-namespaces.h"
 #include "fileio.h"
+#include "target-dcache.h"
+#ifdef HAVE_PROCESS_VM_READV
+#include <sys/uio.h>
+#endif
 
 #ifndef SPUFS_MAGIC
 #define SPUFS_MAGIC 0x23c9b64e
@@ -306,6 +310,9 @@ static struct lwp_info *find_lwp_pid (ptid_t ptid);
 
 static int lwp_status_pending_p (struct lwp_info *lp);
 
+static void linux_proc_mem_invalidate (pid_t pid);
+static void linux_proc_mem_forget (pid_t pid);
+
 static int sigtrap_is_event (int status);
 static int (*linux_nat_status_is_event) (int status) = sigtrap_is_event;
 
@@ -533,6 +540,10 @@ linux_child_follow_fork (struct target_ops *ops, int follow_child,
 	      ptrace (PTRACE_DETACH, child_pid, 0, signo);
 	    }
 
+	  /* Removing the breakpoints from the child went through its
+	     /proc mem file; close it now that the child is gone.  */
+	  linux_proc_mem_forget (child_pid);
+
 	  /* Resets value of inferior_ptid to parent ptid.  */
 	  do_cleanups (old_chain);
 	}
@@ -1518,6 +1529,8 @@ linux_nat_detach (struct target_ops *ops, const char *args, int from_tty)
 
   iterate_over_lwps (pid_to_ptid (pid), detach_callback, NULL);
 
+  linux_proc_mem_forget (pid);
+
   /* Only the initial process should be left right now.  */
   gdb_assert (num_lwps (ptid_get_pid (inferior_ptid)) == 1);
 
@@ -1586,6 +1599,7 @@ linux_resume_one_lwp_throw (struct lwp_info *lp, int step,
   lp->core = -1;
   lp->stop_reason = TARGET_STOPPED_BY_NO_REASON;
   registers_changed_ptid (lp->ptid);
+  linux_proc_mem_invalidate (ptid_get_pid (lp->ptid));
 }
 
 /* Called when we try to resume a stopped LWP and that errors out.  If
@@ -2032,6 +2046,7 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
 	  /* This won't actually modify the breakpoint list, but will
 	     physically remove the breakpoints from the child.  */
 	  detach_breakpoints (ptid_build (new_pid, new_pid, 0));
+	  linux_proc_mem_forget (new_pid);
 
 	  /* Retain child fork in ptrace (stopped) state.  */
 	  if (!find_fork_pid (new_pid))
@@ -2130,6 +2145,9 @@ linux_handle_extended_wait (struct lwp_info *lp, int status)
       ourstatus->value.execd_pathname
 	= xstrdup (linux_child_pid_to_exec_file (NULL, pid));
 
+      /* The process has a new address space.  */
+      linux_proc_mem_forget (pid);
+
       /* The thread that execed must have been resumed, but, when a
 	 thread execs, it changes its tid to the tgid, and the old
 	 tgid thread might have not been resumed.  */
@@ -3802,6 +3820,8 @@ linux_nat_mourn_inferior (struct target_ops *ops)
        one and context-switch to the first available.  */
     linux_fork_mourn_inferior ();
 
+  linux_proc_mem_forget (pid);
+
   /* Let the arch-specific native code know this process is gone.  */
   linux_nat_forget_process (pid);
 }
@@ -3970,9 +3990,276 @@ linux_child_pid_to_exec_file (struct target_ops *self, int pid)
   return linux_proc_pid_to_exec_file (pid);
 }
 
-/* Implement the to_xfer_partial target method using /proc/<pid>/mem.
-   Because we can use a single read/write call, this can be much more
-   efficient than banging away at PTRACE_PEEKTEXT.  */
+/* Fast access to the memory of a process, bypassing ptrace.
+
+   Each process gets a /proc/PID/task/LWP/mem file descriptor, opened
+   on first use and kept until the process execs, exits or is detached,
+   so that small accesses cost a single system call.  Reads are first
+   tried with process_vm_readv, which does not need the descriptor.
+
+   Pretty-printers walking big data structures make many small reads
+   at increasing addresses.  When reads are seen to be sequential, a
+   growing window of memory following them is read with
+   process_vm_readv into a buffer, which serves the following reads.
+   The buffer is dropped whenever the target dcache is invalidated,
+   whenever a thread of the process is resumed, and on any write, so
+   it lives no longer than the dcache would.  Reading ahead uses
+   process_vm_readv only: unlike /proc/PID/mem, it does not read
+   device mappings, which might have side effects.  */
+
+struct linux_proc_mem
+{
+  struct linux_proc_mem *next;
+
+  /* The process.  */
+  pid_t pid;
+
+  /* The open /proc/PID/task/LWP/mem file, or -1 if not opened yet.  */
+  int fd;
+
+  /* Nonzero if opening the file failed; ptrace is used instead.  */
+  int fd_failed;
+
+  /* Nonzero if process_vm_readv is not usable for this process.  */
+  int no_vm_readv;
+
+  /* The readahead buffer, holding RA_LEN bytes read from RA_START.
+     It is valid if RA_LEN is not zero and RA_GENERATION is the current
+     target_dcache_generation.  */
+  gdb_byte *ra_buf;
+  CORE_ADDR ra_start;
+  ULONGEST ra_len;
+  unsigned int ra_generation;
+
+  /* The end of the last read, to detect sequential reads, and the
+     size of the next readahead, zero if reads are not sequential.  */
+  CORE_ADDR last_read_end;
+  ULONGEST ra_window;
+};
+
+/* The processes whose memory was accessed.  */
+
+static struct linux_proc_mem *linux_proc_mem_list;
+
+/* The first and the largest readahead sizes.  */
+
+#define LINUX_PROC_MEM_RA_MIN 4096
+#define LINUX_PROC_MEM_RA_MAX (256 * 1024)
+
+/* Reads starting at most this far past the end of the previous read
+   still count as sequential, so that walking an array of structures
+   whose members are read one by one is detected.  */
+
+#define LINUX_PROC_MEM_RA_GAP 256
+
+/* Return the memory access state of process PID, creating it if
+   necessary.  */
+
+static struct linux_proc_mem *
+linux_proc_mem_get (pid_t pid)
+{
+  struct linux_proc_mem *mem;
+
+  for (mem = linux_proc_mem_list; mem != NULL; mem = mem->next)
+    if (mem->pid == pid)
+      return mem;
+
+  mem = XCNEW (struct linux_proc_mem);
+  mem->pid = pid;
+  mem->fd = -1;
+  mem->next = linux_proc_mem_list;
+  linux_proc_mem_list = mem;
+  return mem;
+}
+
+/* Drop the readahead buffer of process PID, if any.  */
+
+static void
+linux_proc_mem_invalidate (pid_t pid)
+{
+  struct linux_proc_mem *mem;
+
+  for (mem = linux_proc_mem_list; mem != NULL; mem = mem->next)
+    if (mem->pid == pid)
+      {
+	mem->ra_len = 0;
+	mem->ra_window = 0;
+	break;
+      }
+}
+
+/* Forget the memory access state of process PID, closing its file.
+   Called when the process's address space goes away or changes.  */
+
+static void
+linux_proc_mem_forget (pid_t pid)
+{
+  struct linux_proc_mem **slot;
+
+  for (slot = &linux_proc_mem_list; *slot != NULL; slot = &(*slot)->next)
+    if ((*slot)->pid == pid)
+      {
+	struct linux_proc_mem *mem = *slot;
+
+	*slot = mem->next;
+	if (mem->fd >= 0)
+	  close (mem->fd);
+	xfree (mem->ra_buf);
+	xfree (mem);
+	break;
+      }
+}
+
+/* Return the /proc/PID/task/LWP/mem file descriptor of MEM, opening it
+   through LWP if necessary, or -1 if it cannot be opened.  */
+
+static int
+linux_proc_mem_fd (struct linux_proc_mem *mem, long lwp)
+{
+  char filename[64];
+
+  if (mem->fd >= 0 || mem->fd_failed)
+    return mem->fd;
+
+  xsnprintf (filename, sizeof filename, "/proc/%ld/task/%ld/mem",
+	     (long) mem->pid, lwp);
+  mem->fd = gdb_open_cloexec (filename, O_RDWR | O_LARGEFILE, 0);
+  if (mem->fd == -1)
+    {
+      /* Writes will go through ptrace.  */
+      mem->fd = gdb_open_cloexec (filename, O_RDONLY | O_LARGEFILE, 0);
+    }
+  if (mem->fd == -1)
+    mem->fd_failed = 1;
+
+  if (debug_linux_nat)
+    fprintf_unfiltered (gdb_stdlog,
+			"LPM: opening %s %s\n", filename,
+			mem->fd == -1 ? safe_strerror (errno) : "succeeded");
+
+  return mem->fd;
+}
+
+/* Read up to LEN bytes at OFFSET in the memory of LWP, which belongs
+   to MEM's process, with process_vm_readv.  Return the number of bytes
+   read, or -1.  */
+
+static LONGEST
+linux_proc_mem_vm_readv (struct linux_proc_mem *mem, long lwp,
+			 gdb_byte *readbuf, ULONGEST offset, ULONGEST len)
+{
+#ifdef HAVE_PROCESS_VM_READV
+  struct iovec local, remote;
+  ssize_t ret;
+
+  if (mem->no_vm_readv)
+    return -1;
+
+  local.iov_base = readbuf;
+  local.iov_len = len;
+  remote.iov_base = (void *) (uintptr_t) offset;
+  remote.iov_len = len;
+
+  /* The remote address must fit in a pointer of ours.  */
+  if ((ULONGEST) (uintptr_t) remote.iov_base != offset)
+    return -1;
+
+  ret = process_vm_readv (lwp, &local, 1, &remote, 1, 0);
+  if (ret == -1 && (errno == ENOSYS || errno == EPERM))
+    {
+      if (debug_linux_nat)
+	fprintf_unfiltered (gdb_stdlog,
+			    "LPM: process_vm_readv unusable for %ld: %s\n",
+			    (long) mem->pid, safe_strerror (errno));
+      mem->no_vm_readv = 1;
+    }
+
+  return ret;
+#else
+  return -1;
+#endif
+}
+
+/* Callback for iterate_over_lwps.  Return true if LP is running.  */
+
+static int
+linux_proc_mem_running_callback (struct lwp_info *lp, void *data)
+{
+  return !lp->stopped;
+}
+
+/* Try to satisfy a read of LEN bytes at OFFSET from MEM's readahead
+   buffer, refilling it if the reads look sequential.  Return the
+   number of bytes read, or 0.  */
+
+static ULONGEST
+linux_proc_mem_readahead (struct linux_proc_mem *mem, long lwp,
+			  gdb_byte *readbuf, ULONGEST offset, ULONGEST len)
+{
+  unsigned int generation = target_dcache_generation ();
+
+  if (mem->ra_len != 0 && mem->ra_generation != generation)
+    {
+      mem->ra_len = 0;
+      mem->ra_window = 0;
+    }
+
+  if (mem->ra_len != 0
+      && offset >= mem->ra_start
+      && offset + len <= mem->ra_start + mem->ra_len)
+    {
+      memcpy (readbuf, mem->ra_buf + (offset - mem->ra_start), len);
+      mem->last_read_end = offset + len;
+      return len;
+    }
+
+  /* Grow the window while the reads stay sequential.  */
+  if (offset >= mem->last_read_end
+      && offset - mem->last_read_end <= LINUX_PROC_MEM_RA_GAP)
+    {
+      if (mem->ra_window == 0)
+	mem->ra_window = LINUX_PROC_MEM_RA_MIN / 2;
+      else if (mem->ra_window < LINUX_PROC_MEM_RA_MAX)
+	mem->ra_window *= 2;
+    }
+  else
+    mem->ra_window = 0;
+  mem->last_read_end = offset + len;
+
+  /* Reading ahead does not pay for the first sequential read, nor
+     for reads as big as the window.  Nor is it safe while threads of
+     the process run and may change its memory.  */
+  if (mem->ra_window < LINUX_PROC_MEM_RA_MIN || len >= mem->ra_window
+      || iterate_over_lwps (pid_to_ptid (mem->pid),
+			    linux_proc_mem_running_callback, NULL) != NULL)
+    return 0;
+
+  if (mem->ra_buf == NULL)
+    mem->ra_buf = (gdb_byte *) xmalloc (LINUX_PROC_MEM_RA_MAX);
+
+  mem->ra_len = 0;
+  LONGEST ret = linux_proc_mem_vm_readv (mem, lwp, mem->ra_buf, offset,
+					 mem->ra_window);
+  if (ret <= 0)
+    return 0;
+  if (ret < (LONGEST) len)
+    {
+      /* The read stopped at an unreadable page; let the caller get the
+	 rest some other way.  */
+      memcpy (readbuf, mem->ra_buf, ret);
+      return ret;
+    }
+
+  mem->ra_start = offset;
+  mem->ra_len = ret;
+  mem->ra_generation = generation;
+  memcpy (readbuf, mem->ra_buf, len);
+  return len;
+}
+
+/* Implement the to_xfer_partial target method for memory without
+   ptrace, as described above.  Return TARGET_XFER_EOF to have the
+   caller fall back to ptrace.  */
 
 static enum target_xfer_status
 linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
@@ -3980,23 +4267,44 @@ linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
 			 const gdb_byte *writebuf,
 			 ULONGEST offset, LONGEST len, ULONGEST *xfered_len)
 {
+  struct linux_proc_mem *mem;
+  long lwp;
   LONGEST ret;
   int fd;
-  char filename[64];
 
   if (object != TARGET_OBJECT_MEMORY)
     return TARGET_XFER_EOF;
 
-  /* Don't bother for one word.  */
-  if (len < 3 * sizeof (long))
-    return TARGET_XFER_EOF;
+  lwp = ptid_get_lwp (inferior_ptid);
+  if (lwp == 0)
+    lwp = ptid_get_pid (inferior_ptid);
+  mem = linux_proc_mem_get (ptid_get_pid (inferior_ptid));
 
-  /* We could keep this file open and cache it - possibly one per
-     thread.  That requires some juggling, but is even faster.  */
-  xsnprintf (filename, sizeof filename, "/proc/%ld/mem",
-	     ptid_get_lwp (inferior_ptid));
-  fd = gdb_open_cloexec (filename, ((readbuf ? O_RDONLY : O_WRONLY)
-				    | O_LARGEFILE), 0);
+  if (readbuf != NULL)
+    {
+      ULONGEST done = linux_proc_mem_readahead (mem, lwp, readbuf,
+						 offset, len);
+
+      if (done != 0)
+	{
+	  *xfered_len = done;
+	  return TARGET_XFER_OK;
+	}
+
+      ret = linux_proc_mem_vm_readv (mem, lwp, readbuf, offset, len);
+      if (ret > 0)
+	{
+	  *xfered_len = ret;
+	  return TARGET_XFER_OK;
+	}
+    }
+  else
+    {
+      mem->ra_len = 0;
+      mem->ra_window = 0;
+    }
+
+  fd = linux_proc_mem_fd (mem, lwp);
   if (fd == -1)
     return TARGET_XFER_EOF;
 
@@ -4013,8 +4321,6 @@ linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
 	   : write (fd, writebuf, len));
 #endif
 
-  close (fd);
-
   if (ret == -1 || ret == 0)
     return TARGET_XFER_EOF;
   else
@@ -4024,7 +4330,6 @@ linux_proc_xfer_partial (struct target_ops *ops, enum target_object object,
     }
 }
 
-
 /* Enumerate spufs IDs for process PID.  */
 static LONGEST
 spu_enumerate_spu_ids (int pid, gdb_byte *buf, ULONGEST offset, ULONGEST len)
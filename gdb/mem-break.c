@@ -24,6 +24,8 @@
 #include "breakpoint.h"
 #include "inferior.h"
 #include "target.h"
+#include <map>
+#include <memory>
 /* Insert a breakpoint on targets that don't have any better
    breakpoint support.  We read the contents of the target location
    and stash it, then overwrite it with a breakpoint instruction.
@@ -33,6 +35,147 @@
    long enough to save BREAKPOINT_LEN bytes (this is accomplished via
    BREAKPOINT_MAX).  */
 
+/* Software breakpoint insertions are batched per page of this size,
+   so that inserting many breakpoints close to each other takes one read
+   and one write per page.  */
+
+#define BREAKPOINT_BATCH_PAGE_SIZE 4096
+
+/* A page of target memory holding batched breakpoint insertions.  */
+
+struct breakpoint_batch_page
+{
+  /* True if reading the page succeeded.  Breakpoints in unreadable
+     pages are inserted one at a time.  */
+  bool readable;
+
+  /* The contents of the page, as they are in the target plus the
+     breakpoint instructions batched so far.  */
+  gdb_byte contents[BREAKPOINT_BATCH_PAGE_SIZE];
+
+  /* The range of addresses patched by batched breakpoints.  */
+  CORE_ADDR dirty_begin;
+  CORE_ADDR dirty_end;
+
+  /* The breakpoints batched in this page.  */
+  std::vector<struct bp_target_info *> bps;
+};
+
+/* True between begin_memory_breakpoint_batch and
+   end_memory_breakpoint_batch.  */
+
+static bool breakpoint_batch_active;
+
+/* The pages touched by the current batch, indexed by address.  */
+
+static std::map<CORE_ADDR, std::unique_ptr<breakpoint_batch_page>>
+  breakpoint_batch_pages;
+
+/* See target.h.  */
+
+void
+begin_memory_breakpoint_batch (void)
+{
+  gdb_assert (!breakpoint_batch_active);
+  gdb_assert (breakpoint_batch_pages.empty ());
+
+  breakpoint_batch_active = true;
+}
+
+/* See target.h.  */
+
+std::vector<struct bp_target_info *>
+end_memory_breakpoint_batch (void)
+{
+  std::vector<struct bp_target_info *> failed;
+
+  breakpoint_batch_active = false;
+
+  for (const auto &entry : breakpoint_batch_pages)
+    {
+      const breakpoint_batch_page &page = *entry.second;
+      CORE_ADDR page_addr = entry.first;
+
+      if (page.bps.empty ())
+	continue;
+
+      if (target_write_raw_memory (page.dirty_begin,
+				   page.contents
+				   + (page.dirty_begin - page_addr),
+				   page.dirty_end - page.dirty_begin) == 0)
+	continue;
+
+      /* Fall back to writing the breakpoints one at a time, to find
+	 out which ones failed.  */
+      for (struct bp_target_info *bp_tgt : page.bps)
+	if (target_write_raw_memory (bp_tgt->placed_address,
+				     page.contents
+				     + (bp_tgt->placed_address - page_addr),
+				     bp_tgt->shadow_len) != 0)
+	  failed.push_back (bp_tgt);
+    }
+
+  breakpoint_batch_pages.clear ();
+  return failed;
+}
+
+/* If a batch is open, add the insertion of the BPLEN bytes long
+   breakpoint instruction BP described by BP_TGT to it, saving the
+   shadow contents, and return true.  Return false if the breakpoint
+   must be inserted directly.  */
+
+static bool
+batch_memory_insert_breakpoint (struct bp_target_info *bp_tgt,
+				const gdb_byte *bp, int bplen)
+{
+  CORE_ADDR addr = bp_tgt->placed_address;
+  CORE_ADDR page_addr = addr & ~(CORE_ADDR) (BREAKPOINT_BATCH_PAGE_SIZE - 1);
+  breakpoint_batch_page *page;
+  gdb_byte *readbuf;
+
+  if (!breakpoint_batch_active
+      || addr + bplen > page_addr + BREAKPOINT_BATCH_PAGE_SIZE)
+    return false;
+
+  std::unique_ptr<breakpoint_batch_page> &slot
+    = breakpoint_batch_pages[page_addr];
+  if (slot == NULL)
+    {
+      slot.reset (new breakpoint_batch_page ());
+      slot->readable = (target_read_raw_memory (page_addr, slot->contents,
+						BREAKPOINT_BATCH_PAGE_SIZE)
+			== 0);
+    }
+  page = slot.get ();
+  if (!page->readable)
+    return false;
+
+  /* The shadow contents are what a read would return, with the
+     breakpoints already inserted masked out.  */
+  readbuf = (gdb_byte *) alloca (bplen);
+  memcpy (readbuf, page->contents + (addr - page_addr), bplen);
+  breakpoint_xfer_memory (readbuf, NULL, NULL, addr, bplen);
+
+  /* As in default_memory_insert_breakpoint, set these together.  */
+  bp_tgt->shadow_len = bplen;
+  memcpy (bp_tgt->shadow_contents, readbuf, bplen);
+
+  memcpy (page->contents + (addr - page_addr), bp, bplen);
+  if (page->bps.empty ())
+    {
+      page->dirty_begin = addr;
+      page->dirty_end = addr + bplen;
+    }
+  else
+    {
+      page->dirty_begin = std::min (page->dirty_begin, addr);
+      page->dirty_end = std::max (page->dirty_end, addr + bplen);
+    }
+  page->bps.push_back (bp_tgt);
+
+  return true;
+}
+
 int
 default_memory_insert_breakpoint (struct gdbarch *gdbarch,
 				  struct bp_target_info *bp_tgt)
@@ -46,6 +189,9 @@ default_memory_insert_breakpoint (struct gdbarch *gdbarch,
   /* Determine appropriate breakpoint contents and size for this address.  */
   bp = gdbarch_sw_breakpoint_from_kind (gdbarch, bp_tgt->kind, &bplen);
 
+  if (batch_memory_insert_breakpoint (bp_tgt, bp, bplen))
+    return 0;
+
   /* Save the memory contents in the shadow_contents buffer and then
      write the breakpoint instruction.  */
   readbuf = (gdb_byte *) alloca (bplen);
@@ -51,6 +51,13 @@
 #include "language.h"
 #include "cli/cli-utils.h"
 #include "symbol.h"
+#include "gdbcmd.h"
+#include "build-id.h"
+#include "dwarf-index-cache.h"
+#include "common/parallel-for.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -95,34 +102,53 @@ msymbol_hash (const char *string)
   return hash;
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym hash table, TABLE.  */
+/* The number of threads used to demangle and hash minimal symbols,
+   or -1 for one per CPU.  Used for "maint set minsym-threads".  */
+static int minsym_threads = -1;
+static void
+show_minsym_threads (struct ui_file *file, int from_tty,
+		     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of threads used to demangle and "
+			    "hash minimal symbols is %s.\n"),
+		    value);
+}
+
+/* The smallest number of new minimal symbols worth demangling in
+   another thread.  */
+#define MIN_MINSYMS_PER_DEMANGLE_THREAD 500
+
+/* The smallest number of minimal symbols worth hashing in another
+   thread.  Hashing is much cheaper than demangling.  */
+#define MIN_MINSYMS_PER_HASH_THREAD 20000
+
+/* Add the minimal symbol SYM, whose linkage name hashes to HASH_VALUE
+   modulo MINIMAL_SYMBOL_HASH_SIZE, to an objfile's minsym hash table,
+   TABLE.  */
 static void
 add_minsym_to_hash_table (struct minimal_symbol *sym,
-			  struct minimal_symbol **table)
+			  struct minimal_symbol **table,
+			  unsigned int hash_value)
 {
   if (sym->hash_next == NULL)
     {
-      unsigned int hash
-	= msymbol_hash (MSYMBOL_LINKAGE_NAME (sym)) % MINIMAL_SYMBOL_HASH_SIZE;
-
-      sym->hash_next = table[hash];
-      table[hash] = sym;
+      sym->hash_next = table[hash_value];
+      table[hash_value] = sym;
     }
 }
 
-/* Add the minimal symbol SYM to an objfile's minsym demangled hash table,
-   TABLE.  */
+/* Add the minimal symbol SYM, whose search name hashes to HASH_VALUE
+   modulo MINIMAL_SYMBOL_HASH_SIZE, to an objfile's minsym demangled
+   hash table, TABLE.  */
 static void
 add_minsym_to_demangled_hash_table (struct minimal_symbol *sym,
-                                  struct minimal_symbol **table)
+				    struct minimal_symbol **table,
+				    unsigned int hash_value)
 {
   if (sym->demangled_hash_next == NULL)
     {
-      unsigned int hash = msymbol_hash_iw (MSYMBOL_SEARCH_NAME (sym))
-	% MINIMAL_SYMBOL_HASH_SIZE;
-
-      sym->demangled_hash_next = table[hash];
-      table[hash] = sym;
+      sym->demangled_hash_next = table[hash_value];
+      table[hash_value] = sym;
     }
 }
 
@@ -1007,7 +1033,16 @@ minimal_symbol_reader::record_full (const char *name, int name_len,
   msymbol = &m_msym_bunch->contents[m_msym_bunch_index];
   MSYMBOL_SET_LANGUAGE (msymbol, language_auto,
 			&m_objfile->per_bfd->storage_obstack);
-  MSYMBOL_SET_NAMES (msymbol, name, name_len, copy_name, m_objfile);
+
+  /* Only save the linkage name for now; install demangles all the new
+     symbols at once.  */
+  if (copy_name || name[name_len] != '\0')
+    msymbol->mginfo.name
+      = (const char *) obstack_copy0 (&m_objfile->per_bfd->storage_obstack,
+				      name, name_len);
+  else
+    msymbol->mginfo.name = name;
+  msymbol->name_set = 0;
 
   SET_MSYMBOL_VALUE_ADDRESS (msymbol, address);
   MSYMBOL_SECTION (msymbol) = section;
@@ -1142,15 +1177,34 @@ compact_minimal_symbols (struct minimal_symbol *msymbol, int mcount,
   return (mcount);
 }
 
+/* The hash values of a minimal symbol, modulo MINIMAL_SYMBOL_HASH_SIZE,
+   as computed by build_minimal_symbol_hash_tables.  */
+
+struct minsym_hash_values
+{
+  /* The msymbol_hash value of the linkage name.  */
+  unsigned int name_hash;
+
+  /* The msymbol_hash_iw value of the search name, if it differs from
+     the linkage name.  */
+  unsigned int search_name_hash;
+};
+
 /* Build (or rebuild) the minimal symbol hash tables.  This is necessary
    after compacting or sorting the table since the entries move around
-   thus causing the internal minimal_symbol pointers to become jumbled.  */
+   thus causing the internal minimal_symbol pointers to become jumbled.
+
+   The hash values are computed by worker threads, then the symbols
+   are linked in table order, as a serial build would.  */
   
 static void
 build_minimal_symbol_hash_tables (struct objfile *objfile)
 {
   int i;
   struct minimal_symbol *msym;
+  struct minimal_symbol *msymbols = objfile->per_bfd->msymbols;
+  int count = objfile->per_bfd->minimal_symbol_count;
+  std::vector<minsym_hash_values> hash_values (count);
 
   /* Clear the hash tables.  */
   for (i = 0; i < MINIMAL_SYMBOL_HASH_SIZE; i++)
@@ -1159,22 +1213,303 @@ build_minimal_symbol_hash_tables (struct objfile *objfile)
       objfile->per_bfd->msymbol_demangled_hash[i] = 0;
     }
 
+  int n_threads = gdb::parallel_for_thread_count (minsym_threads, count,
+						  MIN_MINSYMS_PER_HASH_THREAD);
+  gdb::parallel_for_each
+    (msymbols, msymbols + count, n_threads,
+     [&] (struct minimal_symbol *start, struct minimal_symbol *end)
+     {
+       for (struct minimal_symbol *sym = start; sym < end; ++sym)
+	 {
+	   minsym_hash_values &values = hash_values[sym - msymbols];
+
+	   values.name_hash = (msymbol_hash (MSYMBOL_LINKAGE_NAME (sym))
+			       % MINIMAL_SYMBOL_HASH_SIZE);
+	   if (MSYMBOL_SEARCH_NAME (sym) != MSYMBOL_LINKAGE_NAME (sym))
+	     values.search_name_hash
+	       = (msymbol_hash_iw (MSYMBOL_SEARCH_NAME (sym))
+		  % MINIMAL_SYMBOL_HASH_SIZE);
+	 }
+     });
+
   /* Now, (re)insert the actual entries.  */
-  for ((i = objfile->per_bfd->minimal_symbol_count,
-	msym = objfile->per_bfd->msymbols);
-       i > 0;
-       i--, msym++)
+  for (i = 0, msym = msymbols; i < count; i++, msym++)
     {
       msym->hash_next = 0;
-      add_minsym_to_hash_table (msym, objfile->per_bfd->msymbol_hash);
+      add_minsym_to_hash_table (msym, objfile->per_bfd->msymbol_hash,
+				hash_values[i].name_hash);
 
       msym->demangled_hash_next = 0;
       if (MSYMBOL_SEARCH_NAME (msym) != MSYMBOL_LINKAGE_NAME (msym))
-	add_minsym_to_demangled_hash_table (msym,
-                                            objfile->per_bfd->msymbol_demangled_hash);
+	add_minsym_to_demangled_hash_table
+	  (msym, objfile->per_bfd->msymbol_demangled_hash,
+	   hash_values[i].search_name_hash);
+    }
+}
+
+/* The index cache keeps the demangled names of the minimal symbols of
+   objfiles with a build-id.  The file starts with
+   DEMANGLED_NAMES_MAGIC, then the number of languages of the GDB that
+   wrote it as a 4-byte little-endian number, since the languages are
+   stored by number.  Then comes one record per linkage name: the
+   language symbol_find_demangled_name found for a language_auto symbol,
+   as one byte, the linkage name, and the demangled name, which is empty
+   if the name does not demangle, both NUL-terminated.  */
+
+#define DEMANGLED_NAMES_MAGIC "GDBDMGL1"
+
+/* Hash and equality functions for NUL-terminated strings.  */
+
+struct minsym_name_hash
+{
+  size_t operator() (const char *name) const
+  {
+    return htab_hash_string (name);
+  }
+};
+
+struct minsym_name_eq
+{
+  bool operator() (const char *a, const char *b) const
+  {
+    return strcmp (a, b) == 0;
+  }
+};
+
+/* The demangled names of the minimal symbols of an objfile, as read
+   from the index cache.  */
+
+class cached_demangled_names
+{
+public:
+  /* Read the names cached for the objfile with build id BUILD_ID, if
+     any.  */
+  explicit cached_demangled_names (const struct bfd_build_id *build_id);
+
+  /* Look LINKAGE_NAME up.  If found, store in *RESULT its language and
+     a copy of its demangled name and return true.  This is safe to
+     call from several threads at once.  */
+  bool lookup (const char *linkage_name,
+	       struct symbol_demangle_result *result) const;
+
+  /* Append the cached records for the names not in SEEN to
+     CONTENTS.  */
+  void append_unseen (std::string *contents,
+		      const std::unordered_set<const char *,
+					       minsym_name_hash,
+					       minsym_name_eq> &seen) const;
+
+private:
+  /* The cache file, which the strings below point into.  */
+  std::unique_ptr<index_cache_resource> m_file;
+
+  /* The linkage names, in file order.  */
+  std::vector<const char *> m_names;
+
+  /* The language and demangled name of each linkage name.  */
+  std::unordered_map<const char *,
+		     std::pair<enum language, const char *>,
+		     minsym_name_hash, minsym_name_eq> m_map;
+};
+
+cached_demangled_names::cached_demangled_names
+  (const struct bfd_build_id *build_id)
+{
+  size_t magic_len = strlen (DEMANGLED_NAMES_MAGIC);
+
+  m_file = global_index_cache.lookup_demangled_names (build_id);
+  if (m_file == NULL)
+    return;
+
+  const char *data = (const char *) m_file->data ();
+  const char *end = data + m_file->size ();
+
+  if (m_file->size () < magic_len + 4
+      || memcmp (data, DEMANGLED_NAMES_MAGIC, magic_len) != 0
+      || (extract_unsigned_integer ((const gdb_byte *) data + magic_len,
+				    4, BFD_ENDIAN_LITTLE)
+	  != nr_languages))
+    {
+      m_file.reset ();
+      return;
+    }
+
+  for (const char *p = data + magic_len + 4; p < end; )
+    {
+      enum language language = (enum language) (unsigned char) *p++;
+      const char *name = p;
+      const char *name_end = (const char *) memchr (p, '\0', end - p);
+
+      if (language >= nr_languages || name_end == NULL)
+	break;
+
+      const char *demangled = name_end + 1;
+      const char *demangled_end
+	= (const char *) memchr (demangled, '\0', end - demangled);
+
+      if (demangled_end == NULL)
+	break;
+
+      if (m_map.emplace (name, std::make_pair (language, demangled)).second)
+	m_names.push_back (name);
+      p = demangled_end + 1;
     }
 }
 
+bool
+cached_demangled_names::lookup (const char *linkage_name,
+				struct symbol_demangle_result *result) const
+{
+  auto iter = m_map.find (linkage_name);
+
+  if (iter == m_map.end ())
+    return false;
+
+  result->language = iter->second.first;
+  if (iter->second.second[0] != '\0')
+    result->demangled = xstrdup (iter->second.second);
+  else
+    result->demangled = NULL;
+  return true;
+}
+
+/* Append a record for LINKAGE_NAME, of language LANGUAGE and with
+   demangled name DEMANGLED, or NULL, to the cache file CONTENTS.  */
+
+static void
+append_demangled_name (std::string *contents, const char *linkage_name,
+		       enum language language, const char *demangled)
+{
+  contents->push_back ((char) language);
+  contents->append (linkage_name);
+  contents->push_back ('\0');
+  if (demangled != NULL)
+    contents->append (demangled);
+  contents->push_back ('\0');
+}
+
+void
+cached_demangled_names::append_unseen
+  (std::string *contents,
+   const std::unordered_set<const char *, minsym_name_hash,
+			    minsym_name_eq> &seen) const
+{
+  for (const char *name : m_names)
+    if (seen.find (name) == seen.end ())
+      {
+	const std::pair<enum language, const char *> &value
+	  = m_map.find (name)->second;
+
+	append_demangled_name (contents, name, value.first, value.second);
+      }
+}
+
+/* Set the names of the minimal symbols among the MCOUNT at MSYMBOLS
+   which do not have them yet, the ones added since the last install.
+
+   Demangling is the expensive part: the new names are demangled by
+   worker threads, or taken from the index cache if it has them, then
+   the names are entered into the objfile's demangled names hash in
+   table order by the main thread, so the result does not depend on the
+   number of threads.  */
+
+static void
+set_minimal_symbol_names (struct objfile *objfile,
+			  struct minimal_symbol *msymbols, int mcount)
+{
+  std::vector<struct minimal_symbol *> todo;
+
+  for (int i = 0; i < mcount; ++i)
+    if (!msymbols[i].name_set)
+      todo.push_back (&msymbols[i]);
+
+  if (todo.empty ())
+    return;
+
+  const struct bfd_build_id *build_id = NULL;
+  if (global_index_cache.enabled ())
+    build_id = build_id_bfd_get (objfile->obfd);
+
+  std::unique_ptr<cached_demangled_names> cache;
+  if (build_id != NULL)
+    cache.reset (new cached_demangled_names (build_id));
+
+  std::vector<hashval_t> hashes (todo.size ());
+  std::vector<symbol_demangle_result> results (todo.size ());
+  std::vector<char> cached (todo.size ());
+
+  int n_threads
+    = gdb::parallel_for_thread_count (minsym_threads, todo.size (),
+				      MIN_MINSYMS_PER_DEMANGLE_THREAD);
+  gdb::parallel_for_each
+    (todo.begin (), todo.end (), n_threads,
+     [&] (std::vector<struct minimal_symbol *>::iterator start,
+	  std::vector<struct minimal_symbol *>::iterator end)
+     {
+       for (auto iter = start; iter < end; ++iter)
+	 {
+	   size_t idx = iter - todo.begin ();
+	   struct minimal_symbol *msym = *iter;
+	   const char *name = MSYMBOL_LINKAGE_NAME (msym);
+	   symbol_demangle_result &result = results[idx];
+
+	   hashes[idx] = htab_hash_string (name);
+
+	   if (cache != NULL && MSYMBOL_LANGUAGE (msym) == language_auto
+	       && cache->lookup (name, &result))
+	     {
+	       cached[idx] = 1;
+	       continue;
+	     }
+
+	   result.language = MSYMBOL_LANGUAGE (msym);
+	   result.demangled = symbol_find_demangled_name (&result.language,
+							   name);
+	 }
+     });
+
+  report_deferred_demangler_crash ();
+
+  /* Build the new cache file now, while the demangled names are still
+     around, if it is missing some of them.  */
+  std::string contents;
+  if (build_id != NULL
+      && std::find (cached.begin (), cached.end (), 0) != cached.end ())
+    {
+      std::unordered_set<const char *, minsym_name_hash,
+			 minsym_name_eq> seen;
+      uint32_t n_langs = nr_languages;
+      gdb_byte buf[4];
+
+      contents.append (DEMANGLED_NAMES_MAGIC);
+      store_unsigned_integer (buf, 4, BFD_ENDIAN_LITTLE, n_langs);
+      contents.append ((const char *) buf, 4);
+
+      for (size_t i = 0; i < todo.size (); ++i)
+	{
+	  const char *name = MSYMBOL_LINKAGE_NAME (todo[i]);
+
+	  if (seen.insert (name).second)
+	    append_demangled_name (&contents, name, results[i].language,
+				   results[i].demangled);
+	}
+
+      cache->append_unseen (&contents, seen);
+    }
+
+  for (size_t i = 0; i < todo.size (); ++i)
+    {
+      struct minimal_symbol *msym = todo[i];
+
+      symbol_set_demangled_names (&msym->mginfo, MSYMBOL_LINKAGE_NAME (msym),
+				  hashes[i], &results[i], objfile);
+      msym->name_set = 1;
+    }
+
+  if (!contents.empty ())
+    global_index_cache.store_demangled_names (build_id, contents);
+}
+
 /* Add the minimal symbols in the existing bunches to the objfile's official
    minimal symbol table.  In most cases there is no minimal symbol table yet
    for this objfile, and the existing bunches are used to create one.  Once
@@ -1282,6 +1617,12 @@ minimal_symbol_reader::install ()
 
       m_objfile->per_bfd->minimal_symbol_count = mcount;
       m_objfile->per_bfd->msymbols = msymbols;
+      xfree (m_objfile->per_bfd->msymbols_by_name);
+      m_objfile->per_bfd->msymbols_by_name = NULL;
+
+      /* Now that the table is in its final place, set the names of the
+	 new symbols.  */
+      set_minimal_symbol_names (m_objfile, msymbols, mcount);
 
       /* Now build the hash tables; we can't do this incrementally
          at an earlier point since we weren't finished with the obstack
@@ -1291,6 +1632,79 @@ minimal_symbol_reader::install ()
     }
 }
 
+/* Compare the LEN first bytes of NAME with PREFIX, as
+   compare_symbol_name does when completing.  */
+
+static int
+compare_minimal_symbol_prefix (const char *name, const char *prefix,
+			       size_t len, bool nocase)
+{
+  return nocase ? strncasecmp (name, prefix, len) : strncmp (name, prefix, len);
+}
+
+/* See minsyms.h.  */
+
+void
+iterate_over_minimal_symbols_with_prefix
+  (struct objfile *objf, const char *prefix, size_t len,
+   gdb::function_view<void (struct minimal_symbol *)> callback)
+{
+  struct objfile_per_bfd_storage *per_bfd = objf->per_bfd;
+  bool nocase = case_sensitivity == case_sensitive_off;
+  int count = per_bfd->minimal_symbol_count;
+
+  if (count == 0)
+    return;
+
+  if (per_bfd->msymbols_by_name == NULL
+      || per_bfd->msymbols_by_name_nocase != nocase)
+    {
+      /* The table is only reset by install, so an existing array still
+	 has room for COUNT symbols; re-sort it in place.  */
+      if (per_bfd->msymbols_by_name == NULL)
+	per_bfd->msymbols_by_name = XNEWVEC (struct minimal_symbol *, count);
+
+      struct minimal_symbol **sorted = per_bfd->msymbols_by_name;
+
+      for (int i = 0; i < count; i++)
+	sorted[i] = &per_bfd->msymbols[i];
+
+      std::sort (sorted, sorted + count,
+		 [=] (struct minimal_symbol *a, struct minimal_symbol *b)
+		 {
+		   const char *na = MSYMBOL_NATURAL_NAME (a);
+		   const char *nb = MSYMBOL_NATURAL_NAME (b);
+
+		   return (nocase ? strcasecmp (na, nb) : strcmp (na, nb)) < 0;
+		 });
+
+      per_bfd->msymbols_by_name_nocase = nocase;
+    }
+
+  struct minimal_symbol **first = per_bfd->msymbols_by_name;
+  struct minimal_symbol **last = first + count;
+
+  /* The names starting with PREFIX are those that compare neither
+     less nor greater than it on its first LEN bytes.  */
+  first = std::lower_bound (first, last, prefix,
+			    [=] (struct minimal_symbol *msym, const char *p)
+			    {
+			      return compare_minimal_symbol_prefix
+				(MSYMBOL_NATURAL_NAME (msym), p, len,
+				 nocase) < 0;
+			    });
+  last = std::upper_bound (first, last, prefix,
+			   [=] (const char *p, struct minimal_symbol *msym)
+			   {
+			     return compare_minimal_symbol_prefix
+			       (MSYMBOL_NATURAL_NAME (msym), p, len,
+				nocase) > 0;
+			   });
+
+  for (; first != last; ++first)
+    callback (*first);
+}
+
 /* See minsyms.h.  */
 
 void
@@ -1428,3 +1842,21 @@ minimal_symbol_upper_bound (struct bound_minimal_symbol minsym)
 
   return result;
 }
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_minsyms;
+
+void
+_initialize_minsyms (void)
+{
+  add_setshow_zuinteger_unlimited_cmd ("minsym-threads", class_maintenance,
+				       &minsym_threads, _("\
+Set the number of threads used to demangle and hash minimal symbols."), _("\
+Show the number of threads used to demangle and hash minimal symbols."), _("\
+Zero means to do everything on the main thread.  \"unlimited\" means\n\
+to use one thread per CPU."),
+				       NULL,
+				       show_minsym_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+}
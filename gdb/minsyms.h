@@ -263,6 +263,17 @@ void iterate_over_minimal_symbols (struct objfile *objf,
 						     void *),
 				   void *user_data);
 
+/* Call CALLBACK for each minimal symbol of OBJF whose natural name
+   starts with the LEN bytes at PREFIX, compared case-insensitively if
+   "set case-sensitive" is off, in order of natural name.  Unlike
+   walking all the minimal symbols, this only looks at the matching
+   ones, through an index sorted by name that is built the first time
+   it is needed.  */
+
+void iterate_over_minimal_symbols_with_prefix
+  (struct objfile *objf, const char *prefix, size_t len,
+   gdb::function_view<void (struct minimal_symbol *)> callback);
+
 /* Compute the upper bound of MINSYM.  The upper bound is the last
    address thought to be part of the symbol.  If the symbol has a
    size, it is used.  Otherwise use the lesser of the next minimal
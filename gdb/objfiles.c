@@ -171,6 +171,7 @@ free_objfile_per_bfd_storage (struct objfile_per_bfd_storage *storage)
   bcache_xfree (storage->macro_cache);
   if (storage->demangled_names_hash)
     htab_delete (storage->demangled_names_hash);
+  xfree (storage->msymbols_by_name);
   obstack_free (&storage->storage_obstack, 0);
 }
 
@@ -443,6 +444,7 @@ allocate_objfile (bfd *abfd, const char *name, objfile_flags flags)
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->new_objfiles_available = 1;
+  objfile->pspace->objfiles_generation++;
 
   return objfile;
 }
@@ -572,6 +574,7 @@ unlink_objfile (struct objfile *objfile)
 	{
 	  *objpp = (*objpp)->next;
 	  objfile->next = NULL;
+	  objfile->pspace->objfiles_generation++;
 	  return;
 	}
     }
@@ -899,6 +902,7 @@ objfile_relocate1 (struct objfile *objfile,
 
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (objfile->pspace)->section_map_dirty = 1;
+  objfile->pspace->objfiles_generation++;
 
   /* Update the table in exec_ops, used to read memory.  */
   ALL_OBJFILE_OSECTIONS (objfile, s)
@@ -1491,6 +1495,7 @@ objfiles_changed (void)
 {
   /* Rebuild section map next time we need it.  */
   get_objfile_pspace_data (current_program_space)->section_map_dirty = 1;
+  current_program_space->objfiles_generation++;
 }
 
 /* See comments in objfiles.h.  */
@@ -261,6 +261,15 @@ struct objfile_per_bfd_storage
      demangled names.  */
 
   struct minimal_symbol *msymbol_demangled_hash[MINIMAL_SYMBOL_HASH_SIZE];
+
+  /* The minimal symbols sorted by natural name, case-insensitively if
+     MSYMBOLS_BY_NAME_NOCASE, so that the symbols whose name starts
+     with a given prefix are next to each other.  Built on demand by
+     iterate_over_minimal_symbols_with_prefix, and freed when the
+     minimal symbol table changes.  Allocated with xmalloc.  */
+
+  struct minimal_symbol **msymbols_by_name;
+  unsigned int msymbols_by_name_nocase : 1;
 };
 
 /* Master structure for keeping track of each file from which
@@ -198,6 +198,12 @@ struct program_space
     /* Number of calls to solib_add.  */
     unsigned solib_add_generation;
 
+    /* Incremented whenever an objfile is added to or removed from
+       OBJFILES, moved within it, or relocated.  Caches of data
+       gathered from all the objfiles use it to tell when to rebuild
+       themselves.  */
+    unsigned objfiles_generation;
+
     /* When an solib is added, it is also added to this vector.  This
        is so we can properly report solib changes to the user.  */
     VEC (so_list_ptr) *added_solibs;
@@ -662,11 +662,17 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   struct gdbarch *gdbarch = get_type_arch (type);
   struct value *value;
   enum string_repr_result print_result;
-  const gdb_byte *valaddr = value_contents_for_printing (val);
 
-  /* No pretty-printer support for unavailable values.  */
-  if (!value_bytes_available (val, embedded_offset, TYPE_LENGTH (type)))
-    return EXT_LANG_RC_NOP;
+  /* No pretty-printer support for unavailable values.  An array
+     printed a window at a time is not fetched here, so that a printer
+     that does not want all of it does not read all of it.  */
+  if (!val_print_array_windowed_p (type, embedded_offset, val))
+    {
+      if (value_lazy (val))
+	value_fetch_lazy (val);
+      if (!value_bytes_available (val, embedded_offset, TYPE_LENGTH (type)))
+	return EXT_LANG_RC_NOP;
+    }
 
   if (!gdb_python_initialized)
     return EXT_LANG_RC_NOP;
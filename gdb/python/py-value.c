@@ -711,6 +711,126 @@ get_field_type (PyObject *field)
   return ftype;
 }
 
+#if defined (IS_PY3K)
+#define VALPY_PYSLICE(x) (x)
+#else
+#define VALPY_PYSLICE(x) ((PySliceObject *) x)
+#endif
+
+/* Implement slicing of arrays and pointers.  VALUE[START:STOP] is an
+   array, indexed from zero, of the elements from START up to STOP of
+   the array VALUE, or of the elements VALUE points to.  A slice of an
+   array in memory is not read from the inferior until it is used.
+   Returns NULL on error, with a python exception set.  */
+
+static PyObject *
+valpy_getslice (PyObject *self, PyObject *key)
+{
+  struct gdb_exception except = exception_none;
+  value_object *self_value = (value_object *) self;
+  struct type *elttype = NULL;
+  int is_array = 0;
+  LONGEST length = 0;
+  Py_ssize_t start, stop, step, slicelength;
+  PyObject *result = NULL;
+
+  TRY
+    {
+      scoped_value_mark free_values;
+      struct value *tmp = coerce_ref (self_value->value);
+      struct type *type = check_typedef (value_type (tmp));
+      LONGEST low_bound, high_bound;
+
+      if (TYPE_CODE (type) == TYPE_CODE_ARRAY)
+	{
+	  if (!get_array_bounds (type, &low_bound, &high_bound))
+	    error (_("Could not determine the array bounds."));
+	  is_array = 1;
+	  length = (high_bound >= low_bound
+		    ? high_bound - low_bound + 1 : 0);
+	}
+      else if (TYPE_CODE (type) != TYPE_CODE_PTR)
+	error (_("Cannot slice requested type."));
+      elttype = TYPE_TARGET_TYPE (type);
+    }
+  CATCH (ex, RETURN_MASK_ALL)
+    {
+      except = ex;
+    }
+  END_CATCH
+
+  GDB_PY_HANDLE_EXCEPTION (except);
+
+  if (is_array)
+    {
+      if (PySlice_GetIndicesEx (VALPY_PYSLICE (key), length, &start, &stop,
+				&step, &slicelength) != 0)
+	return NULL;
+    }
+  else
+    {
+      /* The length of what a pointer points to is unknown, so the
+	 slice must say where it starts and stops.  */
+      gdbpy_ref<> start_obj (PyObject_GetAttrString (key, "start"));
+      gdbpy_ref<> stop_obj (PyObject_GetAttrString (key, "stop"));
+      gdbpy_ref<> step_obj (PyObject_GetAttrString (key, "step"));
+      long start_val, stop_val, step_val = 1;
+
+      if (start_obj == NULL || stop_obj == NULL || step_obj == NULL)
+	return NULL;
+      if (start_obj == Py_None || stop_obj == Py_None)
+	{
+	  PyErr_SetString (PyExc_ValueError,
+			   _("A slice of a pointer needs a start and a stop."));
+	  return NULL;
+	}
+      if (!gdb_py_int_as_long (start_obj.get (), &start_val)
+	  || !gdb_py_int_as_long (stop_obj.get (), &stop_val)
+	  || (step_obj != Py_None
+	      && !gdb_py_int_as_long (step_obj.get (), &step_val)))
+	return NULL;
+      start = start_val;
+      stop = stop_val;
+      step = step_val;
+      slicelength = stop > start ? stop - start : 0;
+    }
+
+  if (step != 1)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("Slices with a step other than 1 are not "
+			 "supported."));
+      return NULL;
+    }
+
+  TRY
+    {
+      scoped_value_mark free_values;
+      struct value *tmp = coerce_ref (self_value->value);
+      struct type *slice_type
+	= lookup_array_range_type (elttype, 0, slicelength - 1);
+      LONGEST eltlen = TYPE_LENGTH (check_typedef (elttype));
+      struct value *res_val;
+
+      if (is_array)
+	res_val = value_from_component (tmp, slice_type, start * eltlen);
+      else
+	res_val = value_at_lazy (slice_type,
+				 value_as_address (value_ptradd (tmp, start)));
+
+      result = value_to_value_object (res_val);
+    }
+  CATCH (ex, RETURN_MASK_ALL)
+    {
+      except = ex;
+    }
+  END_CATCH
+
+  GDB_PY_HANDLE_EXCEPTION (except);
+
+  return result;
+}
+
 /* Given string name or a gdb.Field object corresponding to an element inside
    a structure, return its value object.  Returns NULL on error, with a python
    exception set.  */
@@ -725,6 +845,9 @@ valpy_getitem (PyObject *self, PyObject *key)
   long bitpos = -1;
   PyObject *result = NULL;
 
+  if (PySlice_Check (key))
+    return valpy_getslice (self, key);
+
   if (gdbpy_is_string (key))
     {
       field = python_string_to_host_string (key);
@@ -38,6 +38,7 @@
 #include "common/gdb_unlinker.h"
 
 #include <signal.h>
+#include <map>
 
 /* This module implements "target record-full", also known as "process
    record and replay".  This target sits on top of a "normal" target
@@ -155,6 +156,42 @@ struct record_full_entry
   } u;
 };
 
+/* The entries of the execution log are allocated from chunks of
+   RECORD_FULL_CHUNK_ENTRIES entries rather than one by one, which
+   saves the malloc overhead of each entry, and the time spent in
+   malloc when recording.  Released entries are kept on a free list
+   for reuse, and the chunks are freed once no entry is in use.  */
+
+#define RECORD_FULL_CHUNK_ENTRIES 1024
+
+struct record_full_chunk
+{
+  struct record_full_chunk *next;
+  struct record_full_entry entries[RECORD_FULL_CHUNK_ENTRIES];
+};
+
+/* The allocated chunks, most recent first.  */
+static struct record_full_chunk *record_full_chunks;
+
+/* Number of entries handed out from the most recent chunk.  */
+static unsigned int record_full_chunk_used;
+
+/* Released entries, linked through their NEXT field.  */
+static struct record_full_entry *record_full_free_entries;
+
+/* Number of entries in use.  */
+static ULONGEST record_full_live_entries;
+
+/* Every RECORD_FULL_CHECKPOINT_INTERVAL instructions, the end entry
+   of the instruction is recorded in RECORD_FULL_CHECKPOINTS, keyed by
+   instruction number, so that "record goto" and friends can find an
+   instruction by walking from the nearest checkpoint instead of from
+   the beginning of the log.  */
+
+#define RECORD_FULL_CHECKPOINT_INTERVAL 1024
+
+static std::map<ULONGEST, struct record_full_entry *> record_full_checkpoints;
+
 /* If true, query if PREC cannot record memory
    change of next instruction.  */
 int record_full_memory_query = 0;
@@ -234,6 +271,105 @@ static void record_full_goto_insn (struct record_full_entry *entry,
 static void record_full_save (struct target_ops *self,
 			      const char *recfilename);
 
+/* Allocate a zeroed execution log entry.  */
+
+static struct record_full_entry *
+record_full_entry_new (void)
+{
+  struct record_full_entry *rec;
+
+  if (record_full_free_entries != NULL)
+    {
+      rec = record_full_free_entries;
+      record_full_free_entries = rec->next;
+    }
+  else
+    {
+      if (record_full_chunks == NULL
+	  || record_full_chunk_used == RECORD_FULL_CHUNK_ENTRIES)
+	{
+	  struct record_full_chunk *chunk = XNEW (struct record_full_chunk);
+
+	  chunk->next = record_full_chunks;
+	  record_full_chunks = chunk;
+	  record_full_chunk_used = 0;
+	}
+      rec = &record_full_chunks->entries[record_full_chunk_used++];
+    }
+
+  record_full_live_entries++;
+  memset (rec, 0, sizeof (*rec));
+  return rec;
+}
+
+/* Give back REC, allocated by record_full_entry_new.  */
+
+static void
+record_full_entry_free (struct record_full_entry *rec)
+{
+  rec->next = record_full_free_entries;
+  record_full_free_entries = rec;
+
+  /* Free the chunks when the log is gone, so that its memory goes
+     back to the system.  */
+  if (--record_full_live_entries == 0)
+    {
+      while (record_full_chunks != NULL)
+	{
+	  struct record_full_chunk *chunk = record_full_chunks;
+
+	  record_full_chunks = chunk->next;
+	  xfree (chunk);
+	}
+      record_full_free_entries = NULL;
+      record_full_chunk_used = 0;
+    }
+}
+
+/* Record REC, the end entry of an instruction whose number was just
+   set, as a checkpoint if its number calls for one.  */
+
+static void
+record_full_checkpoint_add (struct record_full_entry *rec)
+{
+  gdb_assert (rec->type == record_full_end);
+
+  if (rec->u.end.insn_num % RECORD_FULL_CHECKPOINT_INTERVAL == 0)
+    record_full_checkpoints[rec->u.end.insn_num] = rec;
+}
+
+/* Return the end entry of instruction number INSN_NUM in the
+   execution log, or NULL if there is none.  */
+
+static struct record_full_entry *
+record_full_find_insn (ULONGEST insn_num)
+{
+  struct record_full_entry *p = &record_full_first;
+  auto it = record_full_checkpoints.upper_bound (insn_num);
+
+  /* Instruction numbers increase along the log, so start from the
+     last checkpoint at or before INSN_NUM, if any.  */
+  if (it != record_full_checkpoints.begin ())
+    p = (--it)->second;
+
+  for (; p != NULL; p = p->next)
+    if (p->type == record_full_end && p != &record_full_first)
+      {
+	if (p->u.end.insn_num == insn_num)
+	  return p;
+	if (p->u.end.insn_num > insn_num)
+	  break;
+      }
+
+  /* Not found where expected; fall back to searching the whole
+     log.  */
+  for (p = &record_full_first; p != NULL; p = p->next)
+    if (p->type == record_full_end && p->u.end.insn_num == insn_num)
+      return p;
+
+  return NULL;
+}
+
 /* Alloc and free functions for record_full_reg, record_full_mem, and
    record_full_end entries.  */
 
@@ -245,7 +381,7 @@ record_full_reg_alloc (struct regcache *regcache, int regnum)
   struct record_full_entry *rec;
   struct gdbarch *gdbarch = get_regcache_arch (regcache);
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_new ();
   rec->type = record_full_reg;
   rec->u.reg.num = regnum;
   rec->u.reg.len = register_size (gdbarch, regnum);
@@ -263,7 +399,7 @@ record_full_reg_release (struct record_full_entry *rec)
   gdb_assert (rec->type == record_full_reg);
   if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
     xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_mem record entry.  */
@@ -273,7 +409,7 @@ record_full_mem_alloc (CORE_ADDR addr, int len)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_new ();
   rec->type = record_full_mem;
   rec->u.mem.addr = addr;
   rec->u.mem.len = len;
@@ -291,7 +427,7 @@ record_full_mem_release (struct record_full_entry *rec)
   gdb_assert (rec->type == record_full_mem);
   if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
     xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  record_full_entry_free (rec);
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -301,7 +437,7 @@ record_full_end_alloc (void)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
+  rec = record_full_entry_new ();
   rec->type = record_full_end;
 
   return rec;
@@ -312,7 +448,11 @@ record_full_end_alloc (void)
 static inline void
 record_full_end_release (struct record_full_entry *rec)
 {
-  xfree (rec);
+  auto it = record_full_checkpoints.find (rec->u.end.insn_num);
+
+  if (it != record_full_checkpoints.end () && it->second == rec)
+    record_full_checkpoints.erase (it);
+  record_full_entry_free (rec);
 }
 
 /* Free one record entry, any type.
@@ -529,6 +669,7 @@ record_full_arch_list_add_end (void)
   rec = record_full_end_alloc ();
   rec->u.end.sigval = GDB_SIGNAL_0;
   rec->u.end.insn_num = ++record_full_insn_count;
+  record_full_checkpoint_add (rec);
 
   record_full_arch_list_add (rec);
 
@@ -1932,7 +2073,19 @@ record_full_goto_end (struct target_ops *self)
 {
   struct record_full_entry *p = NULL;
 
-  for (p = record_full_list; p->next != NULL; p = p->next)
+  /* Start from the last checkpoint if it is ahead of us.  */
+  p = record_full_list;
+  if (!record_full_checkpoints.empty ())
+    {
+      struct record_full_entry *last
+	= record_full_checkpoints.rbegin ()->second;
+
+      if (p->type != record_full_end
+	  || last->u.end.insn_num > p->u.end.insn_num)
+	p = last;
+    }
+
+  for (; p->next != NULL; p = p->next)
     ;
   for (; p!= NULL; p = p->prev)
     if (p->type == record_full_end)
@@ -1946,13 +2099,7 @@ record_full_goto_end (struct target_ops *self)
 static void
 record_full_goto (struct target_ops *self, ULONGEST target_insn)
 {
-  struct record_full_entry *p = NULL;
-
-  for (p = &record_full_first; p != NULL; p = p->next)
-    if (p->type == record_full_end && p->u.end.insn_num == target_insn)
-      break;
-
-  record_full_goto_entry (p);
+  record_full_goto_entry (record_full_find_insn (target_insn));
 }
 
 /* The "to_record_stop_replaying" target method.  */
@@ -2479,6 +2626,7 @@ record_full_restore (void)
 			sizeof (count), &bfd_offset);
 	  count = netorder32 (count);
 	  rec->u.end.insn_num = count;
+	  record_full_checkpoint_add (rec);
 	  record_full_insn_count = count + 1;
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog,
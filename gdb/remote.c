@@ -119,6 +119,8 @@ static int remote_vkill (int pid, struct remote_state *rs);
 
 static void remote_kill_k (void);
 
+static void remote_forget_prefetched_stack (void);
+
 static void remote_mourn (struct target_ops *ops);
 
 static void extended_remote_restart (void);
@@ -442,6 +444,15 @@ struct remote_state
      request/reply nature of the RSP.  We only cache data for a single
      file descriptor at a time.  */
   struct readahead_cache readahead_cache;
+
+  /* Stack memory read along with the registers, in the same qBatch
+     packet, when the target last stopped.  STACK_PREFETCH_LEN is zero
+     if there is none.  The memory is forgotten whenever the target
+     resumes or its memory may have changed.  */
+  CORE_ADDR stack_prefetch_addr;
+  ULONGEST stack_prefetch_len;
+  int stack_prefetch_pid;
+  gdb_byte *stack_prefetch_buf;
 };
 
 /* Private data that we'll store in (struct thread_info)->private.  */
@@ -1526,6 +1537,9 @@ enum {
   /* Support TARGET_WAITKIND_NO_RESUMED.  */
   PACKET_no_resumed,
 
+  /* Support for the qBatch packet, and for pipelined requests.  */
+  PACKET_qBatch,
+
   PACKET_MAX
 };
 
@@ -4698,6 +4712,7 @@ static const struct protocol_feature remote_protocol_features[] = {
   { "vContSupported", PACKET_DISABLE, remote_supported_packet, PACKET_vContSupported },
   { "QThreadEvents", PACKET_DISABLE, remote_supported_packet, PACKET_QThreadEvents },
   { "no-resumed", PACKET_DISABLE, remote_supported_packet, PACKET_no_resumed },
+  { "qBatch", PACKET_DISABLE, remote_supported_packet, PACKET_qBatch },
 };
 
 static char *remote_support_xml;
@@ -5081,6 +5096,7 @@ remote_open_1 (const char *name, int from_tty,
   rs->use_threadextra_query = 1;
 
   readahead_cache_invalidate ();
+  remote_forget_prefetched_stack ();
 
   /* Start out by owning the terminal.  */
   remote_async_terminal_ours_p = 1;
@@ -5180,6 +5196,8 @@ remote_detach_1 (const char *args, int from_tty)
   struct thread_info *tp = find_thread_ptid (inferior_ptid);
   int is_fork_parent;
 
+  remote_forget_prefetched_stack ();
+
   if (args)
     error (_("Argument given to \"detach\" when remotely debugging."));
 
@@ -5745,6 +5763,8 @@ remote_resume (struct target_ops *ops,
 {
   struct remote_state *rs = get_remote_state ();
 
+  remote_forget_prefetched_stack ();
+
   /* When connected in non-stop mode, the core resumes threads
      individually.  Resuming remote threads directly in target_resume
      would thus result in sending one packet per thread.  Instead, to
@@ -5913,6 +5933,8 @@ remote_commit_resume (struct target_ops *ops)
   int may_global_wildcard_vcont;
   struct vcont_builder vcont_builder;
 
+  remote_forget_prefetched_stack ();
+
   /* If connected in all-stop mode, we'd send the remote resume
      request directly from remote_resume.  Likewise if
      reverse-debugging, as there are no defined vCont actions for
@@ -7535,6 +7557,181 @@ fetch_register_using_p (struct regcache *regcache, struct packet_reg *reg)
   return 1;
 }
 
+/* The number of bytes of stack read along with the registers when
+   the target stops, if the stub supports qBatch.  */
+#define REMOTE_STACK_PREFETCH_SIZE 1024
+
+/* The maximum number of 'm' packets sent before reading the first
+   reply, when a large read is pipelined.  */
+#define REMOTE_READ_PIPELINE_DEPTH 8
+
+/* Send the read-only requests REQUESTS, which are 'g' or 'm' packets
+   without framing, to the stub in a single qBatch packet, and store
+   their replies in REPLIES, in the same order.  Return false if the
+   stub does not support qBatch or failed the whole batch, in which
+   case the caller should send the requests one by one.  The caller
+   must keep the request and the expected reply within the packet
+   size.  */
+
+static bool
+remote_send_batch (const std::vector<std::string> &requests,
+		   std::vector<std::string> *replies)
+{
+  struct remote_state *rs = get_remote_state ();
+  std::string packet = "qBatch:";
+  char *p, *sep;
+
+  if (packet_support (PACKET_qBatch) != PACKET_ENABLE)
+    return false;
+
+  for (size_t i = 0; i < requests.size (); i++)
+    {
+      if (i > 0)
+	packet += ';';
+      packet += requests[i];
+    }
+
+  putpkt (packet.c_str ());
+  getpkt (&rs->buf, &rs->buf_size, 0);
+
+  if (packet_ok (rs->buf, &remote_protocol_packets[PACKET_qBatch])
+      != PACKET_OK)
+    return false;
+
+  replies->clear ();
+  for (p = rs->buf; ; p = sep + 1)
+    {
+      sep = strchr (p, ';');
+      if (sep == NULL)
+	{
+	  replies->emplace_back (p);
+	  break;
+	}
+      replies->emplace_back (p, sep - p);
+    }
+
+  if (replies->size () != requests.size ())
+    {
+      warning (_("Remote qBatch reply has %d replies for %d requests"),
+	       (int) replies->size (), (int) requests.size ());
+      replies->clear ();
+      return false;
+    }
+
+  return true;
+}
+
+/* Forget the stack memory read along with the registers.  */
+
+static void
+remote_forget_prefetched_stack (void)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  rs->stack_prefetch_len = 0;
+}
+
+/* Read the registers included in the 'g' packet into the packet
+   buffer, along with the stack memory at the stack pointer of
+   REGCACHE, in a single qBatch packet.  This saves a round trip at
+   each stop, since unwinding the stack reads that memory right after
+   the registers.  Return false if the batch could not be used, in
+   which case the caller should send a plain 'g' packet.  */
+
+static bool
+send_g_packet_with_stack (struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  struct remote_state *rs = get_remote_state ();
+  struct remote_arch_state *rsa = get_remote_arch_state ();
+  int sp_regnum = gdbarch_sp_regnum (gdbarch);
+  std::vector<std::string> requests, replies;
+  ULONGEST sp, len;
+  char m_packet[64], *p;
+
+  /* The stack pointer must have been expedited in the stop reply.
+     Other threads can write the memory while non-stop, and
+     traceframes have memory of their own.  */
+  if (packet_support (PACKET_qBatch) != PACKET_ENABLE
+      || target_is_non_stop_p ()
+      || get_traceframe_number () != -1
+      || sp_regnum < 0
+      || sp_regnum >= gdbarch_num_regs (gdbarch)
+      || regcache_register_status (regcache, sp_regnum) != REG_VALID)
+    return false;
+
+  /* Leave room in the reply for the registers and the separator.  */
+  len = REMOTE_STACK_PREFETCH_SIZE;
+  if (2 * (rsa->sizeof_g_packet + len) + 2 > get_remote_packet_size ())
+    {
+      if (get_remote_packet_size () < 2 * rsa->sizeof_g_packet + 2 + 128)
+	return false;
+      len = (get_remote_packet_size () - 2) / 2 - rsa->sizeof_g_packet;
+    }
+
+  regcache_raw_read_unsigned (regcache, sp_regnum, &sp);
+
+  p = m_packet;
+  *p++ = 'm';
+  p += hexnumstr (p, (ULONGEST) remote_address_masked (sp));
+  *p++ = ',';
+  p += hexnumstr (p, len);
+  *p = '\0';
+
+  requests.emplace_back ("g");
+  requests.emplace_back (m_packet);
+  if (!remote_send_batch (requests, &replies))
+    return false;
+
+  /* Let a plain 'g' packet report errors.  */
+  if (!isxdigit (replies[0][0]) && replies[0][0] != 'x')
+    return false;
+  if (replies[0].size () % 2 != 0)
+    error (_("Remote 'g' packet reply is of odd length: %s"),
+	   replies[0].c_str ());
+
+  /* A stack pointer out of the mapped memory is not an error, just
+     nothing to remember.  */
+  remote_forget_prefetched_stack ();
+  if (replies[1][0] != 'E')
+    {
+      rs->stack_prefetch_buf
+	= (gdb_byte *) xrealloc (rs->stack_prefetch_buf, len);
+      rs->stack_prefetch_len = hex2bin (replies[1].c_str (),
+					rs->stack_prefetch_buf, len);
+      rs->stack_prefetch_addr = sp;
+      rs->stack_prefetch_pid = ptid_get_pid (regcache_get_ptid (regcache));
+    }
+
+  /* Let the caller parse the registers as if they came alone.  */
+  strcpy (rs->buf, replies[0].c_str ());
+  return true;
+}
+
+/* If the memory at MEMADDR was read along with the registers, copy
+   up to LEN bytes of it to MYADDR, set *XFERED_LEN and return true.  */
+
+static bool
+remote_read_prefetched_stack (CORE_ADDR memaddr, gdb_byte *myaddr,
+			      ULONGEST len, ULONGEST *xfered_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST offset;
+
+  if (rs->stack_prefetch_len == 0
+      || packet_support (PACKET_qBatch) != PACKET_ENABLE
+      || rs->stack_prefetch_pid != ptid_get_pid (inferior_ptid)
+      || get_traceframe_number () != -1
+      || memaddr < rs->stack_prefetch_addr
+      || memaddr - rs->stack_prefetch_addr >= rs->stack_prefetch_len)
+    return false;
+
+  offset = memaddr - rs->stack_prefetch_addr;
+  *xfered_len = std::min (len, rs->stack_prefetch_len - offset);
+  memcpy (myaddr, rs->stack_prefetch_buf + offset, *xfered_len);
+  return true;
+}
+
 /* Fetch the registers included in the target's 'g' packet.  */
 
 static int
@@ -7677,7 +7874,8 @@ process_g_packet (struct regcache *regcache)
 static void
 fetch_registers_using_g (struct regcache *regcache)
 {
-  send_g_packet ();
+  if (!send_g_packet_with_stack (regcache))
+    send_g_packet ();
   process_g_packet (regcache);
 }
 
@@ -8088,6 +8286,8 @@ remote_write_bytes_aux (const char *header, CORE_ADDR memaddr,
   int payload_capacity_bytes;
   int payload_length_bytes;
 
+  remote_forget_prefetched_stack ();
+
   if (packet_format != 'X' && packet_format != 'M')
     internal_error (__FILE__, __LINE__,
 		    _("remote_write_bytes_aux: bad packet format"));
@@ -8265,6 +8465,75 @@ remote_write_bytes (CORE_ADDR memaddr, const gdb_byte *myaddr, ULONGEST len,
 				 packet_format[0], 1);
 }
 
+/* Read LEN_UNITS units of memory at MEMADDR into MYADDR, sending up
+   to REMOTE_READ_PIPELINE_DEPTH 'm' packets of CHUNK_UNITS units
+   before reading their replies.  The stub must support pipelining.
+   Arguments and return are like remote_read_bytes_1's; the transfer
+   stops at the first error or short reply.  */
+
+static enum target_xfer_status
+remote_read_bytes_pipelined (CORE_ADDR memaddr, gdb_byte *myaddr,
+			     ULONGEST len_units, int unit_size,
+			     ULONGEST chunk_units,
+			     ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+  ULONGEST n_packets, i;
+  ULONGEST done_units = 0;
+  bool failed = false;
+
+  n_packets = std::min ((len_units + chunk_units - 1) / chunk_units,
+			(ULONGEST) REMOTE_READ_PIPELINE_DEPTH);
+
+  for (i = 0; i < n_packets; i++)
+    {
+      ULONGEST offset = i * chunk_units;
+      ULONGEST todo_units = std::min (chunk_units, len_units - offset);
+      char packet[64], *p = packet;
+
+      /* Construct "m"<memaddr>","<len>".  */
+      *p++ = 'm';
+      p += hexnumstr (p, (ULONGEST) remote_address_masked (memaddr + offset));
+      *p++ = ',';
+      p += hexnumstr (p, todo_units);
+      *p = '\0';
+      putpkt (packet);
+    }
+
+  /* Read all the replies, even after a failure, to stay in step with
+     the stub.  */
+  for (i = 0; i < n_packets; i++)
+    {
+      ULONGEST offset = i * chunk_units;
+      ULONGEST todo_units = std::min (chunk_units, len_units - offset);
+      int decoded_bytes;
+
+      getpkt (&rs->buf, &rs->buf_size, 0);
+      if (failed)
+	continue;
+
+      if (rs->buf[0] == 'E'
+	  && isxdigit (rs->buf[1]) && isxdigit (rs->buf[2])
+	  && rs->buf[3] == '\0')
+	{
+	  failed = true;
+	  continue;
+	}
+
+      decoded_bytes = hex2bin (rs->buf, myaddr + offset * unit_size,
+			       todo_units * unit_size);
+      done_units += decoded_bytes / unit_size;
+      if (decoded_bytes < todo_units * unit_size)
+	failed = true;
+    }
+
+  if (done_units == 0)
+    return TARGET_XFER_E_IO;
+
+  *xfered_len_units = done_units;
+  return TARGET_XFER_OK;
+}
+
 /* Read memory data directly from the remote machine.
    This does not use the data cache; the data cache uses this.
    MEMADDR is the address in the remote memory space.
@@ -8289,6 +8558,11 @@ remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr, ULONGEST len_units,
   int todo_units;
   int decoded_bytes;
 
+  if (unit_size == 1
+      && remote_read_prefetched_stack (memaddr, myaddr, len_units,
+				       xfered_len_units))
+    return TARGET_XFER_OK;
+
   buf_size_bytes = get_memory_read_packet_size ();
   /* The packet buffer will be large enough for the payload;
      get_memory_packet_size ensures this.  */
@@ -8297,6 +8571,16 @@ remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr, ULONGEST len_units,
   todo_units = std::min (len_units,
 			 (ULONGEST) (buf_size_bytes / unit_size) / 2);
 
+  /* A stub that supports qBatch also accepts pipelined requests.
+     Without acks, requests can be sent back to back, so a read that
+     needs several packets only waits for one round trip.  */
+  if (len_units > todo_units
+      && rs->noack_mode
+      && packet_support (PACKET_qBatch) == PACKET_ENABLE)
+    return remote_read_bytes_pipelined (memaddr, myaddr, len_units,
+					unit_size, todo_units,
+					xfered_len_units);
+
   /* Construct "m"<memaddr>","<len>".  */
   memaddr = remote_address_masked (memaddr);
   p = rs->buf;
@@ -8498,6 +8782,8 @@ remote_flash_erase (struct target_ops *ops,
   struct cleanup *back_to = make_cleanup (restore_remote_timeout,
                                           &saved_remote_timeout);
 
+  remote_forget_prefetched_stack ();
+
   remote_timeout = remote_flash_timeout;
 
   ret = remote_send_printf ("vFlashErase:%s,%s",
@@ -8526,6 +8812,8 @@ remote_flash_write (struct target_ops *ops, ULONGEST address,
   struct cleanup *back_to = make_cleanup (restore_remote_timeout,
 					  &saved_remote_timeout);
 
+  remote_forget_prefetched_stack ();
+
   remote_timeout = remote_flash_timeout;
   ret = remote_write_bytes_aux ("vFlashWrite:", address, data, length, 1,
 				xfered_len,'X', 0);
@@ -9341,6 +9629,8 @@ remote_kill (struct target_ops *ops)
   int pid = ptid_get_pid (inferior_ptid);
   struct remote_state *rs = get_remote_state ();
 
+  remote_forget_prefetched_stack ();
+
   if (packet_support (PACKET_vKill) != PACKET_DISABLE)
     {
       /* If we're stopped while forking and we haven't followed yet,
@@ -9441,6 +9731,8 @@ remote_mourn (struct target_ops *target)
 {
   struct remote_state *rs = get_remote_state ();
 
+  remote_forget_prefetched_stack ();
+
   /* In 'target remote' mode with one inferior, we close the connection.  */
   if (!rs->extended && number_of_live_inferiors () <= 1)
     {
@@ -9533,6 +9825,8 @@ extended_remote_run (const std::string &args)
   int len;
   const char *remote_exec_file = get_remote_exec_file ();
 
+  remote_forget_prefetched_stack ();
+
   /* If the user has disabled vRun support, or we have detected that
      support is not available, do not try it.  */
   if (packet_support (PACKET_vRun) == PACKET_DISABLE)
@@ -10693,6 +10987,8 @@ remote_rcmd (struct target_ops *self, const char *command,
   struct remote_state *rs = get_remote_state ();
   char *p = rs->buf;
 
+  remote_forget_prefetched_stack ();
+
   if (!rs->remote_desc)
     error (_("remote rcmd is only available after target open"));
 
@@ -12581,6 +12877,9 @@ Too many sections for read-only sections definition packet."));
 static void
 remote_trace_start (struct target_ops *self)
 {
+  /* Installing fast tracepoints writes to memory.  */
+  remote_forget_prefetched_stack ();
+
   putpkt ("QTStart");
   remote_get_noisy_reply (&target_buf, &target_buf_size);
   if (*target_buf == '\0')
@@ -12708,6 +13007,8 @@ remote_trace_find (struct target_ops *self,
   char *p, *reply;
   int target_frameno = -1, target_tracept = -1;
 
+  remote_forget_prefetched_stack ();
+
   /* Lookups other than by absolute frame number depend on the current
      trace selected, so make sure it is correct on the remote end
      first.  */
@@ -14335,6 +14636,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_no_resumed],
 			 "N stop reply", "no-resumed-stop-reply", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qBatch],
+			 "qBatch", "batch", 0);
+
   /* Assert that we've registered "set remote foo-packet" commands
      for all packet configs.  */
   {
@@ -606,6 +606,8 @@ struct dwarf2_debug_sections {
   struct dwarf2_section_names frame;
   struct dwarf2_section_names eh_frame;
   struct dwarf2_section_names gdb_index;
+  struct dwarf2_section_names debug_names;
+  struct dwarf2_section_names debug_aranges;
   /* This field has no meaning, but exists solely to catch changes to
      this structure which are not reflected in some instance.  */
   int sentinel;
@@ -625,8 +627,31 @@ extern void dwarf2_get_section_info (struct objfile *,
 				     asection **, const gdb_byte **,
 				     bfd_size_type *);
 
-extern int dwarf2_initialize_objfile (struct objfile *);
+/* The kind of index a DWARF objfile is read with.  */
+
+enum class dw_index_kind
+{
+  /* GDB's own .gdb_index section.  */
+  GDB_INDEX,
+
+  /* The DWARF 5 .debug_names section.  */
+  DEBUG_NAMES,
+};
+
+/* Initialize for reading DWARF for OBJFILE.  Return false if this
+   file will use psymtabs, or true if using an index, in which case
+   *INDEX_KIND is set to the kind of index.  */
+
+extern bool dwarf2_initialize_objfile (struct objfile *objfile,
+				       dw_index_kind *index_kind);
 extern void dwarf2_build_psymtabs (struct objfile *);
+
+/* Write an index of kind INDEX_KIND for OBJFILE to DIR.  The names
+   of the files written are BASENAME followed by a suffix for the
+   kind of index.  Throws an error if this is not possible.  */
+extern void dwarf2_write_index (struct objfile *objfile, const char *dir,
+				const char *basename,
+				dw_index_kind index_kind);
 extern void dwarf2_build_frame_info (struct objfile *);
 
 void dwarf2_free_objfile (struct objfile *);
@@ -715,26 +715,20 @@ create_demangled_names_hash (struct objfile *objfile)
      NULL, xcalloc, xfree);
 }
 
-/* Try to determine the demangled name for a symbol, based on the
-   language of that symbol.  If the language is set to language_auto,
-   it will attempt to find any demangling algorithm that works and
-   then set the language appropriately.  The returned name is allocated
-   by the demangler and should be xfree'd.  */
+/* See symtab.h.  */
 
-static char *
-symbol_find_demangled_name (struct general_symbol_info *gsymbol,
-			    const char *mangled)
+char *
+symbol_find_demangled_name (enum language *language, const char *mangled)
 {
   char *demangled = NULL;
   int i;
-  int recognized;
 
-  if (gsymbol->language == language_unknown)
-    gsymbol->language = language_auto;
+  if (*language == language_unknown)
+    *language = language_auto;
 
-  if (gsymbol->language != language_auto)
+  if (*language != language_auto)
     {
-      const struct language_defn *lang = language_def (gsymbol->language);
+      const struct language_defn *lang = language_def (*language);
 
       language_sniff_from_mangled_name (lang, mangled, &demangled);
       return demangled;
@@ -747,7 +741,7 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
 
       if (language_sniff_from_mangled_name (lang, mangled, &demangled))
 	{
-	  gsymbol->language = l;
+	  *language = l;
 	  return demangled;
 	}
     }
@@ -755,68 +749,30 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
   return NULL;
 }
 
-/* Set both the mangled and demangled (if any) names for GSYMBOL based
-   on LINKAGE_NAME and LEN.  Ordinarily, NAME is copied onto the
-   objfile's obstack; but if COPY_NAME is 0 and if NAME is
-   NUL-terminated, then this function assumes that NAME is already
-   correctly saved (either permanently or with a lifetime tied to the
-   objfile), and it will not be copied.
-
-   The hash table corresponding to OBJFILE is used, and the memory
-   comes from the per-BFD storage_obstack.  LINKAGE_NAME is copied,
-   so the pointer can be discarded after calling this function.  */
+/* Helper for symbol_set_names and symbol_set_demangled_names.
+   LINKAGE_NAME_COPY is a NUL-terminated copy of the LEN characters at
+   LINKAGE_NAME, and HASH is its hash.  If PRECOMPUTED is not NULL, it
+   holds the result of demangling LINKAGE_NAME_COPY, which is used
+   instead of calling the demangler; its string is consumed.  */
 
-void
-symbol_set_names (struct general_symbol_info *gsymbol,
-		  const char *linkage_name, int len, int copy_name,
-		  struct objfile *objfile)
+static void
+symbol_set_names_1 (struct general_symbol_info *gsymbol,
+		    const char *linkage_name, const char *linkage_name_copy,
+		    int len, int copy_name, struct objfile *objfile,
+		    hashval_t hash,
+		    struct symbol_demangle_result *precomputed)
 {
   struct demangled_name_entry **slot;
-  /* A 0-terminated copy of the linkage name.  */
-  const char *linkage_name_copy;
   struct demangled_name_entry entry;
   struct objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
 
-  if (gsymbol->language == language_ada)
-    {
-      /* In Ada, we do the symbol lookups using the mangled name, so
-         we can save some space by not storing the demangled name.  */
-      if (!copy_name)
-	gsymbol->name = linkage_name;
-      else
-	{
-	  char *name = (char *) obstack_alloc (&per_bfd->storage_obstack,
-					       len + 1);
-
-	  memcpy (name, linkage_name, len);
-	  name[len] = '\0';
-	  gsymbol->name = name;
-	}
-      symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
-
-      return;
-    }
-
   if (per_bfd->demangled_names_hash == NULL)
     create_demangled_names_hash (objfile);
 
-  if (linkage_name[len] != '\0')
-    {
-      char *alloc_name;
-
-      alloc_name = (char *) alloca (len + 1);
-      memcpy (alloc_name, linkage_name, len);
-      alloc_name[len] = '\0';
-
-      linkage_name_copy = alloc_name;
-    }
-  else
-    linkage_name_copy = linkage_name;
-
   entry.mangled = linkage_name_copy;
   slot = ((struct demangled_name_entry **)
-	  htab_find_slot (per_bfd->demangled_names_hash,
-			  &entry, INSERT));
+	  htab_find_slot_with_hash (per_bfd->demangled_names_hash,
+				    &entry, hash, INSERT));
 
   /* If this name is not in the hash table, add it.  */
   if (*slot == NULL
@@ -825,8 +781,23 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       || (gsymbol->language == language_go
 	  && (*slot)->demangled[0] == '\0'))
     {
-      char *demangled_name = symbol_find_demangled_name (gsymbol,
-							 linkage_name_copy);
+      char *demangled_name;
+
+      if (precomputed != NULL)
+	{
+	  gsymbol->language = precomputed->language;
+	  demangled_name = precomputed->demangled;
+	  precomputed->demangled = NULL;
+	}
+      else
+	{
+	  enum language language = gsymbol->language;
+
+	  demangled_name = symbol_find_demangled_name (&language,
+						       linkage_name_copy);
+	  gsymbol->language = language;
+	}
+
       int demangled_len = demangled_name ? strlen (demangled_name) : 0;
 
       /* Suppose we have demangled_name==NULL, copy_name==0, and
@@ -873,6 +844,12 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	(*slot)->demangled[0] = '\0';
     }
 
+  if (precomputed != NULL)
+    {
+      xfree (precomputed->demangled);
+      precomputed->demangled = NULL;
+    }
+
   gsymbol->name = (*slot)->mangled;
   if ((*slot)->demangled[0] != '\0')
     symbol_set_demangled_name (gsymbol, (*slot)->demangled,
@@ -881,6 +858,78 @@ symbol_set_names (struct general_symbol_info *gsymbol,
     symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
 }
 
+/* Set both the mangled and demangled (if any) names for GSYMBOL based
+   on LINKAGE_NAME and LEN.  Ordinarily, NAME is copied onto the
+   objfile's obstack; but if COPY_NAME is 0 and if NAME is
+   NUL-terminated, then this function assumes that NAME is already
+   correctly saved (either permanently or with a lifetime tied to the
+   objfile), and it will not be copied.
+
+   The hash table corresponding to OBJFILE is used, and the memory
+   comes from the per-BFD storage_obstack.  LINKAGE_NAME is copied,
+   so the pointer can be discarded after calling this function.  */
+
+void
+symbol_set_names (struct general_symbol_info *gsymbol,
+		  const char *linkage_name, int len, int copy_name,
+		  struct objfile *objfile)
+{
+  /* A 0-terminated copy of the linkage name.  */
+  const char *linkage_name_copy;
+  struct objfile_per_bfd_storage *per_bfd = objfile->per_bfd;
+
+  if (gsymbol->language == language_ada)
+    {
+      /* In Ada, we do the symbol lookups using the mangled name, so
+         we can save some space by not storing the demangled name.  */
+      if (!copy_name)
+	gsymbol->name = linkage_name;
+      else
+	{
+	  char *name = (char *) obstack_alloc (&per_bfd->storage_obstack,
+					       len + 1);
+
+	  memcpy (name, linkage_name, len);
+	  name[len] = '\0';
+	  gsymbol->name = name;
+	}
+      symbol_set_demangled_name (gsymbol, NULL, &per_bfd->storage_obstack);
+
+      return;
+    }
+
+  if (linkage_name[len] != '\0')
+    {
+      char *alloc_name;
+
+      alloc_name = (char *) alloca (len + 1);
+      memcpy (alloc_name, linkage_name, len);
+      alloc_name[len] = '\0';
+
+      linkage_name_copy = alloc_name;
+    }
+  else
+    linkage_name_copy = linkage_name;
+
+  symbol_set_names_1 (gsymbol, linkage_name, linkage_name_copy, len,
+		      copy_name, objfile,
+		      htab_hash_string (linkage_name_copy), NULL);
+}
+
+/* See symtab.h.  */
+
+void
+symbol_set_demangled_names (struct general_symbol_info *gsymbol,
+			    const char *linkage_name, hashval_t hash,
+			    struct symbol_demangle_result *demangled,
+			    struct objfile *objfile)
+{
+  gdb_assert (gsymbol->language != language_ada);
+
+  symbol_set_names_1 (gsymbol, linkage_name, linkage_name,
+		      strlen (linkage_name), 0, objfile, hash, demangled);
+}
+
 /* Return the source code name of a symbol.  In languages where
    demangling is necessary, this is the demangled name.  */
 
@@ -2277,6 +2326,130 @@ Internal: %s symbol `%s' found in %s psymtab but not in symtab.\n\
 	 name, name);
 }
 
+/* A Bloom filter of the names the quick symbol functions of an
+   objfile can find, keyed by dict_hash so that any two names the
+   lookup functions consider equal test the same bits.  It lets a
+   global symbol lookup skip, with a few bit tests, the objfiles which
+   cannot define the name, instead of probing the index or searching
+   the partial symbols of every objfile of the program space.
+
+   The quick functions only search the compunits which are not yet
+   expanded, whose names never grow, so the filter is built once per
+   objfile, on the first lookup, and goes away with the objfile.  */
+
+struct symbol_name_filter
+{
+  /* The bits of the filter.  Their number is a power of two.  */
+  std::vector<unsigned char> bits;
+
+  /* The number of bits, minus one.  */
+  size_t mask;
+};
+
+/* The number of bits of a symbol_name_filter set for each name, and
+   the size of the filter in bits per name, before rounding up to a
+   power of two.  Together these let about one lookup in a hundred
+   through for an objfile not defining the name.  */
+#define SYMBOL_NAME_FILTER_PROBES 4
+#define SYMBOL_NAME_FILTER_BITS_PER_NAME 10
+
+/* The objfile data key for the symbol_name_filter of an objfile.  */
+
+static const struct objfile_data *symbol_name_filter_key;
+
+/* Call CALLBACK on each bit of a filter of MASK + 1 bits tested for
+   the name whose dict_hash is HASH.  */
+
+template<typename Callback>
+static void
+symbol_name_filter_iterate (unsigned int hash, size_t mask,
+			    Callback callback)
+{
+  /* Derive a second hash for double hashing, odd so that the probes
+     differ.  */
+  size_t step = ((hash * 0x9e3779b1u) >> 7) | 1;
+  size_t bit = hash;
+  int i;
+
+  for (i = 0; i < SYMBOL_NAME_FILTER_PROBES; ++i)
+    {
+      callback (bit & mask);
+      bit += step;
+    }
+}
+
+/* Free the symbol_name_filter of OBJFILE.  */
+
+static void
+symbol_name_filter_cleanup (struct objfile *objfile, void *data)
+{
+  struct symbol_name_filter *filter = (struct symbol_name_filter *) data;
+
+  delete filter;
+}
+
+/* Return the symbol_name_filter of OBJFILE, building it if needed.
+   OBJFILE must have quick symbol functions.  */
+
+static struct symbol_name_filter *
+get_symbol_name_filter (struct objfile *objfile)
+{
+  struct symbol_name_filter *filter
+    = (struct symbol_name_filter *) objfile_data (objfile,
+						  symbol_name_filter_key);
+  std::vector<unsigned int> hashes;
+  size_t n_bits;
+
+  if (filter != NULL)
+    return filter;
+
+  /* This reads the partial symbols of OBJFILE if needed, as the
+     lookup itself would, but expands nothing.  */
+  objfile->sf->qf->expand_symtabs_matching
+    (objfile, NULL,
+     [&] (const char *name)
+     {
+       hashes.push_back (dict_hash (name));
+       return false;
+     },
+     NULL, ALL_DOMAIN);
+
+  n_bits = 64;
+  while (n_bits < hashes.size () * SYMBOL_NAME_FILTER_BITS_PER_NAME)
+    n_bits *= 2;
+
+  filter = new struct symbol_name_filter;
+  filter->bits.resize (n_bits / 8);
+  filter->mask = n_bits - 1;
+  for (unsigned int hash : hashes)
+    symbol_name_filter_iterate (hash, filter->mask, [=] (size_t bit)
+      {
+	filter->bits[bit / 8] |= 1 << (bit % 8);
+      });
+
+  set_objfile_data (objfile, symbol_name_filter_key, filter);
+  return filter;
+}
+
+/* Return true if the quick symbol functions of OBJFILE may find a
+   symbol named NAME.  */
+
+static bool
+symbol_name_filter_may_contain (struct objfile *objfile, const char *name)
+{
+  struct symbol_name_filter *filter = get_symbol_name_filter (objfile);
+  bool result = true;
+
+  symbol_name_filter_iterate (dict_hash (name), filter->mask,
+			      [&] (size_t bit)
+    {
+      if ((filter->bits[bit / 8] & (1 << (bit % 8))) == 0)
+	result = false;
+    });
+
+  return result;
+}
+
 /* A helper function for various lookup routines that interfaces with
    the "quick" symbol table functions.  */
 
@@ -2302,6 +2475,17 @@ lookup_symbol_via_quick_fns (struct objfile *objfile, int block_index,
 			  name, domain_name (domain));
     }
 
+  if (!symbol_name_filter_may_contain (objfile, name))
+    {
+      if (symbol_lookup_debug > 1)
+	{
+	  fprintf_unfiltered (gdb_stdlog,
+			      "lookup_symbol_via_quick_fns (...) = NULL"
+			      " (not in name filter)\n");
+	}
+      return (struct block_symbol) {NULL, NULL};
+    }
+
   cust = objfile->sf->qf->lookup_symbol (objfile, block_index, name, domain);
   if (cust == NULL)
     {
@@ -2654,7 +2838,7 @@ basic_lookup_transparent_type_quick (struct objfile *objfile, int block_index,
   struct block *block;
   struct symbol *sym;
 
-  if (!objfile->sf)
+  if (!objfile->sf || !symbol_name_filter_may_contain (objfile, name))
     return NULL;
   cust = objfile->sf->qf->lookup_symbol (objfile, block_index, name,
 					 STRUCT_DOMAIN);
@@ -5104,7 +5288,6 @@ default_make_symbol_completion_list_break_on_1 (const char *text,
 
   struct symbol *sym;
   struct compunit_symtab *cust;
-  struct minimal_symbol *msymbol;
   struct objfile *objfile;
   const struct block *b;
   const struct block *surrounding_static_block, *surrounding_global_block;
@@ -5193,14 +5376,31 @@ default_make_symbol_completion_list_break_on_1 (const char *text,
 
   if (code == TYPE_CODE_UNDEF)
     {
-      ALL_MSYMBOLS (objfile, msymbol)
+      /* Only the symbols whose name starts with SYM_TEXT can match,
+	 and only ObjC methods, whose names start with '-' or '+', can
+	 yield selectors; look at just those.  */
+      auto add_msymbol = [&] (struct minimal_symbol *msym)
 	{
 	  QUIT;
-	  MCOMPLETION_LIST_ADD_SYMBOL (msymbol, sym_text, sym_text_len, text,
+	  MCOMPLETION_LIST_ADD_SYMBOL (msym, sym_text, sym_text_len, text,
 				       word);
-
-	  completion_list_objc_symbol (msymbol, sym_text, sym_text_len, text,
+	};
+      auto add_objc_msymbol = [&] (struct minimal_symbol *msym)
+	{
+	  QUIT;
+	  completion_list_objc_symbol (msym, sym_text, sym_text_len, text,
 				       word);
+	};
+
+      ALL_OBJFILES (objfile)
+	{
+	  iterate_over_minimal_symbols_with_prefix (objfile, sym_text,
+						    sym_text_len,
+						    add_msymbol);
+	  iterate_over_minimal_symbols_with_prefix (objfile, "-", 1,
+						    add_objc_msymbol);
+	  iterate_over_minimal_symbols_with_prefix (objfile, "+", 1,
+						    add_objc_msymbol);
 	}
     }
 
@@ -6053,6 +6253,9 @@ _initialize_symtab (void)
   symbol_cache_key
     = register_program_space_data_with_cleanup (NULL, symbol_cache_cleanup);
 
+  symbol_name_filter_key
+    = register_objfile_data_with_cleanup (NULL, symbol_name_filter_cleanup);
+
   add_info ("variables", variables_info, _("\
 All global and static variable names, or those matching REGEXP."));
   if (dbx_commands)
@@ -215,6 +215,37 @@ extern void symbol_set_names (struct general_symbol_info *symbol,
 			      const char *linkage_name, int len, int copy_name,
 			      struct objfile *objfile);
 
+/* Try to determine the demangled name for a symbol whose linkage
+   name is MANGLED, based on its language, *LANGUAGE.  If that is
+   language_auto, try every demangler and set *LANGUAGE to the
+   language of the first one that works.  The returned name is
+   allocated by the demangler and should be xfree'd.  This touches no
+   shared state, so it can be called from worker threads.  */
+extern char *symbol_find_demangled_name (enum language *language,
+					 const char *mangled);
+
+/* The result of symbol_find_demangled_name, computed ahead of
+   symbol_set_demangled_names.  */
+struct symbol_demangle_result
+{
+  /* The language of the symbol.  */
+  enum language language;
+
+  /* The demangled name, or NULL.  xmalloc'd.  */
+  char *demangled;
+};
+
+/* Like symbol_set_names, for a NUL-terminated LINKAGE_NAME which is
+   already saved on the objfile, whose htab_hash_string value is HASH.
+   If the name is not known yet, DEMANGLED is used as the result of
+   demangling it instead of calling the demangler.  The string of
+   DEMANGLED is freed in any case.  */
+extern void symbol_set_demangled_names (struct general_symbol_info *symbol,
+					const char *linkage_name,
+					hashval_t hash,
+					struct symbol_demangle_result *demangled,
+					struct objfile *objfile);
+
 /* Now come lots of name accessor macros.  Short version as to when to
    use which: Use SYMBOL_NATURAL_NAME to refer to the name of the
    symbol in the original source code.  Use SYMBOL_LINKAGE_NAME if you
@@ -364,6 +395,12 @@ struct minimal_symbol
      the object file format may not carry that piece of information.  */
   unsigned int has_size : 1;
 
+  /* Nonzero once the names of the symbol have been set.  Until then,
+     only the linkage name is valid: demangling is left to
+     minimal_symbol_reader::install, which does it for all the new
+     symbols at once.  */
+  unsigned int name_set : 1;
+
   /* Minimal symbols with the same hash key are kept on a linked
      list.  This is the link.  */
 
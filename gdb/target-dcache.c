@@ -46,6 +46,10 @@ target_dcache_init_p (void)
   return (dcache != NULL);
 }
 
+/* Incremented each time the target dcache is invalidated.  */
+
+static unsigned int target_dcache_generation_count;
+
 /* Invalidate the target dcache.  */
 
 void
@@ -55,10 +59,20 @@ target_dcache_invalidate (void)
     = (DCACHE *) address_space_data (current_program_space->aspace,
 				     target_dcache_aspace_key);
 
+  target_dcache_generation_count++;
+
   if (dcache != NULL)
     dcache_invalidate (dcache);
 }
 
+/* See target-dcache.h.  */
+
+unsigned int
+target_dcache_generation (void)
+{
+  return target_dcache_generation_count;
+}
+
 /* Return the target dcache.  Return NULL if target dcache is not
    initialized yet.  */
 
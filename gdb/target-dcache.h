@@ -22,6 +22,12 @@
 
 extern void target_dcache_invalidate (void);
 
+/* Return a number that changes each time the target dcache is
+   invalidated.  Lower-level caches of target memory use this to live
+   no longer than the dcache would.  */
+
+extern unsigned int target_dcache_generation (void);
+
 extern DCACHE *target_dcache_get (void);
 
 extern DCACHE *target_dcache_get_or_init (void);
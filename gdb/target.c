@@ -46,6 +46,7 @@
 #include "top.h"
 #include "event-top.h"
 #include <algorithm>
+#include "common/parallel-for.h"
 
 static void target_info (char *, int);
 
@@ -2425,9 +2426,91 @@ target_read_description (struct target_ops *target)
   return target->to_read_description (target);
 }
 
+/* The number of threads used to scan the memory read by
+   simple_search_memory, or -1 for one per CPU.  Used for
+   "maint set search-memory-threads".  */
+static int search_memory_threads = -1;
+
+static void
+show_search_memory_threads (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("The number of threads used to search "
+			    "memory is %s.\n"),
+		    value);
+}
+
+/* The smallest number of bytes worth scanning in another thread.  */
+#define MIN_SEARCH_BYTES_PER_THREAD (256 * 1024)
+
+/* Return the offset of the first occurrence of PATTERN, PATTERN_LEN
+   bytes long, in the LEN bytes at BUF, or -1 if there is none.  Large
+   buffers are split across threads, each piece overlapping the next
+   by PATTERN_LEN - 1 bytes so that no match is missed.  */
+
+static LONGEST
+search_memory_buffer (const gdb_byte *buf, ULONGEST len,
+		      const gdb_byte *pattern, ULONGEST pattern_len)
+{
+  const gdb_byte *found_ptr;
+
+  if (len < pattern_len)
+    return -1;
+
+  /* The number of positions where a match may start.  */
+  ULONGEST n_starts = len - pattern_len + 1;
+  int n_threads
+    = gdb::parallel_for_thread_count (search_memory_threads, n_starts,
+				      MIN_SEARCH_BYTES_PER_THREAD);
+
+  if (n_threads <= 1)
+    {
+      found_ptr = (const gdb_byte *) memmem (buf, len, pattern, pattern_len);
+      return found_ptr != NULL ? found_ptr - buf : -1;
+    }
+
+  /* Each piece records its first match; the first piece with one
+     wins.  */
+  std::vector<int> pieces (n_threads);
+  std::vector<LONGEST> found (n_threads, -1);
+
+  for (int i = 0; i < n_threads; ++i)
+    pieces[i] = i;
+
+  gdb::parallel_for_each (pieces.begin (), pieces.end (), n_threads,
+    [&] (std::vector<int>::iterator first, std::vector<int>::iterator last)
+    {
+      for (; first != last; ++first)
+	{
+	  int i = *first;
+	  ULONGEST begin = n_starts / n_threads * i;
+	  ULONGEST end = (i == n_threads - 1
+			  ? n_starts : n_starts / n_threads * (i + 1));
+	  const gdb_byte *p
+	    = (const gdb_byte *) memmem (buf + begin,
+					 end - begin + pattern_len - 1,
+					 pattern, pattern_len);
+
+	  if (p != NULL)
+	    found[i] = p - buf;
+	}
+    });
+
+  for (LONGEST offset : found)
+    if (offset >= 0)
+      return offset;
+  return -1;
+}
+
 /* This implements a basic search of memory, reading target memory and
    performing the search here (as opposed to performing the search in on the
-   target side with, for example, gdbserver).  */
+   target side with, for example, gdbserver).
+
+   Memory is read a chunk at a time.  The first chunk is
+   SEARCH_CHUNK_SIZE bytes, and each following one is twice as large
+   as the previous one, up to SEARCH_MAX_CHUNK_SIZE, so that short
+   searches stay cheap while long ones are done with few, large reads
+   that search_memory_buffer can split across threads.  */
 
 int
 simple_search_memory (struct target_ops *ops,
@@ -2437,13 +2520,17 @@ simple_search_memory (struct target_ops *ops,
 {
   /* NOTE: also defined in find.c testcase.  */
 #define SEARCH_CHUNK_SIZE 16000
-  const unsigned chunk_size = SEARCH_CHUNK_SIZE;
+#define SEARCH_MAX_CHUNK_SIZE (1024 * SEARCH_CHUNK_SIZE)
+  ULONGEST chunk_size = SEARCH_CHUNK_SIZE;
+  const ULONGEST keep_len = pattern_len - 1;
   /* Buffer to hold memory contents for searching.  */
   gdb_byte *search_buf;
-  unsigned search_buf_size;
+  ULONGEST search_buf_size;
+  /* Allocated size of SEARCH_BUF.  */
+  ULONGEST search_buf_alloc;
   struct cleanup *old_cleanups;
 
-  search_buf_size = chunk_size + pattern_len - 1;
+  search_buf_size = chunk_size + keep_len;
 
   /* No point in trying to allocate a buffer larger than the search space.  */
   if (search_space_len < search_buf_size)
@@ -2452,6 +2539,7 @@ simple_search_memory (struct target_ops *ops,
   search_buf = (gdb_byte *) malloc (search_buf_size);
   if (search_buf == NULL)
     error (_("Unable to allocate memory to perform the search."));
+  search_buf_alloc = search_buf_size;
   old_cleanups = make_cleanup (free_current_contents, &search_buf);
 
   /* Prime the search buffer.  */
@@ -2474,18 +2562,13 @@ simple_search_memory (struct target_ops *ops,
 
   while (search_space_len >= pattern_len)
     {
-      gdb_byte *found_ptr;
-      unsigned nr_search_bytes
-	= std::min (search_space_len, (ULONGEST) search_buf_size);
-
-      found_ptr = (gdb_byte *) memmem (search_buf, nr_search_bytes,
-				       pattern, pattern_len);
+      ULONGEST nr_search_bytes = std::min (search_space_len, search_buf_size);
+      LONGEST found = search_memory_buffer (search_buf, nr_search_bytes,
+					    pattern, pattern_len);
 
-      if (found_ptr != NULL)
+      if (found >= 0)
 	{
-	  CORE_ADDR found_addr = start_addr + (found_ptr - search_buf);
-
-	  *found_addrp = found_addr;
+	  *found_addrp = start_addr + found;
 	  do_cleanups (old_cleanups);
 	  return 1;
 	}
@@ -2500,31 +2583,54 @@ simple_search_memory (struct target_ops *ops,
 
       if (search_space_len >= pattern_len)
 	{
-	  unsigned keep_len = search_buf_size - chunk_size;
 	  CORE_ADDR read_addr = start_addr + chunk_size + keep_len;
-	  int nr_to_read;
+	  ULONGEST nr_to_read;
 
 	  /* Copy the trailing part of the previous iteration to the front
 	     of the buffer for the next iteration.  */
-	  gdb_assert (keep_len == pattern_len - 1);
-	  memcpy (search_buf, search_buf + chunk_size, keep_len);
+	  gdb_assert (search_buf_size == chunk_size + keep_len);
+	  memmove (search_buf, search_buf + chunk_size, keep_len);
 
-	  nr_to_read = std::min (search_space_len - keep_len,
-				 (ULONGEST) chunk_size);
+	  start_addr += chunk_size;
+	  chunk_size = std::min<ULONGEST> (2 * chunk_size,
+					   SEARCH_MAX_CHUNK_SIZE);
 
-	  if (target_read (ops, TARGET_OBJECT_MEMORY, NULL,
-			   search_buf + keep_len, read_addr,
-			   nr_to_read) != nr_to_read)
+	  while (1)
 	    {
-	      warning (_("Unable to access %s bytes of target "
-			 "memory at %s, halting search."),
-		       plongest (nr_to_read),
-		       hex_string (read_addr));
-	      do_cleanups (old_cleanups);
-	      return -1;
-	    }
+	      search_buf_size = std::min (chunk_size + keep_len,
+					  search_space_len);
+	      if (search_buf_size > search_buf_alloc)
+		{
+		  gdb_byte *new_buf
+		    = (gdb_byte *) realloc (search_buf, search_buf_size);
+
+		  if (new_buf == NULL)
+		    error (_("Unable to allocate memory to perform "
+			     "the search."));
+		  search_buf = new_buf;
+		  search_buf_alloc = search_buf_size;
+		}
 
-	  start_addr += chunk_size;
+	      nr_to_read = search_buf_size - keep_len;
+	      if (target_read (ops, TARGET_OBJECT_MEMORY, NULL,
+			       search_buf + keep_len, read_addr,
+			       nr_to_read) == nr_to_read)
+		break;
+
+	      /* A large chunk may run into unreadable memory past a
+		 match.  Go back to small chunks, so that the search
+		 stops where it would have with them.  */
+	      if (chunk_size == SEARCH_CHUNK_SIZE)
+		{
+		  warning (_("Unable to access %s bytes of target "
+			     "memory at %s, halting search."),
+			   pulongest (nr_to_read),
+			   hex_string (read_addr));
+		  do_cleanups (old_cleanups);
+		  return -1;
+		}
+	      chunk_size = SEARCH_CHUNK_SIZE;
+	    }
 	}
     }
 
@@ -4177,6 +4283,19 @@ result in significant performance improvement for remote targets."),
            _("Print the name of each layer of the internal target stack."),
            &maintenanceprintlist);
 
+  add_setshow_zuinteger_unlimited_cmd ("search-memory-threads",
+				       class_maintenance,
+				       &search_memory_threads, _("\
+Set the number of threads used to search memory."), _("\
+Show the number of threads used to search memory."), _("\
+This is used by \"find\" when GDB reads the memory it searches.\n\
+Zero means to do everything on the main thread.  \"unlimited\" means\n\
+to use one thread per CPU."),
+				       NULL,
+				       show_search_memory_threads,
+				       &maintenance_set_cmdlist,
+				       &maintenance_show_cmdlist);
+
   add_setshow_boolean_cmd ("target-async", no_class,
 			   &target_async_permitted_1, _("\
 Set whether gdb controls the inferior in asynchronous mode."), _("\
@@ -77,6 +77,8 @@ struct inferior;
 
 #include "break-common.h" /* For enum target_hw_bp_type.  */
 
+#include <vector>
+
 enum strata
   {
     dummy_stratum,		/* The lowest of the low */
@@ -2410,6 +2412,21 @@ extern int default_memory_remove_breakpoint (struct gdbarch *,
 extern int default_memory_insert_breakpoint (struct gdbarch *,
 					     struct bp_target_info *);
 
+/* Start batching the memory writes of default_memory_insert_breakpoint,
+   so that they are done a page at a time.  Until the matching
+   end_memory_breakpoint_batch, the breakpoints are recorded as
+   inserted, with their shadow contents saved, but only the breakpoint
+   shadows of GDB know about them.  */
+
+extern void begin_memory_breakpoint_batch (void);
+
+/* Write the breakpoints batched since begin_memory_breakpoint_batch to
+   the current inferior, and stop batching.  Return the breakpoints that
+   could not be written.  */
+
+extern std::vector<struct bp_target_info *>
+  end_memory_breakpoint_batch (void);
+
 
 /* From target.c */
 
@@ -0,0 +1,36 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This file is compiled without debug info, so that only minimal
+   symbols are available for completion.  */
+
+void cmpl_fn_alpha (void) {}
+void cmpl_fn_beta (void) {}
+void cmpl_fn_gamma (void) {}
+void cmpl_fo (void) {}
+void CMPL_FN_UPPER (void) {}
+
+int
+main (void)
+{
+  cmpl_fn_alpha ();
+  cmpl_fn_beta ();
+  cmpl_fn_gamma ();
+  cmpl_fo ();
+  CMPL_FN_UPPER ();
+  return 0;
+}
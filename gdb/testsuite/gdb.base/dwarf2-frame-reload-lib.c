@@ -0,0 +1,25 @@
+/* Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This file is built without debug info and without a frame pointer,
+   so GDB can only unwind through lib_func using its CFI.  */
+
+int
+lib_func (int (*callback) (int), int x)
+{
+  volatile int y = x;
+
+  return callback (y) + 1;
+}
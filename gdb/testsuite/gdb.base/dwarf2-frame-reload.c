@@ -0,0 +1,70 @@
+/* Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+int
+callback (int x)
+{
+  return x * 2;
+}
+
+int
+main (void)
+{
+  int i;
+  int result = 0;
+
+  for (i = 0; i < 2; i++)
+    {
+      void *handle;
+      int (*func) (int (*) (int), int);
+      Dl_info info;
+
+      handle = dlopen (SHLIB_NAME, RTLD_NOW);
+      if (handle == NULL)
+	{
+	  fprintf (stderr, "%s\n", dlerror ());
+	  exit (1);
+	}
+
+      func = (int (*) (int (*) (int), int)) dlsym (handle, "lib_func");
+      if (func == NULL)
+	{
+	  fprintf (stderr, "%s\n", dlerror ());
+	  exit (1);
+	}
+
+      result += func (callback, i);
+
+      if (dladdr ((void *) func, &info) == 0)
+	exit (1);
+
+      dlclose (handle);
+
+      /* Map a page where the library started, so that it is loaded
+	 at a different address the next time.  */
+      if (i == 0)
+	mmap (info.dli_fbase, getpagesize (), PROT_NONE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+  return result == 4 ? 0 : 1;
+}
@@ -32,7 +32,8 @@
 #undef int64_t
 
 #define CHUNK_SIZE 16000 /* same as findcmd.c's */
-#define BUF_SIZE (2 * CHUNK_SIZE) /* at least two chunks */
+#define BUF_SIZE (4 * CHUNK_SIZE) /* at least three chunks */
+#define LARGE_BUF_SIZE (4 * 1024 * 1024) /* large enough for threads */
 
 static int8_t int8_search_buf[100];
 static int16_t int16_search_buf[100];
@@ -42,6 +43,9 @@ static int64_t int64_search_buf[100];
 static char *search_buf;
 static int search_buf_size;
 
+static char *large_search_buf;
+static int large_search_buf_size;
+
 static int x;
 
 static void
@@ -58,6 +62,12 @@ init_bufs ()
   if (search_buf == NULL)
     exit (1);
   memset (search_buf, 'x', search_buf_size);
+
+  large_search_buf_size = LARGE_BUF_SIZE;
+  large_search_buf = malloc (large_search_buf_size);
+  if (large_search_buf == NULL)
+    exit (1);
+  memset (large_search_buf, 'x', large_search_buf_size);
 }
 
 int
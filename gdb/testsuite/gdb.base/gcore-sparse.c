@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdlib.h>
+
+/* Larger than the chunks gcore reads, so that the buffer has zero
+   blocks at the start and end of chunks, and within them.  */
+#define BUF_SIZE (3 * 1024 * 1024)
+
+char *buf;
+
+void
+break_here (void)
+{
+}
+
+int
+main (void)
+{
+  buf = (char *) calloc (BUF_SIZE, 1);
+  if (buf == NULL)
+    return 1;
+
+  buf[0] = 1;
+  buf[4095] = 2;
+  buf[1024 * 1024 + 10] = 3;
+  buf[2 * 1024 * 1024 - 1] = 4;
+  buf[BUF_SIZE - 1] = 5;
+
+  break_here ();
+  return 0;
+}
@@ -0,0 +1,41 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Many small functions, close to each other in memory, so that
+   breakpoints on all of them share pages.  */
+
+volatile int counter;
+
+#define FUNC(N) void many_bp_func_ ## N (void) { counter += N; }
+
+FUNC (0) FUNC (1) FUNC (2) FUNC (3) FUNC (4)
+FUNC (5) FUNC (6) FUNC (7) FUNC (8) FUNC (9)
+FUNC (10) FUNC (11) FUNC (12) FUNC (13) FUNC (14)
+FUNC (15) FUNC (16) FUNC (17) FUNC (18) FUNC (19)
+
+int
+main (void)
+{
+  many_bp_func_0 (); many_bp_func_1 (); many_bp_func_2 ();
+  many_bp_func_3 (); many_bp_func_4 (); many_bp_func_5 ();
+  many_bp_func_6 (); many_bp_func_7 (); many_bp_func_8 ();
+  many_bp_func_9 (); many_bp_func_10 (); many_bp_func_11 ();
+  many_bp_func_12 (); many_bp_func_13 (); many_bp_func_14 ();
+  many_bp_func_15 (); many_bp_func_16 (); many_bp_func_17 ();
+  many_bp_func_18 (); many_bp_func_19 ();
+  return counter;
+}
@@ -0,0 +1,39 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Both arrays are much bigger than the block GDB reads at a time when
+   printing them.  */
+
+#define COUNT (256 * 1024)
+
+int zeros[COUNT];
+int counting[COUNT];
+
+int
+main (void)
+{
+  int i;
+
+  zeros[0] = 1;
+  zeros[1] = 2;
+  zeros[COUNT - 1] = 3;
+
+  for (i = 0; i < COUNT; i++)
+    counting[i] = i;
+
+  return 0; /* break here */
+}
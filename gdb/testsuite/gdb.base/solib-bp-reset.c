@@ -0,0 +1,49 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <dlfcn.h>
+#include <stdlib.h>
+
+static void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  void *handle1, *handle2;
+  int (*func1) (int);
+  int (*func2) (int);
+
+  handle1 = dlopen (SHLIB_NAME1, RTLD_LAZY);
+  if (handle1 == NULL)
+    abort ();
+
+  marker ();
+
+  handle2 = dlopen (SHLIB_NAME2, RTLD_LAZY);
+  if (handle2 == NULL)
+    abort ();
+
+  func1 = (int (*) (int)) dlsym (handle1, "bp_reset_func1");
+  func2 = (int (*) (int)) dlsym (handle2, "bp_reset_func2");
+  if (func1 == NULL || func2 == NULL)
+    abort ();
+
+  return func1 (1) + func2 (2) == 3 ? 0 : 1;
+}
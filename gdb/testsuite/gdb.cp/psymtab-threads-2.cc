@@ -0,0 +1,41 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace ns2
+{
+  typedef const char *name_type;
+
+  enum shape { circle, square };
+
+  template<typename T, int N>
+  struct array
+  {
+    T elts[N];
+
+    T first () const { return elts[0]; }
+  };
+
+  static array<short, 3> arr = { { 1, 2, 3 } };
+}
+
+int
+func2 (int x)
+{
+  ns2::name_type name = "square";
+
+  return x + ns2::arr.first () + ns2::square + (name[0] == 's');
+}
@@ -0,0 +1,47 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+namespace ns1
+{
+  typedef unsigned long  size_type;
+
+  enum color { red, green, blue };
+
+  template<typename T>
+  struct holder
+  {
+    T value;
+
+    T get () const { return value; }
+  };
+
+  int func1 (holder<int> h)
+  {
+    return h.get ();
+  }
+}
+
+extern int func2 (int);
+
+int
+main ()
+{
+  ns1::holder<int> h = { 1 };
+  ns1::size_type s = ns1::green;
+
+  return ns1::func1 (h) + func2 ((int) s);
+}
@@ -0,0 +1,75 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+#ifndef NTHREADS
+#define NTHREADS 100
+#endif
+
+static pthread_barrier_t barrier;
+
+volatile int flag = 1;
+
+volatile unsigned long counts[NTHREADS];
+
+/* All the threads call this in a loop, so that a breakpoint here is
+   hit by many threads at once.  */
+
+void __attribute__ ((noinline))
+thread_break (int n)
+{
+  counts[n]++;
+}
+
+static void *
+thread_function (void *arg)
+{
+  int n = (int) (long) arg;
+
+  pthread_barrier_wait (&barrier);
+
+  while (flag)
+    thread_break (n);
+
+  return NULL;
+}
+
+void
+all_started (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NTHREADS];
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NTHREADS + 1);
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, (void *) (long) i);
+
+  all_started ();
+  pthread_barrier_wait (&barrier);
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  return 0;
+}
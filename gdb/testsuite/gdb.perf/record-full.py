@@ -0,0 +1,39 @@
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+class RecordFull (perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, step):
+        super (RecordFull, self).__init__ ("record-full")
+        self.step = step
+
+    def warm_up(self):
+        gdb.execute("record full", False, True)
+        gdb.execute("stepi %d" % self.step, False, True)
+        gdb.execute("record stop", False, True)
+
+    def _run(self, r):
+        # Record R instructions, then move through the whole log.
+        gdb.execute("record full", False, True)
+        gdb.execute("stepi %d" % r, False, True)
+        gdb.execute("record goto begin", False, True)
+        gdb.execute("record goto end", False, True)
+
+    def execute_test(self):
+        for i in range(1, 5):
+            func = lambda: self._run(i * self.step)
+            self.measure.measure(func, i * self.step)
+            gdb.execute("record stop", False, True)
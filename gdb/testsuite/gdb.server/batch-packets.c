@@ -0,0 +1,48 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2017 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define N 16384
+
+/* Large enough that reading it takes several packets.  */
+unsigned int array[N];
+
+static int
+leaf (int depth)
+{
+  volatile int local = depth * 3;
+
+  return local; /* break here */
+}
+
+static int
+recurse (int depth)
+{
+  if (depth == 0)
+    return leaf (depth);
+  return recurse (depth - 1) + 1;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    array[i] = i * 7;
+
+  return recurse (10);
+}
@@ -35,6 +35,7 @@
 #include "gdb_obstack.h"
 #include "charset.h"
 #include "typeprint.h"
+#include "tracepoint.h"
 #include <ctype.h>
 #include <algorithm>
 
@@ -1141,7 +1142,16 @@ value_check_printable (struct value *val, struct ui_file *stream,
       return 0;
     }
 
-  if (value_entirely_optimized_out (val))
+  if (val_print_array_windowed_p (value_type (val), 0, val))
+    {
+      /* Do not fetch an array that is printed a window at a time, but
+	 still report an array that cannot be read at all as an error,
+	 as fetching it would.  */
+      gdb_byte first;
+
+      read_memory (value_address (val), &first, 1);
+    }
+  else if (value_entirely_optimized_out (val))
     {
       if (options->summary && !val_print_scalar_type_p (value_type (val)))
 	fprintf_filtered (stream, "...");
@@ -1149,8 +1159,7 @@ value_check_printable (struct value *val, struct ui_file *stream,
 	val_print_optimized_out (val, stream);
       return 0;
     }
-
-  if (value_entirely_unavailable (val))
+  else if (value_entirely_unavailable (val))
     {
       if (options->summary && !val_print_scalar_type_p (value_type (val)))
 	fprintf_filtered (stream, "...");
@@ -1202,7 +1211,8 @@ common_val_print (struct value *val, struct ui_file *stream, int recurse,
        get a fixed representation of our value.  */
     val = ada_to_fixed_value (val);
 
-  if (value_lazy (val))
+  if (value_lazy (val)
+      && !val_print_array_windowed_p (value_type (val), 0, val))
     value_fetch_lazy (val);
 
   val_print (value_type (val),
@@ -1986,6 +1996,262 @@ maybe_print_array_index (struct type *index_type, LONGEST index,
   LA_PRINT_ARRAY_INDEX (index_value, stream, options);
 }
 
+/* See valprint.h.  */
+
+int
+val_print_array_windowed_p (struct type *type, LONGEST embedded_offset,
+			    struct value *val)
+{
+  type = check_typedef (type);
+
+  return (TYPE_CODE (type) == TYPE_CODE_ARRAY
+	  && value_lazy (val)
+	  && VALUE_LVAL (val) == lval_memory
+	  && value_bitsize (val) == 0
+	  && embedded_offset == 0
+	  && value_embedded_offset (val) == 0
+	  && check_typedef (value_enclosing_type (val)) == type
+	  && TYPE_LENGTH (type) > VAL_PRINT_ARRAY_WINDOW
+	  && TYPE_LENGTH (check_typedef (TYPE_TARGET_TYPE (type))) > 0
+	  && gdbarch_addressable_memory_unit_size (get_type_arch (type)) == 1
+	  /* Traceframes may have collected only parts of the array,
+	     which value_check_printable has to see as a whole.  */
+	  && get_traceframe_number () < 0);
+}
+
+/* A run of consecutive elements of an array being printed, held in
+   the contents of VAL starting at OFFSET.  */
+
+struct array_window
+{
+  /* The value holding the elements, and the offset and address to
+     pass to val_print along with it.  */
+  struct value *val;
+  LONGEST offset;
+  CORE_ADDR address;
+
+  /* The index of the first element held, and the number of elements
+     held.  */
+  unsigned int first;
+  unsigned int count;
+
+  /* Whether all the bytes of the elements are available and none is
+     optimized out, so that they can be compared with memcmp.  */
+  bool plain;
+};
+
+/* The elements of an array printed by val_print_array_elements.
+   Usually the array has been fetched and is a single window.  An
+   array val_print_array_windowed_p accepts is read from memory a
+   window at a time instead, so that printing it reads only as much of
+   it as is shown, and holds at most two windows at once.  */
+
+class array_element_reader
+{
+public:
+  array_element_reader (struct type *elttype, unsigned int eltlen,
+			unsigned int len, LONGEST embedded_offset,
+			CORE_ADDR address, struct value *val, bool windowed);
+  ~array_element_reader ();
+
+  /* Return the value holding element I, and set *OFFSET and *ADDRESS
+     to what to pass to val_print along with it.  */
+  struct value *element (unsigned int i, LONGEST *offset,
+			 CORE_ADDR *address);
+
+  /* Return the number of consecutive elements starting with element I
+     that are equal to it, which is at least 1.  */
+  unsigned int repeats (unsigned int i);
+
+private:
+  const array_window &window_for (unsigned int i, int slot);
+  void fetch (unsigned int first, int slot);
+
+  struct type *m_elttype;
+  unsigned int m_eltlen;
+  unsigned int m_len;
+  bool m_windowed;
+
+  /* For a windowed array, the address of its first element, the
+     number of elements in a full window, and the type of a full
+     window, created on first use.  */
+  CORE_ADDR m_base = 0;
+  unsigned int m_window_elts = 0;
+  struct type *m_window_type = NULL;
+
+  /* Slot 0 holds the element being printed, slot 1 the elements it
+     is compared to when looking for repeats.  */
+  array_window m_windows[2];
+};
+
+array_element_reader::array_element_reader (struct type *elttype,
+					    unsigned int eltlen,
+					    unsigned int len,
+					    LONGEST embedded_offset,
+					    CORE_ADDR address,
+					    struct value *val, bool windowed)
+  : m_elttype (elttype), m_eltlen (eltlen), m_len (len),
+    m_windowed (windowed)
+{
+  memset (m_windows, 0, sizeof (m_windows));
+
+  if (m_windowed)
+    {
+      m_base = value_address (val) + embedded_offset;
+      m_window_elts = std::max (VAL_PRINT_ARRAY_WINDOW / m_eltlen, 1u);
+      return;
+    }
+
+  array_window &w = m_windows[0];
+  w.val = val;
+  w.offset = embedded_offset;
+  w.address = address;
+  w.first = 0;
+  w.count = len;
+  w.plain = (!value_lazy (val)
+	     && eltlen > 0
+	     && (gdbarch_addressable_memory_unit_size
+		 (get_type_arch (elttype)) == 1)
+	     && value_bytes_available (val, embedded_offset,
+				       (LONGEST) len * eltlen)
+	     && !value_bits_any_optimized_out (val,
+					       (TARGET_CHAR_BIT
+						* embedded_offset),
+					       (TARGET_CHAR_BIT
+						* (LONGEST) len * eltlen)));
+}
+
+array_element_reader::~array_element_reader ()
+{
+  if (m_windowed)
+    {
+      value_free (m_windows[0].val);
+      value_free (m_windows[1].val);
+    }
+}
+
+/* Return a window holding element I, reading it into SLOT if neither
+   slot holds it.  A window wanted in slot 0 that is in slot 1 is
+   moved there, so that the next read into slot 1 keeps it.  */
+
+const array_window &
+array_element_reader::window_for (unsigned int i, int slot)
+{
+  for (int k = 0; k < 2; k++)
+    {
+      const array_window &w = m_windows[slot ^ k];
+
+      if (w.val != NULL && i >= w.first && i - w.first < w.count)
+	{
+	  if (k != 0 && slot == 0)
+	    {
+	      std::swap (m_windows[0], m_windows[1]);
+	      return m_windows[0];
+	    }
+	  return w;
+	}
+    }
+
+  gdb_assert (m_windowed);
+  fetch (i, slot);
+  return m_windows[slot];
+}
+
+/* Read the window starting at element FIRST into SLOT.  */
+
+void
+array_element_reader::fetch (unsigned int first, int slot)
+{
+  array_window &w = m_windows[slot];
+  unsigned int count = std::min (m_window_elts, m_len - first);
+  struct type *window_type;
+
+  value_free (w.val);
+  w.val = NULL;
+
+  if (count == m_window_elts)
+    {
+      if (m_window_type == NULL)
+	m_window_type = lookup_array_range_type (m_elttype, 0, count - 1);
+      window_type = m_window_type;
+    }
+  else
+    window_type = lookup_array_range_type (m_elttype, 0, count - 1);
+
+  w.val = value_at_lazy (window_type,
+			 m_base + (CORE_ADDR) first * m_eltlen);
+  release_value (w.val);
+  w.offset = 0;
+  w.address = value_address (w.val);
+  w.first = first;
+  w.count = count;
+
+  value_fetch_lazy (w.val);
+  w.plain = (value_entirely_available (w.val)
+	     && !value_optimized_out (w.val));
+}
+
+struct value *
+array_element_reader::element (unsigned int i, LONGEST *offset,
+			       CORE_ADDR *address)
+{
+  const array_window &w = window_for (i, 0);
+
+  *offset = w.offset + (LONGEST) (i - w.first) * m_eltlen;
+  *address = w.address;
+  return w.val;
+}
+
+unsigned int
+array_element_reader::repeats (unsigned int i)
+{
+  const array_window &cur = window_for (i, 0);
+  LONGEST cur_offset = cur.offset + (LONGEST) (i - cur.first) * m_eltlen;
+  unsigned int rep1 = i + 1;
+
+  while (rep1 < m_len)
+    {
+      const array_window &w = window_for (rep1, 1);
+
+      QUIT;
+
+      if (!value_contents_eq (cur.val, cur_offset,
+			      w.val,
+			      w.offset + (LONGEST) (rep1 - w.first) * m_eltlen,
+			      m_eltlen))
+	break;
+      ++rep1;
+
+      if (!w.plain)
+	continue;
+
+      /* Element REP1 - 1 is in W and equal to element I.  Rather than
+	 comparing the elements of W that follow it one at a time,
+	 compare blocks of them with the same blocks shifted back by one
+	 element: if those are equal, all the elements of the block are
+	 equal to element REP1 - 1.  Halve the block size at the first
+	 difference, to find the end of the run.  */
+      const gdb_byte *contents = value_contents_for_printing (w.val);
+      unsigned int end = w.first + w.count;
+      unsigned int block = std::max (4096 / m_eltlen, 1u);
+
+      while (rep1 < end && block > 0)
+	{
+	  unsigned int n = std::min (block, end - rep1);
+	  const gdb_byte *prev
+	    = (contents + w.offset
+	       + (size_t) (rep1 - 1 - w.first) * m_eltlen);
+
+	  if (memcmp (prev, prev + m_eltlen, (size_t) n * m_eltlen) == 0)
+	    rep1 += n;
+	  else
+	    block /= 2;
+	}
+    }
+
+  return rep1 - i;
+}
+
 /*  Called by various <lang>_val_print routines to print elements of an
    array in the form "<elem1>, <elem2>, <elem3>, ...".
 
@@ -2007,9 +2273,6 @@ val_print_array_elements (struct type *type,
   unsigned len;
   struct type *elttype, *index_type, *base_index_type;
   unsigned eltlen;
-  /* Position of the array element we are examining to see
-     whether it is repeated.  */
-  unsigned int rep1;
   /* Number of repetitions we have detected so far.  */
   unsigned int reps;
   LONGEST low_bound, high_bound;
@@ -2056,6 +2319,12 @@ val_print_array_elements (struct type *type,
       len = 0;
     }
 
+  array_element_reader elements (elttype, eltlen, len, embedded_offset,
+				 address, val,
+				 val_print_array_windowed_p (type,
+							     embedded_offset,
+							     val));
+
   annotate_array_section_begin (i, elttype);
 
   for (; i < len && things_printed < options->print_max; i++)
@@ -2076,42 +2345,34 @@ val_print_array_elements (struct type *type,
       maybe_print_array_index (index_type, i + low_bound,
                                stream, options);
 
-      rep1 = i + 1;
       reps = 1;
       /* Only check for reps if repeat_count_threshold is not set to
 	 UINT_MAX (unlimited).  */
       if (options->repeat_count_threshold < UINT_MAX)
-	{
-	  while (rep1 < len
-		 && value_contents_eq (val,
-				       embedded_offset + i * eltlen,
-				       val,
-				       (embedded_offset
-					+ rep1 * eltlen),
-				       eltlen))
-	    {
-	      ++reps;
-	      ++rep1;
-	    }
-	}
+	reps = elements.repeats (i);
+
+      LONGEST elt_offset;
+      CORE_ADDR elt_address;
+      struct value *elt_val = elements.element (i, &elt_offset,
+						&elt_address);
 
       if (reps > options->repeat_count_threshold)
 	{
-	  val_print (elttype, embedded_offset + i * eltlen,
-		     address, stream, recurse + 1, val, options,
+	  val_print (elttype, elt_offset,
+		     elt_address, stream, recurse + 1, elt_val, options,
 		     current_language);
 	  annotate_elt_rep (reps);
 	  fprintf_filtered (stream, " <repeats %u times>", reps);
 	  annotate_elt_rep_end ();
 
-	  i = rep1 - 1;
+	  i += reps - 1;
 	  things_printed += options->repeat_count_threshold;
 	}
       else
 	{
-	  val_print (elttype, embedded_offset + i * eltlen,
-		     address,
-		     stream, recurse + 1, val, options, current_language);
+	  val_print (elttype, elt_offset,
+		     elt_address,
+		     stream, recurse + 1, elt_val, options, current_language);
 	  annotate_elt ();
 	  things_printed++;
 	}
@@ -121,6 +121,22 @@ extern void val_print_array_elements (struct type *, LONGEST,
 				      const struct value_print_options *,
 				      unsigned int);
 
+/* The number of bytes of an array val_print_array_elements reads from
+   the inferior at a time when printing an array that has not been
+   fetched.  */
+
+#define VAL_PRINT_ARRAY_WINDOW 65536
+
+/* Return non-zero if the array of type TYPE at EMBEDDED_OFFSET in VAL
+   should be printed without fetching VAL, leaving
+   val_print_array_elements to read its elements a window at a time.
+   This is the case for a lazy array in memory bigger than one
+   window.  */
+
+extern int val_print_array_windowed_p (struct type *type,
+				       LONGEST embedded_offset,
+				       struct value *val);
+
 extern void val_print_type_code_int (struct type *, const gdb_byte *,
 				     struct ui_file *);
 
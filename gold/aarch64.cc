@@ -3247,6 +3247,25 @@ class Target_aarch64 : public Sized_target<size, big_endian>
 
   };  // End of class Relocate
 
+  // The relocations which relocate_section can apply directly, for
+  // use with gold::relocate_section_fast.
+  class Fast_relocate
+  {
+   public:
+    // Apply a relocation against a local symbol.  Return false if
+    // Relocate::relocate must handle it.
+    static inline bool
+    relocate(const Sized_relobj_file<size, big_endian>*, unsigned int r_type,
+	     const Symbol_value<size>*, elfcpp::Elf_Xword addend,
+	     unsigned char* view, section_size_type view_size,
+	     typename elfcpp::Elf_types<size>::Elf_Addr address);
+
+    // Whether a relocation of type R_TYPE may change how the next
+    // relocation is handled.
+    static inline bool
+    affects_next(unsigned int r_type);
+  };  // End of class Fast_relocate
+
   // Adjust TLS relocation type based on the options and whether this
   // is a local symbol.
   static tls::Tls_optimization
@@ -7205,6 +7224,140 @@ Target_aarch64<size, big_endian>::Relocate::relocate(
 }
 
 
+// Apply one of the common relocations against a local symbol.  This
+// must give the same result as Relocate::relocate.  Branches which
+// need a stub are left to Relocate::relocate.
+
+template<int size, bool big_endian>
+inline bool
+Target_aarch64<size, big_endian>::Fast_relocate::relocate(
+    const Sized_relobj_file<size, big_endian>* object,
+    unsigned int r_type,
+    const Symbol_value<size>* psymval,
+    elfcpp::Elf_Xword addend,
+    unsigned char* view,
+    section_size_type view_size,
+    typename elfcpp::Elf_types<size>::Elf_Addr address)
+{
+  typedef AArch64_relocate_functions<size, big_endian> Reloc;
+
+  section_size_type width = 4;
+  switch (r_type)
+    {
+    case elfcpp::R_AARCH64_ABS64:
+    case elfcpp::R_AARCH64_PREL64:
+      width = 8;
+      break;
+
+    case elfcpp::R_AARCH64_CALL26:
+    case elfcpp::R_AARCH64_JUMP26:
+      if (!parameters->options().relocatable()
+	  && (The_reloc_stub::stub_type_for_reloc(
+		r_type, address, psymval->value(object, 0) + addend)
+	      != ST_NONE))
+	return false;
+      break;
+
+    case elfcpp::R_AARCH64_ABS32:
+    case elfcpp::R_AARCH64_PREL32:
+    case elfcpp::R_AARCH64_ADR_PREL_PG_HI21:
+    case elfcpp::R_AARCH64_ADR_PREL_PG_HI21_NC:
+    case elfcpp::R_AARCH64_ADD_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST8_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST16_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST32_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST64_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST128_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_TSTBR14:
+    case elfcpp::R_AARCH64_CONDBR19:
+      break;
+
+    default:
+      return false;
+    }
+
+  if (view_size < width)
+    return false;
+
+  const AArch64_reloc_property* reloc_property =
+      aarch64_reloc_property_table->get_reloc_property(r_type);
+  if (reloc_property == NULL)
+    return false;
+
+  typename Reloc::Status reloc_status;
+  switch (r_type)
+    {
+    case elfcpp::R_AARCH64_ABS64:
+      reloc_status = Reloc::template rela_ua<64>(
+	view, object, psymval, addend, reloc_property);
+      break;
+
+    case elfcpp::R_AARCH64_ABS32:
+      reloc_status = Reloc::template rela_ua<32>(
+	view, object, psymval, addend, reloc_property);
+      break;
+
+    case elfcpp::R_AARCH64_PREL64:
+      reloc_status = Reloc::template pcrela_ua<64>(
+	view, object, psymval, addend, address, reloc_property);
+      break;
+
+    case elfcpp::R_AARCH64_PREL32:
+      reloc_status = Reloc::template pcrela_ua<32>(
+	view, object, psymval, addend, address, reloc_property);
+      break;
+
+    case elfcpp::R_AARCH64_ADR_PREL_PG_HI21:
+    case elfcpp::R_AARCH64_ADR_PREL_PG_HI21_NC:
+      reloc_status = Reloc::adrp(view, object, psymval, addend, address,
+				 reloc_property);
+      break;
+
+    case elfcpp::R_AARCH64_ADD_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST8_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST16_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST32_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST64_ABS_LO12_NC:
+    case elfcpp::R_AARCH64_LDST128_ABS_LO12_NC:
+      reloc_status = Reloc::template rela_general<32>(
+	view, object, psymval, addend, reloc_property);
+      break;
+
+    default:
+      reloc_status = Reloc::template pcrela_general<32>(
+	view, object, psymval, addend, address, reloc_property);
+      break;
+    }
+
+  // Let Relocate::relocate report any error.
+  return reloc_status == Reloc::STATUS_OKAY;
+}
+
+// A TLS relocation may cause Relocate::relocate to skip the call to
+// __tls_get_addr which follows it, so the next relocation has to go
+// through Relocate::relocate too.
+
+template<int size, bool big_endian>
+inline bool
+Target_aarch64<size, big_endian>::Fast_relocate::affects_next(
+    unsigned int r_type)
+{
+  switch (r_type)
+    {
+    case elfcpp::R_AARCH64_TLSGD_ADR_PAGE21:
+    case elfcpp::R_AARCH64_TLSGD_ADD_LO12_NC:
+    case elfcpp::R_AARCH64_TLSLD_ADR_PAGE21:
+    case elfcpp::R_AARCH64_TLSLD_ADD_LO12_NC:
+    case elfcpp::R_AARCH64_TLSDESC_ADR_PAGE21:
+    case elfcpp::R_AARCH64_TLSDESC_LD64_LO12:
+    case elfcpp::R_AARCH64_TLSDESC_ADD_LO12:
+    case elfcpp::R_AARCH64_TLSDESC_CALL:
+      return true;
+    default:
+      return false;
+    }
+}
+
 template<int size, bool big_endian>
 inline
 typename AArch64_relocate_functions<size, big_endian>::Status
@@ -7962,13 +8115,16 @@ Target_aarch64<size, big_endian>::relocate_section(
 {
   typedef Target_aarch64<size, big_endian> Aarch64;
   typedef typename Target_aarch64<size, big_endian>::Relocate AArch64_relocate;
+  typedef typename Target_aarch64<size, big_endian>::Fast_relocate
+      AArch64_fast_relocate;
   typedef gold::Default_classify_reloc<elfcpp::SHT_RELA, size, big_endian>
       Classify_reloc;
 
   gold_assert(sh_type == elfcpp::SHT_RELA);
 
-  gold::relocate_section<size, big_endian, Aarch64, AArch64_relocate,
-			 gold::Default_comdat_behavior, Classify_reloc>(
+  gold::relocate_section_fast<size, big_endian, Aarch64, AArch64_relocate,
+			      gold::Default_comdat_behavior, Classify_reloc,
+			      AArch64_fast_relocate>(
     relinfo,
     this,
     prelocs,
@@ -1498,7 +1498,8 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
       attributes_section_data_(NULL), mapping_symbols_info_(),
       section_has_cortex_a8_workaround_(NULL), exidx_section_map_(),
       output_local_symbol_count_needs_update_(false),
-      merge_flags_and_attributes_(true)
+      merge_flags_and_attributes_(true), stub_scan_sections_(),
+      stub_scan_done_(false)
   { }
 
   ~Arm_relobj()
@@ -1763,6 +1764,12 @@ class Arm_relobj : public Sized_relobj_file<32, big_endian>
   // Whether we merge processor flags and attributes of this object to
   // output.
   bool merge_flags_and_attributes_;
+  // Indexes of the relocation sections which contain branch relocations,
+  // and so must be scanned for stubs again whenever the layout changes.
+  // This is only valid if STUB_SCAN_DONE_ is true.
+  std::vector<unsigned int> stub_scan_sections_;
+  // Whether we have scanned all relocation sections for stubs once.
+  bool stub_scan_done_;
 };
 
 // Arm_dynobj class.
@@ -2419,8 +2426,9 @@ class Target_arm : public Sized_target<32, big_endian>
   Stub_table<big_endian>*
   new_stub_table(Arm_input_section<big_endian>*);
 
-  // Scan a section for stub generation.
-  void
+  // Scan a section for stub generation.  Return true if the section
+  // has any branch relocations, whose stubs depend on the layout.
+  bool
   scan_section_for_stubs(const Relocate_info<32, big_endian>*, unsigned int,
 			 const unsigned char*, size_t, Output_section*,
 			 bool, const unsigned char*, Arm_address,
@@ -2941,9 +2949,10 @@ class Target_arm : public Sized_target<32, big_endian>
 		      const Symbol_value<32>*,
 		      elfcpp::Elf_types<32>::Elf_Swxword, Arm_address);
 
-  // Scan a relocation section for stub.
+  // Scan a relocation section for stub.  Return true if there are any
+  // branch relocations.
   template<int sh_type>
-  void
+  bool
   scan_reloc_section_for_stubs(
       const Relocate_info<32, big_endian>* relinfo,
       const unsigned char* prelocs,
@@ -6379,6 +6388,14 @@ Arm_relobj<big_endian>::scan_sections_for_stubs(
     const Symbol_table* symtab,
     const Layout* layout)
 {
+  // After the first pass, only the relocation sections with branch
+  // relocations can produce new stubs.  If there are none, and we do
+  // not need to look for the Cortex-A8 erratum, there is nothing to do.
+  if (this->stub_scan_done_
+      && this->stub_scan_sections_.empty()
+      && !arm_target->fix_cortex_a8())
+    return;
+
   unsigned int shnum = this->shnum();
   const unsigned int shdr_size = elfcpp::Elf_sizes<32>::shdr_size;
 
@@ -6398,58 +6415,76 @@ Arm_relobj<big_endian>::scan_sections_for_stubs(
   relinfo.layout = layout;
   relinfo.object = this;
 
-  // Do relocation stubs scanning.
-  const unsigned char* p = pshdrs + shdr_size;
-  for (unsigned int i = 1; i < shnum; ++i, p += shdr_size)
+  // Do relocation stubs scanning.  The first time through we look at
+  // every relocation section and remember the ones with branch
+  // relocations.  Relocation sections without them only produce
+  // layout independent stubs, so later relaxation passes skip them.
+  std::vector<unsigned int> scan_sections;
+  if (!this->stub_scan_done_)
     {
-      const elfcpp::Shdr<32, big_endian> shdr(p);
-      if (this->section_needs_reloc_stub_scanning(shdr, out_sections, symtab,
-						  pshdrs))
+      const unsigned char* p = pshdrs + shdr_size;
+      for (unsigned int i = 1; i < shnum; ++i, p += shdr_size)
 	{
-	  unsigned int index = this->adjust_shndx(shdr.get_sh_info());
-	  Arm_address output_offset = this->get_output_section_offset(index);
-	  Arm_address output_address;
-	  if (output_offset != invalid_address)
-	    output_address = out_sections[index]->address() + output_offset;
-	  else
-	    {
-	      // Currently this only happens for a relaxed section.
-	      const Output_relaxed_input_section* poris =
-	      out_sections[index]->find_relaxed_input_section(this, index);
-	      gold_assert(poris != NULL);
-	      output_address = poris->address();
-	    }
+	  const elfcpp::Shdr<32, big_endian> shdr(p);
+	  if (this->section_needs_reloc_stub_scanning(shdr, out_sections,
+						      symtab, pshdrs))
+	    scan_sections.push_back(i);
+	}
+    }
+  else
+    scan_sections.swap(this->stub_scan_sections_);
+
+  for (std::vector<unsigned int>::const_iterator ps = scan_sections.begin();
+       ps != scan_sections.end();
+       ++ps)
+    {
+      unsigned int i = *ps;
+      const elfcpp::Shdr<32, big_endian> shdr(pshdrs + i * shdr_size);
+      unsigned int index = this->adjust_shndx(shdr.get_sh_info());
+      Arm_address output_offset = this->get_output_section_offset(index);
+      Arm_address output_address;
+      if (output_offset != invalid_address)
+	output_address = out_sections[index]->address() + output_offset;
+      else
+	{
+	  // Currently this only happens for a relaxed section.
+	  const Output_relaxed_input_section* poris =
+	  out_sections[index]->find_relaxed_input_section(this, index);
+	  gold_assert(poris != NULL);
+	  output_address = poris->address();
+	}
 
-	  // Get the relocations.
-	  const unsigned char* prelocs = this->get_view(shdr.get_sh_offset(),
-							shdr.get_sh_size(),
-							true, false);
-
-	  // Get the section contents.  This does work for the case in which
-	  // we modify the contents of an input section.  We need to pass the
-	  // output view under such circumstances.
-	  section_size_type input_view_size = 0;
-	  const unsigned char* input_view =
-	    this->section_contents(index, &input_view_size, false);
-
-	  relinfo.reloc_shndx = i;
-	  relinfo.data_shndx = index;
-	  unsigned int sh_type = shdr.get_sh_type();
-	  unsigned int reloc_size;
-	  if (sh_type == elfcpp::SHT_REL)
-	    reloc_size = elfcpp::Elf_sizes<32>::rel_size;
-	  else
-	    reloc_size = elfcpp::Elf_sizes<32>::rela_size;
+      // Get the relocations.
+      const unsigned char* prelocs = this->get_view(shdr.get_sh_offset(),
+						    shdr.get_sh_size(),
+						    true, false);
+
+      // Get the section contents.  This does work for the case in which
+      // we modify the contents of an input section.  We need to pass the
+      // output view under such circumstances.
+      section_size_type input_view_size = 0;
+      const unsigned char* input_view =
+	this->section_contents(index, &input_view_size, false);
+
+      relinfo.reloc_shndx = i;
+      relinfo.data_shndx = index;
+      unsigned int sh_type = shdr.get_sh_type();
+      unsigned int reloc_size;
+      if (sh_type == elfcpp::SHT_REL)
+	reloc_size = elfcpp::Elf_sizes<32>::rel_size;
+      else
+	reloc_size = elfcpp::Elf_sizes<32>::rela_size;
 
-	  Output_section* os = out_sections[index];
-	  arm_target->scan_section_for_stubs(&relinfo, sh_type, prelocs,
+      Output_section* os = out_sections[index];
+      if (arm_target->scan_section_for_stubs(&relinfo, sh_type, prelocs,
 					     shdr.get_sh_size() / reloc_size,
 					     os,
 					     output_offset == invalid_address,
 					     input_view, output_address,
-					     input_view_size);
-	}
+					     input_view_size))
+	this->stub_scan_sections_.push_back(i);
     }
+  this->stub_scan_done_ = true;
 
   // Do Cortex-A8 erratum stubs scanning.  This has to be done for a section
   // after its relocation section, if there is one, is processed for
@@ -12021,7 +12056,7 @@ Target_arm<big_endian>::scan_reloc_for_stub(
 
 template<bool big_endian>
 template<int sh_type>
-void inline
+bool inline
 Target_arm<big_endian>::scan_reloc_section_for_stubs(
     const Relocate_info<32, big_endian>* relinfo,
     const unsigned char* prelocs,
@@ -12042,6 +12077,7 @@ Target_arm<big_endian>::scan_reloc_section_for_stubs(
 
   gold::Default_comdat_behavior default_comdat_behavior;
   Comdat_behavior comdat_behavior = CB_UNDETERMINED;
+  bool has_branch_relocs = false;
 
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
@@ -12064,6 +12100,11 @@ Target_arm<big_endian>::scan_reloc_section_for_stubs(
 	 && (r_type != elfcpp::R_ARM_V4BX))
 	continue;
 
+      // V4BX stubs do not depend on the layout, so we only need to
+      // create them once.
+      if (r_type != elfcpp::R_ARM_V4BX)
+	has_branch_relocs = true;
+
       section_offset_type offset =
 	convert_to_section_size_type(reloc.get_r_offset());
 
@@ -12253,12 +12294,14 @@ Target_arm<big_endian>::scan_reloc_section_for_stubs(
       this->scan_reloc_for_stub(relinfo, r_type, sym, r_sym, psymval,
 				addend, view_address + offset);
     }
+
+  return has_branch_relocs;
 }
 
 // Scan an input section for stub generation.
 
 template<bool big_endian>
-void
+bool
 Target_arm<big_endian>::scan_section_for_stubs(
     const Relocate_info<32, big_endian>* relinfo,
     unsigned int sh_type,
@@ -12271,7 +12314,7 @@ Target_arm<big_endian>::scan_section_for_stubs(
     section_size_type view_size)
 {
   if (sh_type == elfcpp::SHT_REL)
-    this->scan_reloc_section_for_stubs<elfcpp::SHT_REL>(
+    return this->scan_reloc_section_for_stubs<elfcpp::SHT_REL>(
 	relinfo,
 	prelocs,
 	reloc_count,
@@ -12283,7 +12326,7 @@ Target_arm<big_endian>::scan_section_for_stubs(
   else if (sh_type == elfcpp::SHT_RELA)
     // We do not support RELA type relocations yet.  This is provided for
     // completeness.
-    this->scan_reloc_section_for_stubs<elfcpp::SHT_RELA>(
+    return this->scan_reloc_section_for_stubs<elfcpp::SHT_RELA>(
 	relinfo,
 	prelocs,
 	reloc_count,
@@ -12467,11 +12510,13 @@ Target_arm<big_endian>::do_relax(
 
   // Check all stub tables to see if any of them have their data sizes
   // or addresses alignments changed.  These are the only things that
-  // matter.
+  // matter.  Update every table that changed, rather than stopping at
+  // the first one, so that all the growth found in this pass is
+  // accounted for in the next layout and we need fewer passes.
   bool any_stub_table_changed = false;
   Unordered_set<const Output_section*> sections_needing_adjustment;
   for (Stub_table_iterator sp = this->stub_tables_.begin();
-       (sp != this->stub_tables_.end()) && !any_stub_table_changed;
+       sp != this->stub_tables_.end();
        ++sp)
     {
       if ((*sp)->update_data_size_and_addralign())
@@ -12508,8 +12553,8 @@ Target_arm<big_endian>::do_relax(
   if (!continue_relaxation)
     {
       for (Stub_table_iterator sp = this->stub_tables_.begin();
-	   (sp != this->stub_tables_.end()) && !any_stub_table_changed;
-	    ++sp)
+	   sp != this->stub_tables_.end();
+	   ++sp)
 	(*sp)->finalize_stubs();
 
       // Update output local symbol counts of objects if necessary.
@@ -57,6 +57,7 @@
 #include "plugin.h"
 #include "incremental.h"
 #include "layout.h"
+#include "timer.h"
 
 namespace gold
 {
@@ -469,6 +470,9 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     script_output_section_data_list_(),
     segment_states_(NULL),
     relaxation_debug_check_(NULL),
+    relaxation_passes_(0),
+    relaxation_layout_time_(0),
+    relaxation_relax_time_(0),
     section_order_map_(),
     section_segment_map_(),
     input_section_position_(),
@@ -2783,16 +2787,32 @@ Layout::finalize(const Input_objects* input_objects, Symbol_table* symtab,
   if (target->may_relax())
     this->prepare_for_relaxation();
 
-  // Run the relaxation loop to lay out sections.
+  // Run the relaxation loop to lay out sections.  With --stats, time
+  // the layout and the target's relaxation separately.
+  const bool stats = parameters->options().stats();
+  Timer timer;
+  bool again = false;
   do
     {
+      if (stats)
+	timer.start();
       off = this->relaxation_loop_body(pass, target, symtab, &load_seg,
 				       phdr_seg, segment_headers, file_header,
 				       &shndx);
+      if (stats)
+	this->relaxation_layout_time_ += timer.get_elapsed_time().wall;
       pass++;
+
+      if (!target->may_relax())
+	break;
+      if (stats)
+	timer.start();
+      again = target->relax(pass, input_objects, symtab, this, task);
+      if (stats)
+	this->relaxation_relax_time_ += timer.get_elapsed_time().wall;
     }
-  while (target->may_relax()
-	 && target->relax(pass, input_objects, symtab, this, task));
+  while (again);
+  this->relaxation_passes_ = pass;
 
   // If there is a load segment that contains the file and program headers,
   // provide a symbol __ehdr_start pointing there.
@@ -5583,6 +5603,20 @@ Layout::print_stats() const
   this->sympool_.print_stats("output symbol name pool");
   this->dynpool_.print_stats("dynamic name pool");
 
+  if (parameters->target().may_relax())
+    {
+      fprintf(stderr, _("%s: layout relaxation passes: %d\n"),
+	      program_name, this->relaxation_passes_);
+      fprintf(stderr,
+	      _("%s: layout relaxation time: "
+		"(layout: %ld.%06ld target: %ld.%06ld)\n"),
+	      program_name,
+	      this->relaxation_layout_time_ / 1000,
+	      (this->relaxation_layout_time_ % 1000) * 1000,
+	      this->relaxation_relax_time_ / 1000,
+	      (this->relaxation_relax_time_ % 1000) * 1000);
+    }
+
   for (Section_list::const_iterator p = this->section_list_.begin();
        p != this->section_list_.end();
        ++p)
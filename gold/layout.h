@@ -1429,6 +1429,12 @@ class Layout
   Segment_states* segment_states_;
   // A relaxation debug checker.  We only create one when in debugging mode.
   Relaxation_debug_check* relaxation_debug_check_;
+  // The number of times we laid out the sections, for --stats.
+  int relaxation_passes_;
+  // The wall clock time, in milliseconds, spent laying out the
+  // sections and in Target::relax during relaxation, for --stats.
+  long relaxation_layout_time_;
+  long relaxation_relax_time_;
   // Plugins specify section_ordering using this map.  This is set in
   // update_section_order in plugin.cc
   std::map<Section_id, unsigned int> section_order_map_;
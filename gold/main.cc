@@ -29,6 +29,10 @@
 #include <malloc.h>
 #endif
 
+#ifdef HAVE_GETRUSAGE
+#include <sys/resource.h>
+#endif
+
 #include "libiberty.h"
 
 #include "script.h"
@@ -294,6 +298,12 @@ main(int argc, char** argv)
       struct mallinfo m = mallinfo();
       fprintf(stderr, _("%s: total space allocated by malloc: %d bytes\n"),
 	      program_name, m.arena);
+#endif
+#ifdef HAVE_GETRUSAGE
+      struct rusage ru;
+      if (getrusage(RUSAGE_SELF, &ru) == 0)
+	fprintf(stderr, _("%s: peak resident set size: %ld kbytes\n"),
+		program_name, static_cast<long>(ru.ru_maxrss));
 #endif
       File_read::print_stats();
       Archive::print_stats();
@@ -167,6 +167,9 @@ static enum ld_plugin_status
 get_input_section_size(const struct ld_plugin_section section,
                        uint64_t* secsize);
 
+static enum ld_plugin_status
+allow_parallel_claim_file();
+
 };
 
 #endif // ENABLE_PLUGINS
@@ -211,7 +214,7 @@ Plugin::load()
   sscanf(ver, "%d.%d", &major, &minor);
 
   // Allocate and populate a transfer vector.
-  const int tv_fixed_size = 29;
+  const int tv_fixed_size = 30;
 
   int tv_size = this->args_.size() + tv_fixed_size;
   ld_plugin_tv* tv = new ld_plugin_tv[tv_size];
@@ -345,6 +348,10 @@ Plugin::load()
   tv[i].tv_tag = LDPT_GET_INPUT_SECTION_SIZE;
   tv[i].tv_u.tv_get_input_section_size = get_input_section_size;
 
+  ++i;
+  tv[i].tv_tag = LDPT_ALLOW_PARALLEL_CLAIM_FILE;
+  tv[i].tv_u.tv_allow_parallel_claim_file = allow_parallel_claim_file;
+
   ++i;
   tv[i].tv_tag = LDPT_NULL;
   tv[i].tv_u.tv_val = 0;
@@ -452,6 +459,7 @@ Plugin_manager::~Plugin_manager()
     delete *obj;
   this->objects_.clear();
   delete this->lock_;
+  delete this->claim_lock_;
 }
 
 // Load all plugin libraries.
@@ -467,51 +475,83 @@ Plugin_manager::load_plugins(Layout* layout)
 }
 
 // Call the plugin claim-file handlers in turn to see if any claim the file.
+// This is called from Read_symbols tasks, which may run in parallel.  We
+// only hold the manager lock while updating our own tables, so the
+// claim-file handlers of plugins which have called
+// allow_parallel_claim_file run concurrently.  Other handlers are
+// serialized by claim_lock_.
 
 Pluginobj*
 Plugin_manager::claim_file(Input_file* input_file, off_t offset,
                            off_t filesize, Object* elf_object)
 {
   bool lock_initialized = this->initialize_lock_.initialize();
-
   gold_assert(lock_initialized);
-  Hold_lock hl(*this->lock_);
-  if (this->in_replacement_phase_)
-    return NULL;
+  lock_initialized = this->initialize_claim_lock_.initialize();
+  gold_assert(lock_initialized);
+
+  Claim_state claim;
+  claim.input_file = input_file;
+  claim.plugin_input_file.name = input_file->filename().c_str();
+  claim.plugin_input_file.fd = input_file->file().descriptor();
+  claim.plugin_input_file.offset = offset;
+  claim.plugin_input_file.filesize = filesize;
+
+  // Reserve a handle for this file.
+  unsigned int handle;
+  {
+    Hold_lock hl(*this->lock_);
+    if (this->in_replacement_phase_)
+      return NULL;
 
-  unsigned int handle = this->objects_.size();
-  this->input_file_ = input_file;
-  this->plugin_input_file_.name = input_file->filename().c_str();
-  this->plugin_input_file_.fd = input_file->file().descriptor();
-  this->plugin_input_file_.offset = offset;
-  this->plugin_input_file_.filesize = filesize;
-  this->plugin_input_file_.handle = reinterpret_cast<void*>(handle);
-  if (elf_object != NULL)
+    handle = this->objects_.size();
     this->objects_.push_back(elf_object);
-  this->in_claim_file_handler_ = true;
+    claim.plugin_input_file.handle = reinterpret_cast<void*>(handle);
+    this->claims_[handle] = &claim;
+  }
 
-  for (this->current_ = this->plugins_.begin();
-       this->current_ != this->plugins_.end();
-       ++this->current_)
+  bool claimed = false;
+  for (Plugin_list::iterator p = this->plugins_.begin();
+       p != this->plugins_.end() && !claimed;
+       ++p)
     {
-      if ((*this->current_)->claim_file(&this->plugin_input_file_))
-        {
-	  this->any_claimed_ = true;
-	  this->in_claim_file_handler_ = false;
+      if ((*p)->parallel_claim())
+	claimed = (*p)->claim_file(&claim.plugin_input_file);
+      else
+	{
+	  Hold_lock hl(*this->claim_lock_);
+	  claimed = (*p)->claim_file(&claim.plugin_input_file);
+	}
+    }
 
-          if (this->objects_.size() > handle
-              && this->objects_[handle]->pluginobj() != NULL)
-            return this->objects_[handle]->pluginobj();
+  Hold_lock hl(*this->lock_);
+  this->claims_.erase(handle);
+  if (!claimed)
+    return NULL;
 
-          // If the plugin claimed the file but did not call the
-          // add_symbols callback, we need to create the Pluginobj now.
-          Pluginobj* obj = this->make_plugin_object(handle);
-          return obj;
-        }
-    }
+  this->any_claimed_ = true;
 
-  this->in_claim_file_handler_ = false;
-  return NULL;
+  Object* obj = this->objects_[handle];
+  if (obj != NULL && obj->pluginobj() != NULL)
+    return obj->pluginobj();
+
+  // If the plugin claimed the file but did not call the
+  // add_symbols callback, we need to create the Pluginobj now.
+  return this->do_make_plugin_object(handle, &claim);
+}
+
+// Return true if the claim-file handlers are being called for the
+// file with HANDLE.
+
+bool
+Plugin_manager::in_claim_file_handler(const void* handle)
+{
+  if (this->lock_ == NULL)
+    return false;
+  Hold_lock hl(*this->lock_);
+  unsigned int h =
+      static_cast<unsigned int>(reinterpret_cast<intptr_t>(handle));
+  return this->find_claim(h) != NULL;
 }
 
 // Save an archive.  This is used so that a plugin can add a file
@@ -747,22 +787,38 @@ Plugin_manager::cleanup()
 Pluginobj*
 Plugin_manager::make_plugin_object(unsigned int handle)
 {
-  // Make sure we aren't asked to make an object for the same handle twice.
-  if (this->objects_.size() != handle
-      && this->objects_[handle]->pluginobj() != NULL)
+  if (this->lock_ == NULL)
     return NULL;
+  Hold_lock hl(*this->lock_);
+  const Claim_state* claim = this->find_claim(handle);
+  if (claim == NULL)
+    return NULL;
+  return this->do_make_plugin_object(handle, claim);
+}
 
-  Pluginobj* obj = make_sized_plugin_object(this->input_file_,
-                                            this->plugin_input_file_.offset,
-                                            this->plugin_input_file_.filesize);
+// Make a new Pluginobj object for the file described by CLAIM, and
+// store it in the slot reserved for HANDLE.  The caller must hold
+// lock_.
 
+Pluginobj*
+Plugin_manager::do_make_plugin_object(unsigned int handle,
+				      const Claim_state* claim)
+{
+  // Make sure we aren't asked to make an object for the same handle twice.
+  gold_assert(handle < this->objects_.size());
+  if (this->objects_[handle] != NULL
+      && this->objects_[handle]->pluginobj() != NULL)
+    return NULL;
 
-  // If the elf object for this file was pushed into the objects_ vector, delete
-  // it to make room for the Pluginobj as this file is claimed.
-  if (this->objects_.size() != handle)
-    this->objects_.pop_back();
+  Pluginobj* obj =
+    make_sized_plugin_object(claim->input_file,
+			     claim->plugin_input_file.offset,
+			     claim->plugin_input_file.filesize);
 
-  this->objects_.push_back(obj);
+  // If the elf object for this file was stored in the objects_
+  // vector, replace it with the Pluginobj as this file is claimed.
+  // The caller of claim_file owns the elf object.
+  this->objects_[handle] = obj;
   return obj;
 }
 
@@ -773,7 +829,15 @@ ld_plugin_status
 Plugin_manager::get_input_file(unsigned int handle,
                                struct ld_plugin_input_file* file)
 {
-  Pluginobj* obj = this->object(handle)->pluginobj();
+  Object* handle_obj;
+  {
+    Hold_optional_lock hl(this->lock_);
+    handle_obj = this->object(handle);
+  }
+  if (handle_obj == NULL)
+    return LDPS_BAD_HANDLE;
+
+  Pluginobj* obj = handle_obj->pluginobj();
   if (obj == NULL)
     return LDPS_BAD_HANDLE;
 
@@ -791,10 +855,15 @@ Plugin_manager::get_input_file(unsigned int handle,
 ld_plugin_status
 Plugin_manager::release_input_file(unsigned int handle)
 {
-  if (this->object(handle) == NULL)
+  Object* handle_obj;
+  {
+    Hold_optional_lock hl(this->lock_);
+    handle_obj = this->object(handle);
+  }
+  if (handle_obj == NULL)
     return LDPS_BAD_HANDLE;
 
-  Pluginobj* obj = this->object(handle)->pluginobj();
+  Pluginobj* obj = handle_obj->pluginobj();
 
   if (obj == NULL)
     return LDPS_BAD_HANDLE;
@@ -809,6 +878,7 @@ Plugin_manager::release_input_file(unsigned int handle)
 Object*
 Plugin_manager::get_elf_object(const void* handle)
 {
+  Hold_optional_lock hl(this->lock_);
   Object* obj = this->object(
       static_cast<unsigned int>(reinterpret_cast<intptr_t>(handle)));
 
@@ -826,20 +896,27 @@ Plugin_manager::get_view(unsigned int handle, const void **viewp)
   off_t offset;
   size_t filesize;
   Input_file *input_file;
-  if (this->in_claim_file_handler_)
+  const Claim_state* claim;
+  Object* handle_obj;
+  {
+    Hold_optional_lock hl(this->lock_);
+    claim = this->find_claim(handle);
+    handle_obj = this->object(handle);
+  }
+  if (claim != NULL)
     {
       // We are being called from the claim_file hook.
-      const struct ld_plugin_input_file &f = this->plugin_input_file_;
+      const struct ld_plugin_input_file &f = claim->plugin_input_file;
       offset = f.offset;
       filesize = f.filesize;
-      input_file = this->input_file_;
+      input_file = claim->input_file;
     }
   else
     {
       // An already claimed file.
-      if (this->object(handle) == NULL)
+      if (handle_obj == NULL)
         return LDPS_BAD_HANDLE;
-      Pluginobj* obj = this->object(handle)->pluginobj();
+      Pluginobj* obj = handle_obj->pluginobj();
       if (obj == NULL)
         return LDPS_BAD_HANDLE;
       offset = obj->offset();
@@ -1656,7 +1733,7 @@ get_input_section_count(const void* handle, unsigned int* count)
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(handle))
     return LDPS_ERR;
 
   Object* obj = parameters->options().plugins()->get_elf_object(handle);
@@ -1678,7 +1755,8 @@ get_input_section_type(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	 section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1701,7 +1779,8 @@ get_input_section_name(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	 section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1730,7 +1809,8 @@ get_input_section_contents(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	 section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1759,7 +1839,8 @@ get_input_section_alignment(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	 section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1782,7 +1863,8 @@ get_input_section_size(const struct ld_plugin_section section,
 {
   gold_assert(parameters->options().has_plugins());
 
-  if (!parameters->options().plugins()->in_claim_file_handler())
+  if (!parameters->options().plugins()->in_claim_file_handler(
+	 section.handle))
     return LDPS_ERR;
 
   Object* obj
@@ -1903,6 +1985,18 @@ unique_segment_for_sections(const char* segment_name,
   return LDPS_OK;
 }
 
+// Let the linker know that the plugin's claim-file handler may be
+// called concurrently for different input files.  This must be called
+// from the plugin's onload entry point.
+
+static enum ld_plugin_status
+allow_parallel_claim_file()
+{
+  gold_assert(parameters->options().has_plugins());
+  parameters->options().plugins()->set_parallel_claim();
+  return LDPS_OK;
+}
+
 #endif // ENABLE_PLUGINS
 
 // Allocate a Pluginobj object of the appropriate size and endianness.
@@ -60,7 +60,8 @@ class Plugin
       claim_file_handler_(NULL),
       all_symbols_read_handler_(NULL),
       cleanup_handler_(NULL),
-      cleanup_done_(false)
+      cleanup_done_(false),
+      parallel_claim_(false)
   { }
 
   ~Plugin()
@@ -97,6 +98,16 @@ class Plugin
   set_cleanup_handler(ld_plugin_cleanup_handler handler)
   { this->cleanup_handler_ = handler; }
 
+  // Record that the claim-file handler may be called concurrently.
+  void
+  set_parallel_claim()
+  { this->parallel_claim_ = true; }
+
+  // Return whether the claim-file handler may be called concurrently.
+  bool
+  parallel_claim() const
+  { return this->parallel_claim_; }
+
   // Add an argument
   void
   add_option(const char* arg)
@@ -120,6 +131,8 @@ class Plugin
   ld_plugin_cleanup_handler cleanup_handler_;
   // TRUE if the cleanup handlers have been called.
   bool cleanup_done_;
+  // TRUE if the plugin declared its claim-file handler thread-safe.
+  bool parallel_claim_;
 };
 
 // A manager class for plugins.
@@ -128,14 +141,14 @@ class Plugin_manager
 {
  public:
   Plugin_manager(const General_options& options)
-    : plugins_(), objects_(), deferred_layout_objects_(), input_file_(NULL),
-      plugin_input_file_(), rescannable_(), undefined_symbols_(),
+    : plugins_(), objects_(), deferred_layout_objects_(), claims_(),
+      rescannable_(), undefined_symbols_(),
       any_claimed_(false), in_replacement_phase_(false), any_added_(false),
-      in_claim_file_handler_(false),
       options_(options), workqueue_(NULL), task_(NULL), input_objects_(NULL),
       symtab_(NULL), layout_(NULL), dirpath_(NULL), mapfile_(NULL),
       this_blocker_(NULL), extra_search_path_(), lock_(NULL),
-      initialize_lock_(&lock_)
+      initialize_lock_(&lock_), claim_lock_(NULL),
+      initialize_claim_lock_(&claim_lock_)
   { this->current_ = plugins_.end(); }
 
   ~Plugin_manager();
@@ -158,6 +171,7 @@ class Plugin_manager
   load_plugins(Layout* layout);
 
   // Call the plugin claim-file handlers in turn to see if any claim the file.
+  // This may be called concurrently from several Read_symbols tasks.
   Pluginobj*
   claim_file(Input_file* input_file, off_t offset, off_t filesize,
              Object* elf_object);
@@ -167,10 +181,10 @@ class Plugin_manager
   Object*
   get_elf_object(const void* handle);
 
-  // True if the claim_file handler of the plugins is being called.
+  // True if the claim_file handler of the plugins is being called
+  // for the file with the given HANDLE.
   bool
-  in_claim_file_handler()
-  { return in_claim_file_handler_; }
+  in_claim_file_handler(const void* handle);
 
   // Let the plugin manager save an archive for later rescanning.
   // This takes ownership of the Archive pointer.
@@ -226,6 +240,14 @@ class Plugin_manager
     (*this->current_)->set_cleanup_handler(handler);
   }
 
+  // Record that the current plugin's claim-file handler is thread-safe.
+  void
+  set_parallel_claim()
+  {
+    gold_assert(this->current_ != plugins_.end());
+    (*this->current_)->set_parallel_claim();
+  }
+
   // Make a new Pluginobj object.  This is called when the plugin calls
   // the add_symbols API.
   Pluginobj*
@@ -317,11 +339,34 @@ class Plugin_manager
     { this->u.input_group = input_group; }
   };
 
+  // The state of a file which is up for claim by the plugins.  There
+  // is one of these for each claim_file call in progress.
+  struct Claim_state
+  {
+    Input_file* input_file;
+    struct ld_plugin_input_file plugin_input_file;
+  };
+
   typedef std::list<Plugin*> Plugin_list;
   typedef std::vector<Object*> Object_list;
   typedef std::vector<Relobj*> Deferred_layout_list;
   typedef std::vector<Rescannable> Rescannable_list;
   typedef std::vector<Symbol*> Undefined_symbol_list;
+  typedef Unordered_map<unsigned int, const Claim_state*> Claim_map;
+
+  // Make a new Pluginobj object for the file described by CLAIM.  The
+  // caller must hold lock_.
+  Pluginobj*
+  do_make_plugin_object(unsigned int handle, const Claim_state* claim);
+
+  // Return the claim in progress for HANDLE, or NULL.  The caller
+  // must hold lock_.
+  const Claim_state*
+  find_claim(unsigned int handle) const
+  {
+    Claim_map::const_iterator p = this->claims_.find(handle);
+    return p == this->claims_.end() ? NULL : p->second;
+  }
 
   // Rescan archives for undefined symbols.
   void
@@ -337,15 +382,16 @@ class Plugin_manager
   Plugin_list::iterator current_;
 
   // The list of plugin objects.  The index of an item in this list
-  // serves as the "handle" that we pass to the plugins.
+  // serves as the "handle" that we pass to the plugins.  A slot is
+  // reserved for each file offered to the plugins; it holds the ELF
+  // object for the file, if any, until a plugin claims it.
   Object_list objects_;
 
   // The list of regular objects whose layout has been deferred.
   Deferred_layout_list deferred_layout_objects_;
 
-  // The file currently up for claim by the plugins.
-  Input_file* input_file_;
-  struct ld_plugin_input_file plugin_input_file_;
+  // The files currently up for claim by the plugins, indexed by handle.
+  Claim_map claims_;
 
   // A list of archives and input groups being saved for possible
   // later rescanning.
@@ -365,9 +411,6 @@ class Plugin_manager
   // Whether any input files or libraries were added by a plugin.
   bool any_added_;
 
-  // Set to true when the claim_file handler of a plugin is called.
-  bool in_claim_file_handler_;
-
   const General_options& options_;
   Workqueue* workqueue_;
   Task* task_;
@@ -381,8 +424,14 @@ class Plugin_manager
   // An extra directory to search for the libraries passed by
   // add_input_library.
   std::string extra_search_path_;
+  // Protects objects_, claims_ and any_claimed_.  This is not held
+  // while a claim-file handler runs.
   Lock* lock_;
   Initialize_lock initialize_lock_;
+  // Serializes calls to the claim-file handlers of plugins which have
+  // not declared them thread-safe.
+  Lock* claim_lock_;
+  Initialize_lock initialize_claim_lock_;
 };
 
 
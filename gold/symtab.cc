@@ -59,7 +59,7 @@ Symbol::init_fields(const char* name, const char* version,
   this->version_ = version;
   this->symtab_index_ = 0;
   this->dynsym_index_ = 0;
-  this->got_offsets_.init();
+  this->got_offsets_ = NULL;
   this->plt_offset_ = -1U;
   this->type_ = type;
   this->binding_ = binding;
@@ -564,8 +564,9 @@ Symbol::set_undefined()
 
 Symbol_table::Symbol_table(unsigned int count,
                            const Version_script_info& version_script)
-  : saw_undefined_(0), offset_(0), table_(count), namepool_(),
-    forwarders_(), commons_(), tls_commons_(), small_commons_(),
+  : saw_undefined_(0), offset_(0), table_(count), symbol_blocks_(),
+    symbol_block_used_(0), arena_symbol_count_(0), arena_symbol_bytes_(0),
+    namepool_(), forwarders_(), commons_(), tls_commons_(), small_commons_(),
     large_commons_(), forced_locals_(), warnings_(),
     version_script_(version_script), gc_(NULL), icf_(NULL),
     target_symbols_()
@@ -575,16 +576,147 @@ Symbol_table::Symbol_table(unsigned int count,
 
 Symbol_table::~Symbol_table()
 {
+  for (std::vector<unsigned char*>::iterator p = this->symbol_blocks_.begin();
+       p != this->symbol_blocks_.end();
+       ++p)
+    delete[] *p;
+}
+
+// The size of a block of memory in the symbol arena.
+
+static const size_t symbol_block_size = 64 * 1024;
+
+// Return LEN bytes of memory from the symbol arena.  Symbols are only
+// allocated while adding symbols, which is single-threaded, so we do
+// not need a lock.
+
+void*
+Symbol_table::allocate_symbol_memory(size_t len)
+{
+  // Keep every symbol aligned for its pointer and 64-bit fields.
+  const size_t align = sizeof(uint64_t);
+  len = (len + align - 1) & ~(align - 1);
+  gold_assert(len <= symbol_block_size);
+
+  if (this->symbol_blocks_.empty()
+      || this->symbol_block_used_ + len > symbol_block_size)
+    {
+      this->symbol_blocks_.push_back(new unsigned char[symbol_block_size]);
+      this->symbol_block_used_ = 0;
+    }
+
+  void* ret = this->symbol_blocks_.back() + this->symbol_block_used_;
+  this->symbol_block_used_ += len;
+  ++this->arena_symbol_count_;
+  this->arena_symbol_bytes_ += len;
+  return ret;
+}
+
+// Class Symbol_table::Symbol_table_type.
+
+Symbol_table::Symbol_table_type::Symbol_table_type(size_t count)
+  : slots_(NULL), capacity_(0), count_(0), tombstones_(0)
+{
+  this->grow(count);
+}
+
+// Return the entry for KEY, or NULL if there is none.
+
+Symbol_table::Symbol_table_type::value_type*
+Symbol_table::Symbol_table_type::lookup(const Symbol_table_key& key) const
+{
+  gold_assert(key.first != 0);
+  size_t mask = this->capacity_ - 1;
+  size_t i = Symbol_table_hash()(key) & mask;
+  while (true)
+    {
+      value_type* p = this->slots_ + i;
+      if (p->first.first == key.first && p->first.second == key.second)
+	return p;
+      // An unused slot which is not a tombstone ends the probe.
+      if (p->first.first == 0 && p->first.second == 0)
+	return NULL;
+      i = (i + 1) & mask;
+    }
+}
+
+// Insert V if its key is not already present.
+
+std::pair<Symbol_table::Symbol_table_type::iterator, bool>
+Symbol_table::Symbol_table_type::insert(const value_type& v)
+{
+  gold_assert(v.first.first != 0);
+  this->reserve(1);
+
+  size_t mask = this->capacity_ - 1;
+  size_t i = Symbol_table_hash()(v.first) & mask;
+  value_type* tombstone = NULL;
+  value_type* p;
+  while (true)
+    {
+      p = this->slots_ + i;
+      if (p->first.first == v.first.first
+	  && p->first.second == v.first.second)
+	return std::make_pair(iterator(p, this->slots_ + this->capacity_),
+			      false);
+      if (p->first.first == 0)
+	{
+	  if (p->first.second == 0)
+	    break;
+	  if (tombstone == NULL)
+	    tombstone = p;
+	}
+      i = (i + 1) & mask;
+    }
+
+  if (tombstone != NULL)
+    {
+      p = tombstone;
+      --this->tombstones_;
+    }
+  *p = v;
+  ++this->count_;
+  return std::make_pair(iterator(p, this->slots_ + this->capacity_), true);
 }
 
-// The symbol table key equality function.  This is called with
-// Stringpool keys.
+// Rehash the table into one with room for N more entries at a load
+// factor of at most 3/4.  This drops all tombstones.
 
-inline bool
-Symbol_table::Symbol_table_eq::operator()(const Symbol_table_key& k1,
-					  const Symbol_table_key& k2) const
+void
+Symbol_table::Symbol_table_type::grow(size_t n)
 {
-  return k1.first == k2.first && k1.second == k2.second;
+  size_t capacity = 16;
+  while ((this->count_ + n) * 4 > capacity * 3)
+    capacity *= 2;
+  // Grow geometrically, unless we are just clearing out tombstones.
+  if (capacity <= this->capacity_ && this->tombstones_ < this->count_)
+    capacity = this->capacity_ * 2;
+
+  value_type* old_slots = this->slots_;
+  size_t old_capacity = this->capacity_;
+
+  this->slots_ = new value_type[capacity];
+  for (size_t i = 0; i < capacity; ++i)
+    this->slots_[i] = value_type(Symbol_table_key(0, 0),
+				 static_cast<Symbol*>(NULL));
+  this->capacity_ = capacity;
+  this->count_ = 0;
+  this->tombstones_ = 0;
+
+  size_t mask = capacity - 1;
+  for (size_t i = 0; i < old_capacity; ++i)
+    {
+      const value_type& v(old_slots[i]);
+      if (v.first.first == 0)
+	continue;
+      size_t j = Symbol_table_hash()(v.first) & mask;
+      while (this->slots_[j].first.first != 0)
+	j = (j + 1) & mask;
+      this->slots_[j] = v;
+      ++this->count_;
+    }
+
+  delete[] old_slots;
 }
 
 bool
@@ -968,6 +1100,10 @@ Symbol_table::add_from_object(Object* object,
 	}
     }
 
+  // We may insert two entries below, and we need the iterator for
+  // the first to remain valid after inserting the second.
+  this->table_.reserve(2);
+
   Symbol* const snull = NULL;
   std::pair<typename Symbol_table_type::iterator, bool> ins =
     this->table_.insert(std::make_pair(std::make_pair(name_key, version_key),
@@ -1066,7 +1202,7 @@ Symbol_table::add_from_object(Object* object,
 	  Sized_target<size, big_endian>* target =
 	    parameters->sized_target<size, big_endian>();
 	  if (!target->has_make_symbol())
-	    ret = new Sized_symbol<size>();
+	    ret = this->allocate_symbol<size>();
 	  else
 	    {
 	      ret = target->make_symbol(name, sym.get_st_type(), object,
@@ -1815,6 +1951,10 @@ Symbol_table::define_special_symbol(const char** pname, const char** pversion,
       if (*pversion != NULL)
 	*pversion = this->namepool_.add(*pversion, true, &version_key);
 
+      // We need ADD_LOC and ADD_DEF_LOC to remain valid after both
+      // insertions.
+      this->table_.reserve(2);
+
       Symbol* const snull = NULL;
       std::pair<typename Symbol_table_type::iterator, bool> ins =
 	this->table_.insert(std::make_pair(std::make_pair(name_key,
@@ -3402,13 +3542,13 @@ Symbol_table::sized_write_section_symbol(const Output_section* os,
 void
 Symbol_table::print_stats() const
 {
-#if defined(HAVE_TR1_UNORDERED_MAP) || defined(HAVE_EXT_HASH_MAP)
   fprintf(stderr, _("%s: symbol table entries: %zu; buckets: %zu\n"),
 	  program_name, this->table_.size(), this->table_.bucket_count());
-#else
-  fprintf(stderr, _("%s: symbol table entries: %zu\n"),
-	  program_name, this->table_.size());
-#endif
+  fprintf(stderr, _("%s: symbol table hash memory: %zu bytes\n"),
+	  program_name, this->table_.memory_size());
+  fprintf(stderr, _("%s: symbols allocated: %zu (%zu bytes in %zu blocks)\n"),
+	  program_name, this->arena_symbol_count_, this->arena_symbol_bytes_,
+	  this->symbol_blocks_.size());
   this->namepool_.print_stats("symbol table stringpool");
 }
 
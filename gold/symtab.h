@@ -26,6 +26,7 @@
 #ifndef GOLD_SYMTAB_H
 #define GOLD_SYMTAB_H
 
+#include <new>
 #include <string>
 #include <utility>
 #include <vector>
@@ -419,13 +420,17 @@ class Symbol
   // For a TLS symbol, this GOT entry will hold its tp-relative offset.
   bool
   has_got_offset(unsigned int got_type) const
-  { return this->got_offsets_.get_offset(got_type) != -1U; }
+  {
+    return (this->got_offsets_ != NULL
+	    && this->got_offsets_->get_offset(got_type) != -1U);
+  }
 
   // Return the offset into the GOT section of this symbol.
   unsigned int
   got_offset(unsigned int got_type) const
   {
-    unsigned int got_offset = this->got_offsets_.get_offset(got_type);
+    gold_assert(this->got_offsets_ != NULL);
+    unsigned int got_offset = this->got_offsets_->get_offset(got_type);
     gold_assert(got_offset != -1U);
     return got_offset;
   }
@@ -433,12 +438,21 @@ class Symbol
   // Set the GOT offset of this symbol.
   void
   set_got_offset(unsigned int got_type, unsigned int got_offset)
-  { this->got_offsets_.set_offset(got_type, got_offset); }
+  {
+    if (this->got_offsets_ == NULL)
+      this->got_offsets_ = new Got_offset_list(got_type, got_offset);
+    else
+      this->got_offsets_->set_offset(got_type, got_offset);
+  }
 
   // Return the GOT offset list.
   const Got_offset_list*
   got_offset_list() const
-  { return this->got_offsets_.get_list(); }
+  {
+    if (this->got_offsets_ == NULL)
+      return NULL;
+    return this->got_offsets_->get_list();
+  }
 
   // Return whether this symbol has an entry in the PLT section.
   bool
@@ -1010,8 +1024,10 @@ class Symbol
 
   // The GOT section entries for this symbol.  A symbol may have more
   // than one GOT offset (e.g., when mixing modules compiled with two
-  // different TLS models), but will usually have at most one.
-  Got_offset_list got_offsets_;
+  // different TLS models), but will usually have at most one.  Most
+  // symbols have none, so the list is allocated on first use and this
+  // is NULL until then.
+  Got_offset_list* got_offsets_;
 
   // If this symbol has an entry in the PLT section, then this is the
   // offset from the start of the PLT section.  This is -1U if there
@@ -1676,24 +1692,210 @@ class Symbol_table
 
   typedef std::pair<Stringpool::Key, Stringpool::Key> Symbol_table_key;
 
-  // The hash function.  The key values are Stringpool keys.
+  // The hash function.  The key values are Stringpool keys, which are
+  // small consecutive integers, so mix the bits before they are used
+  // to pick a slot.
   struct Symbol_table_hash
   {
     inline size_t
     operator()(const Symbol_table_key& key) const
     {
-      return key.first ^ key.second;
+      size_t h = key.first * 0x9e3779b1U ^ key.second * 0x85ebca6bU;
+      return h ^ (h >> 15);
     }
   };
 
-  struct Symbol_table_eq
+  // The symbol hash table.  There is one entry for every global
+  // symbol name/version pair, so this uses open addressing with
+  // linear probing: the entries live directly in a single array,
+  // rather than in a separately allocated node per symbol.  A
+  // Stringpool key is never zero, so a zero name key marks an unused
+  // slot.  Erasing an entry leaves a tombstone in place, so it never
+  // moves other entries.  Growing the table moves all entries and
+  // invalidates iterators; callers which hold an iterator across
+  // another insertion must call reserve first.
+
+  class Symbol_table_type
   {
-    bool
-    operator()(const Symbol_table_key&, const Symbol_table_key&) const;
-  };
+   public:
+    typedef std::pair<Symbol_table_key, Symbol*> value_type;
+
+    template<typename Value>
+    class Iterator
+    {
+     public:
+      Iterator()
+	: p_(NULL), end_(NULL)
+      { }
+
+      Iterator(Value* p, Value* end)
+	: p_(p), end_(end)
+      { this->skip_unused(); }
+
+      // Allow conversion from iterator to const_iterator.
+      template<typename Other>
+      Iterator(const Iterator<Other>& i)
+	: p_(i.p_), end_(i.end_)
+      { }
+
+      Value&
+      operator*() const
+      { return *this->p_; }
+
+      Value*
+      operator->() const
+      { return this->p_; }
+
+      Iterator&
+      operator++()
+      {
+	++this->p_;
+	this->skip_unused();
+	return *this;
+      }
+
+      bool
+      operator==(const Iterator& i) const
+      { return this->p_ == i.p_; }
+
+      bool
+      operator!=(const Iterator& i) const
+      { return this->p_ != i.p_; }
+
+     private:
+      template<typename Other>
+      friend class Iterator;
+
+      void
+      skip_unused()
+      {
+	while (this->p_ != this->end_ && this->p_->first.first == 0)
+	  ++this->p_;
+      }
+
+      Value* p_;
+      Value* end_;
+    };
+
+    typedef Iterator<value_type> iterator;
+    typedef Iterator<const value_type> const_iterator;
+
+    Symbol_table_type(size_t count);
+
+    ~Symbol_table_type()
+    { delete[] this->slots_; }
+
+    iterator
+    begin()
+    { return iterator(this->slots_, this->slots_ + this->capacity_); }
+
+    iterator
+    end()
+    {
+      value_type* e = this->slots_ + this->capacity_;
+      return iterator(e, e);
+    }
+
+    const_iterator
+    begin() const
+    { return const_iterator(this->slots_, this->slots_ + this->capacity_); }
+
+    const_iterator
+    end() const
+    {
+      const value_type* e = this->slots_ + this->capacity_;
+      return const_iterator(e, e);
+    }
+
+    // Return the number of entries.
+    size_t
+    size() const
+    { return this->count_; }
+
+    // Return the number of slots.
+    size_t
+    bucket_count() const
+    { return this->capacity_; }
 
-  typedef Unordered_map<Symbol_table_key, Symbol*, Symbol_table_hash,
-			Symbol_table_eq> Symbol_table_type;
+    // Return the number of bytes used by the table.
+    size_t
+    memory_size() const
+    { return this->capacity_ * sizeof(value_type); }
+
+    // Make sure that the next N insertions will not grow the table,
+    // so that iterators remain valid across them.
+    void
+    reserve(size_t n)
+    {
+      if ((this->count_ + this->tombstones_ + n) * 4 > this->capacity_ * 3)
+	this->grow(n);
+    }
+
+    // Insert V if its key is not already present.  Return an iterator
+    // for the entry, and whether it was inserted.
+    std::pair<iterator, bool>
+    insert(const value_type& v);
+
+    // Find the entry for KEY, or return end().
+    iterator
+    find(const Symbol_table_key& key)
+    {
+      value_type* p = this->lookup(key);
+      if (p == NULL)
+	return this->end();
+      return iterator(p, this->slots_ + this->capacity_);
+    }
+
+    const_iterator
+    find(const Symbol_table_key& key) const
+    {
+      value_type* p = this->lookup(key);
+      if (p == NULL)
+	return this->end();
+      return const_iterator(p, this->slots_ + this->capacity_);
+    }
+
+    // Remove the entry at P.
+    void
+    erase(iterator p)
+    {
+      gold_assert(p->first.first != 0);
+      p->first.first = 0;
+      p->first.second = 1;
+      p->second = NULL;
+      --this->count_;
+      ++this->tombstones_;
+    }
+
+    // Remove the entry for KEY, if there is one.
+    void
+    erase(const Symbol_table_key& key)
+    {
+      iterator p = this->find(key);
+      if (p != this->end())
+	this->erase(p);
+    }
+
+   private:
+    Symbol_table_type(const Symbol_table_type&);
+    Symbol_table_type& operator=(const Symbol_table_type&);
+
+    // Return the entry for KEY, or NULL.
+    value_type*
+    lookup(const Symbol_table_key& key) const;
+
+    // Rehash into a table with room for N more entries.
+    void
+    grow(size_t n);
+
+    // The slots; CAPACITY_ is always a power of two.
+    value_type* slots_;
+    size_t capacity_;
+    // The number of live entries.
+    size_t count_;
+    // The number of erased slots which have not been reused.
+    size_t tombstones_;
+  };
 
   // A map from symbol name (as a pointer into the namepool) to all
   // the locations the symbols is (weakly) defined (and certain other
@@ -1728,6 +1930,20 @@ class Symbol_table
   define_default_version(Sized_symbol<size>*, bool,
 			 Symbol_table_type::iterator);
 
+  // Allocate a new symbol from the symbol arena.  These symbols are
+  // never freed individually.
+  template<int size>
+  Sized_symbol<size>*
+  allocate_symbol()
+  {
+    void* p = this->allocate_symbol_memory(sizeof(Sized_symbol<size>));
+    return new(p) Sized_symbol<size>();
+  }
+
+  // Return LEN bytes of memory from the symbol arena.
+  void*
+  allocate_symbol_memory(size_t len);
+
   // Resolve symbols.
   template<int size, bool big_endian>
   void
@@ -1937,6 +2153,15 @@ class Symbol_table
   unsigned int dynamic_count_;
   // The symbol hash table.
   Symbol_table_type table_;
+  // The blocks of memory which hold symbols allocated by
+  // allocate_symbol.
+  std::vector<unsigned char*> symbol_blocks_;
+  // The number of bytes used in the last block of symbol_blocks_.
+  size_t symbol_block_used_;
+  // The number of symbols allocated from the arena, and their total
+  // size in bytes.
+  size_t arena_symbol_count_;
+  size_t arena_symbol_bytes_;
   // A pool of symbol names.  This is used for all global symbols.
   // Entries in the hash table point into this pool.
   Stringpool namepool_;
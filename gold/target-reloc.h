@@ -224,6 +224,179 @@ issue_undefined_symbol_error(const Symbol* sym)
   return true;
 }
 
+// Apply relocation I, found at PRELOCS, as part of relocate_section.
+// RELOCATE is the target's relocation object, which is shared by all
+// the relocations in the section, since it may carry state from one
+// relocation to the next.  COMDAT_BEHAVIOR records what to do with
+// relocations against discarded sections once it has been determined.
+// The other arguments are as for relocate_section, below.
+
+template<int size, bool big_endian, typename Target_type,
+	 typename Relocate,
+	 typename Relocate_comdat_behavior,
+	 typename Classify_reloc>
+inline void
+relocate_one_reloc(
+    const Relocate_info<size, big_endian>* relinfo,
+    Target_type* target,
+    Relocate* relocate,
+    Relocate_comdat_behavior* relocate_comdat_behavior,
+    Comdat_behavior* comdat_behavior,
+    size_t i,
+    const unsigned char* prelocs,
+    Output_section* output_section,
+    bool needs_special_offset_handling,
+    unsigned char* view,
+    typename elfcpp::Elf_types<size>::Elf_Addr view_address,
+    section_size_type view_size,
+    const Reloc_symbol_changes* reloc_symbol_changes)
+{
+  typedef typename Classify_reloc::Reltype Reltype;
+
+  Sized_relobj_file<size, big_endian>* object = relinfo->object;
+  unsigned int local_count = object->local_symbol_count();
+
+  Reltype reloc(prelocs);
+
+  section_offset_type offset =
+    convert_to_section_size_type(reloc.get_r_offset());
+
+  if (needs_special_offset_handling)
+    {
+      offset = output_section->output_offset(relinfo->object,
+					     relinfo->data_shndx,
+					     offset);
+      if (offset == -1)
+	return;
+    }
+
+  unsigned int r_sym = Classify_reloc::get_r_sym(&reloc);
+
+  const Sized_symbol<size>* sym;
+
+  Symbol_value<size> symval;
+  const Symbol_value<size> *psymval;
+  bool is_defined_in_discarded_section;
+  unsigned int shndx;
+  if (r_sym < local_count
+      && (reloc_symbol_changes == NULL
+	  || (*reloc_symbol_changes)[i] == NULL))
+    {
+      sym = NULL;
+      psymval = object->local_symbol(r_sym);
+
+      // If the local symbol belongs to a section we are discarding,
+      // and that section is a debug section, try to find the
+      // corresponding kept section and map this symbol to its
+      // counterpart in the kept section.  The symbol must not
+      // correspond to a section we are folding.
+      bool is_ordinary;
+      shndx = psymval->input_shndx(&is_ordinary);
+      is_defined_in_discarded_section =
+	(is_ordinary
+	 && shndx != elfcpp::SHN_UNDEF
+	 && !object->is_section_included(shndx)
+	 && !relinfo->symtab->is_section_folded(object, shndx));
+    }
+  else
+    {
+      const Symbol* gsym;
+      if (reloc_symbol_changes != NULL
+	  && (*reloc_symbol_changes)[i] != NULL)
+	gsym = (*reloc_symbol_changes)[i];
+      else
+	{
+	  gsym = object->global_symbol(r_sym);
+	  gold_assert(gsym != NULL);
+	  if (gsym->is_forwarder())
+	    gsym = relinfo->symtab->resolve_forwards(gsym);
+	}
+
+      sym = static_cast<const Sized_symbol<size>*>(gsym);
+      if (sym->has_symtab_index() && sym->symtab_index() != -1U)
+	symval.set_output_symtab_index(sym->symtab_index());
+      else
+	symval.set_no_output_symtab_entry();
+      symval.set_output_value(sym->value());
+      if (gsym->type() == elfcpp::STT_TLS)
+	symval.set_is_tls_symbol();
+      else if (gsym->type() == elfcpp::STT_GNU_IFUNC)
+	symval.set_is_ifunc_symbol();
+      psymval = &symval;
+
+      is_defined_in_discarded_section =
+	(gsym->is_defined_in_discarded_section()
+	 && gsym->is_undefined());
+      shndx = 0;
+    }
+
+  Symbol_value<size> symval2;
+  if (is_defined_in_discarded_section)
+    {
+      if (*comdat_behavior == CB_UNDETERMINED)
+	{
+	  std::string name = object->section_name(relinfo->data_shndx);
+	  *comdat_behavior = relocate_comdat_behavior->get(name.c_str());
+	}
+      if (*comdat_behavior == CB_PRETEND)
+	{
+	  // FIXME: This case does not work for global symbols.
+	  // We have no place to store the original section index.
+	  // Fortunately this does not matter for comdat sections,
+	  // only for sections explicitly discarded by a linker
+	  // script.
+	  bool found;
+	  typename elfcpp::Elf_types<size>::Elf_Addr value =
+	    object->map_to_kept_section(shndx, &found);
+	  if (found)
+	    symval2.set_output_value(value + psymval->input_value());
+	  else
+	    symval2.set_output_value(0);
+	}
+      else
+	{
+	  if (*comdat_behavior == CB_WARNING)
+	    gold_warning_at_location(relinfo, i, offset,
+				     _("relocation refers to discarded "
+				       "section"));
+	  symval2.set_output_value(0);
+	}
+      symval2.set_no_output_symtab_entry();
+      psymval = &symval2;
+    }
+
+  // If OFFSET is out of range, still let the target decide to
+  // ignore the relocation.  Pass in NULL as the VIEW argument so
+  // that it can return quickly without trashing an invalid memory
+  // address.
+  unsigned char *v = view + offset;
+  if (offset < 0 || static_cast<section_size_type>(offset) >= view_size)
+    v = NULL;
+
+  if (!relocate->relocate(relinfo, Classify_reloc::sh_type, target,
+			  output_section, i, prelocs, sym, psymval,
+			  v, view_address + offset, view_size))
+    return;
+
+  if (v == NULL)
+    {
+      gold_error_at_location(relinfo, i, offset,
+			     _("reloc has bad offset %zu"),
+			     static_cast<size_t>(offset));
+      return;
+    }
+
+  if (issue_undefined_symbol_error(sym))
+    gold_undefined_symbol_at_location(sym, relinfo, i, offset);
+  else if (sym != NULL
+	   && sym->visibility() != elfcpp::STV_DEFAULT
+	   && (sym->is_strong_undefined() || sym->is_from_dynobj()))
+    visibility_error(sym);
+
+  if (sym != NULL && sym->has_warning())
+    relinfo->symtab->issue_warning(sym, relinfo, i, offset);
+}
+
 // This function implements the generic part of relocation processing.
 // The template parameter Relocate must be a class type which provides
 // a single function, relocate(), which implements the machine
@@ -271,157 +444,118 @@ relocate_section(
     section_size_type view_size,
     const Reloc_symbol_changes* reloc_symbol_changes)
 {
+  const int reloc_size = Classify_reloc::reloc_size;
+  Relocate relocate;
+  Relocate_comdat_behavior relocate_comdat_behavior;
+  Comdat_behavior comdat_behavior = CB_UNDETERMINED;
+
+  for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
+    relocate_one_reloc<size, big_endian, Target_type, Relocate,
+		       Relocate_comdat_behavior, Classify_reloc>(
+	relinfo, target, &relocate, &relocate_comdat_behavior,
+	&comdat_behavior, i, prelocs, output_section,
+	needs_special_offset_handling, view, view_address, view_size,
+	reloc_symbol_changes);
+}
+
+// A variant of relocate_section for targets which can apply their
+// most common relocations without going through Relocate::relocate.
+// Most relocations in a typical object refer to local symbols, often
+// section symbols, whose output values are already known; for those
+// we skip the symbol setup, the discarded section handling and the
+// target's general relocation switch.
+
+// The template parameter Fast_relocate must be a class type which
+// provides two static functions.  relocate(object, r_type, psymval,
+// addend, view, view_size, address) applies a relocation of type
+// R_TYPE against the local symbol PSYMVAL at VIEW, where VIEW_SIZE
+// bytes are available.  It returns true if it handled the relocation,
+// and false if the relocation type is not one it knows, if it does
+// not fit, or if the result overflowed; when it returns false it must
+// leave VIEW as Relocate::relocate will expect to find it.
+// affects_next(r_type) returns true if a relocation of type R_TYPE,
+// applied by Relocate::relocate, may change how the next relocation
+// must be handled, as for TLS relaxation.
+
+// Anything not handled by Fast_relocate goes through
+// relocate_one_reloc, so the output and the diagnostics are the same
+// as for relocate_section.
+
+template<int size, bool big_endian, typename Target_type,
+	 typename Relocate,
+	 typename Relocate_comdat_behavior,
+	 typename Classify_reloc,
+	 typename Fast_relocate>
+inline void
+relocate_section_fast(
+    const Relocate_info<size, big_endian>* relinfo,
+    Target_type* target,
+    const unsigned char* prelocs,
+    size_t reloc_count,
+    Output_section* output_section,
+    bool needs_special_offset_handling,
+    unsigned char* view,
+    typename elfcpp::Elf_types<size>::Elf_Addr view_address,
+    section_size_type view_size,
+    const Reloc_symbol_changes* reloc_symbol_changes)
+{
+  if (needs_special_offset_handling || reloc_symbol_changes != NULL)
+    {
+      relocate_section<size, big_endian, Target_type, Relocate,
+		       Relocate_comdat_behavior, Classify_reloc>(
+	relinfo, target, prelocs, reloc_count, output_section,
+	needs_special_offset_handling, view, view_address, view_size,
+	reloc_symbol_changes);
+      return;
+    }
+
   typedef typename Classify_reloc::Reltype Reltype;
   const int reloc_size = Classify_reloc::reloc_size;
   Relocate relocate;
   Relocate_comdat_behavior relocate_comdat_behavior;
+  Comdat_behavior comdat_behavior = CB_UNDETERMINED;
 
   Sized_relobj_file<size, big_endian>* object = relinfo->object;
   unsigned int local_count = object->local_symbol_count();
 
-  Comdat_behavior comdat_behavior = CB_UNDETERMINED;
+  // Whether the previous relocation lets us use the fast path.
+  bool fast_ok = true;
 
   for (size_t i = 0; i < reloc_count; ++i, prelocs += reloc_size)
     {
       Reltype reloc(prelocs);
-
+      unsigned int r_type = Classify_reloc::get_r_type(&reloc);
+      unsigned int r_sym = Classify_reloc::get_r_sym(&reloc);
       section_offset_type offset =
 	convert_to_section_size_type(reloc.get_r_offset());
 
-      if (needs_special_offset_handling)
-	{
-	  offset = output_section->output_offset(relinfo->object,
-						 relinfo->data_shndx,
-						 offset);
-	  if (offset == -1)
-	    continue;
-	}
-
-      unsigned int r_sym = Classify_reloc::get_r_sym(&reloc);
-
-      const Sized_symbol<size>* sym;
-
-      Symbol_value<size> symval;
-      const Symbol_value<size> *psymval;
-      bool is_defined_in_discarded_section;
-      unsigned int shndx;
-      if (r_sym < local_count
-	  && (reloc_symbol_changes == NULL
-	      || (*reloc_symbol_changes)[i] == NULL))
+      if (fast_ok
+	  && r_sym < local_count
+	  && offset >= 0
+	  && static_cast<section_size_type>(offset) < view_size)
 	{
-	  sym = NULL;
-	  psymval = object->local_symbol(r_sym);
-
-          // If the local symbol belongs to a section we are discarding,
-          // and that section is a debug section, try to find the
-          // corresponding kept section and map this symbol to its
-          // counterpart in the kept section.  The symbol must not
-          // correspond to a section we are folding.
+	  const Symbol_value<size>* psymval = object->local_symbol(r_sym);
 	  bool is_ordinary;
-	  shndx = psymval->input_shndx(&is_ordinary);
-	  is_defined_in_discarded_section =
-	    (is_ordinary
-	     && shndx != elfcpp::SHN_UNDEF
-	     && !object->is_section_included(shndx)
-	     && !relinfo->symtab->is_section_folded(object, shndx));
-	}
-      else
-	{
-	  const Symbol* gsym;
-	  if (reloc_symbol_changes != NULL
-	      && (*reloc_symbol_changes)[i] != NULL)
-	    gsym = (*reloc_symbol_changes)[i];
-	  else
-	    {
-	      gsym = object->global_symbol(r_sym);
-	      gold_assert(gsym != NULL);
-	      if (gsym->is_forwarder())
-		gsym = relinfo->symtab->resolve_forwards(gsym);
-	    }
-
-	  sym = static_cast<const Sized_symbol<size>*>(gsym);
-	  if (sym->has_symtab_index() && sym->symtab_index() != -1U)
-	    symval.set_output_symtab_index(sym->symtab_index());
-	  else
-	    symval.set_no_output_symtab_entry();
-	  symval.set_output_value(sym->value());
-	  if (gsym->type() == elfcpp::STT_TLS)
-	    symval.set_is_tls_symbol();
-	  else if (gsym->type() == elfcpp::STT_GNU_IFUNC)
-	    symval.set_is_ifunc_symbol();
-	  psymval = &symval;
-
-	  is_defined_in_discarded_section =
-	    (gsym->is_defined_in_discarded_section()
-	     && gsym->is_undefined());
-	  shndx = 0;
-	}
-
-      Symbol_value<size> symval2;
-      if (is_defined_in_discarded_section)
-	{
-	  if (comdat_behavior == CB_UNDETERMINED)
-	    {
-	      std::string name = object->section_name(relinfo->data_shndx);
-	      comdat_behavior = relocate_comdat_behavior.get(name.c_str());
-	    }
-	  if (comdat_behavior == CB_PRETEND)
-	    {
-	      // FIXME: This case does not work for global symbols.
-	      // We have no place to store the original section index.
-	      // Fortunately this does not matter for comdat sections,
-	      // only for sections explicitly discarded by a linker
-	      // script.
-	      bool found;
-	      typename elfcpp::Elf_types<size>::Elf_Addr value =
-		object->map_to_kept_section(shndx, &found);
-	      if (found)
-		symval2.set_output_value(value + psymval->input_value());
-	      else
-		symval2.set_output_value(0);
-	    }
-	  else
-	    {
-	      if (comdat_behavior == CB_WARNING)
-		gold_warning_at_location(relinfo, i, offset,
-					 _("relocation refers to discarded "
-					   "section"));
-	      symval2.set_output_value(0);
-	    }
-	  symval2.set_no_output_symtab_entry();
-	  psymval = &symval2;
-	}
-
-      // If OFFSET is out of range, still let the target decide to
-      // ignore the relocation.  Pass in NULL as the VIEW argument so
-      // that it can return quickly without trashing an invalid memory
-      // address.
-      unsigned char *v = view + offset;
-      if (offset < 0 || static_cast<section_size_type>(offset) >= view_size)
-	v = NULL;
-
-      if (!relocate.relocate(relinfo, Classify_reloc::sh_type, target,
-			     output_section, i, prelocs, sym, psymval,
-			     v, view_address + offset, view_size))
-	continue;
-
-      if (v == NULL)
-	{
-	  gold_error_at_location(relinfo, i, offset,
-				 _("reloc has bad offset %zu"),
-				 static_cast<size_t>(offset));
-	  continue;
+	  unsigned int shndx = psymval->input_shndx(&is_ordinary);
+	  if (psymval->has_output_value()
+	      && !psymval->is_ifunc_symbol()
+	      && !psymval->is_tls_symbol()
+	      && (!is_ordinary
+		  || shndx == elfcpp::SHN_UNDEF
+		  || object->is_section_included(shndx))
+	      && Fast_relocate::relocate(object, r_type, psymval,
+					 Classify_reloc::get_r_addend(&reloc),
+					 view + offset, view_size - offset,
+					 view_address + offset))
+	    continue;
 	}
 
-      if (issue_undefined_symbol_error(sym))
-	gold_undefined_symbol_at_location(sym, relinfo, i, offset);
-      else if (sym != NULL
-	       && sym->visibility() != elfcpp::STV_DEFAULT
-	       && (sym->is_strong_undefined() || sym->is_from_dynobj()))
-	visibility_error(sym);
-
-      if (sym != NULL && sym->has_warning())
-	relinfo->symtab->issue_warning(sym, relinfo, i, offset);
+      relocate_one_reloc<size, big_endian, Target_type, Relocate,
+			 Relocate_comdat_behavior, Classify_reloc>(
+	relinfo, target, &relocate, &relocate_comdat_behavior,
+	&comdat_behavior, i, prelocs, output_section, false, view,
+	view_address, view_size, NULL);
+      fast_ok = !Fast_relocate::affects_next(r_type);
     }
 }
 
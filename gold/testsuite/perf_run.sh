@@ -0,0 +1,269 @@
+#!/bin/sh
+
+# perf_run.sh -- synthetic link benchmarks for gold.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This script is run by "make check-perf".  It is not part of "make
+# check", since it takes a while and its results are only meaningful
+# when compared with an earlier run on the same machine.
+#
+# It generates a synthetic C++ program, compiles it, and links it with
+# gold under several sets of options, passing --stats each time.  For
+# each link it writes one line of JSON to the results file with the
+# per-phase times reported by gold's Timer and the peak RSS.
+#
+# The shape of the generated program is controlled by these options:
+#
+#   --objects=N     number of object files (default 200)
+#   --symbols=M     number of global functions per object (default 200)
+#   --comdat=P      percentage of functions which instantiate a template
+#                   shared by all objects, creating COMDAT groups
+#                   (default 50)
+#   --debug=D       0 for no debug info, 1 for -g, 2 for -g with an
+#                   extra struct type per function (default 1)
+#   --archives=A    put the objects in A archives linked as a group;
+#                   0 links the objects directly (default 0)
+#
+# Other options:
+#
+#   --configs=LIST  space separated list of option sets to link with.
+#                   Each is one of default, gc-sections, icf,
+#                   gdb-index, or threads-K for K threads.
+#                   (default "default threads-1 threads-2 threads-4
+#                   gc-sections icf gdb-index")
+#   --repeat=R      link R times with each option set (default 3)
+#   --output=FILE   results file (default perf_results.json)
+#   --keep          keep the generated sources and objects
+#
+# The tools come from the environment: GOLD (default ../ld-new), CXX
+# (default g++) and TEST_AR (default ar).
+
+objects=200
+symbols=200
+comdat=50
+debug=1
+archives=0
+configs="default threads-1 threads-2 threads-4 gc-sections icf gdb-index"
+repeat=3
+output=perf_results.json
+keep=no
+
+for arg
+do
+  case "$arg" in
+    --objects=*) objects=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --symbols=*) symbols=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --comdat=*) comdat=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --debug=*) debug=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --archives=*) archives=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --configs=*) configs=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --repeat=*) repeat=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --output=*) output=`echo "$arg" | sed -e 's/^[^=]*=//'` ;;
+    --keep) keep=yes ;;
+    *)
+      echo "perf_run.sh: unknown option $arg" 1>&2
+      exit 1
+      ;;
+  esac
+done
+
+gold=${GOLD:-../ld-new}
+cxx=${CXX:-g++}
+ar=${TEST_AR:-ar}
+
+case "$gold" in
+  /*) ;;
+  *) gold=`pwd`/$gold ;;
+esac
+
+workdir=perf_work
+rm -rf $workdir
+mkdir $workdir || exit 1
+
+# Generate the sources.  Function K of object I calls function K of
+# object I+1, so that every object refers to the next one; this is
+# what makes archive groups necessary.  Odd numbered functions are
+# never called, which gives --gc-sections something to remove, and
+# each object has a few identical functions for --icf to fold.
+
+echo "perf_run.sh: generating $objects objects with $symbols functions each"
+
+# perf_tmpl must stay out of line, or -O1 inlines it and no COMDAT
+# group is emitted for it.
+cat > $workdir/perf_common.h <<EOF
+template<int N>
+inline int __attribute__((noinline))
+perf_tmpl(int x)
+{
+  volatile int y = x;
+  return y * N + 1;
+}
+EOF
+
+awk -v objects=$objects -v symbols=$symbols -v comdat=$comdat \
+    -v debug=$debug -v dir=$workdir '
+BEGIN {
+  for (i = 0; i < objects; i++)
+    {
+      file = sprintf("%s/perf_%d.cc", dir, i);
+      next_obj = (i + 1) % objects;
+      printf("#include \"perf_common.h\"\n\n") > file;
+      for (k = 0; k < symbols; k++)
+	printf("int perf_f_%d_%d(int);\n", next_obj, k) > file;
+      for (k = 0; k < symbols; k++)
+	{
+	  if (debug >= 2)
+	    {
+	      printf("\nstruct perf_s_%d_%d\n{\n", i, k) > file;
+	      printf("  int a; long b; char c[%d]; perf_s_%d_%d* next;\n",
+		     k % 16 + 1, i, k) > file;
+	      printf("};\nperf_s_%d_%d perf_v_%d_%d;\n", i, k, i, k) > file;
+	    }
+	  printf("\nint\nperf_f_%d_%d(int x)\n{\n", i, k) > file;
+	  printf("  if (x <= 0)\n    return %d;\n", k) > file;
+	  if ((k * 100) / symbols < comdat)
+	    printf("  x = perf_tmpl<%d>(x);\n", k) > file;
+	  if (k % 2 == 0 && i + 1 < objects)
+	    printf("  x = perf_f_%d_%d(x - 1);\n", next_obj, k) > file;
+	  printf("  return x;\n}\n") > file;
+	}
+      for (k = 0; k < 4; k++)
+	printf("\nint\nperf_same_%d_%d()\n{\n  return 42;\n}\n", i, k) > file;
+      close(file);
+    }
+  file = sprintf("%s/perf_main.cc", dir);
+  printf("int perf_f_0_0(int);\n\n") > file;
+  printf("int\nmain()\n{\n  return perf_f_0_0(%d);\n}\n", objects) > file;
+  close(file);
+}' || exit 1
+
+cxxflags="-O1 -ffunction-sections -fno-exceptions -fno-asynchronous-unwind-tables"
+if test "$debug" -ge 1
+then
+  cxxflags="$cxxflags -g"
+fi
+
+echo "perf_run.sh: compiling"
+for f in $workdir/perf_*.cc
+do
+  $cxx $cxxflags -c -o `echo $f | sed -e 's/\.cc$/.o/'` $f || exit 1
+done
+
+inputs="$workdir/perf_main.o"
+if test "$archives" -gt 0
+then
+  a=0
+  while test $a -lt $archives
+  do
+    members=`ls $workdir/perf_[0-9]*.o \
+	     | awk -v a=$a -v n=$archives 'NR % n == a'`
+    rm -f $workdir/libperf_$a.a
+    $ar rc $workdir/libperf_$a.a $members || exit 1
+    inputs="$inputs $workdir/libperf_$a.a"
+    a=`expr $a + 1`
+  done
+  inputs="--start-group $inputs --end-group"
+else
+  inputs="$inputs `ls $workdir/perf_[0-9]*.o`"
+fi
+
+# Convert gold's --stats output to a line of JSON.
+stats_to_json()
+{
+  awk -v config="$1" -v run="$2" -v objects=$objects -v symbols=$symbols \
+      -v comdat=$comdat -v debug=$debug -v archives=$archives '
+function times(name, line)
+{
+  sub(/.*\(user: /, "", line);
+  split(line, f, /[ )]+/);
+  out = out sprintf(", \"%s_user\": %s, \"%s_sys\": %s, \"%s_wall\": %s",
+		    name, f[1], name, f[3], name, f[5]);
+}
+BEGIN {
+  out = sprintf("{\"config\": \"%s\", \"run\": %d, \"objects\": %d, " \
+		"\"symbols\": %d, \"comdat\": %d, \"debug\": %d, " \
+		"\"archives\": %d", config, run, objects, symbols, comdat,
+		debug, archives);
+}
+/: initial tasks run time:/ { times("initial", $0) }
+/: middle tasks run time:/ { times("middle", $0) }
+/: final tasks run time:/ { times("final", $0) }
+/: total run time:/ { times("total", $0) }
+/: peak resident set size:/ {
+  line = $0;
+  sub(/.*size: /, "", line);
+  sub(/ .*/, "", line);
+  out = out sprintf(", \"peak_rss_kb\": %s", line);
+}
+/: total space allocated by malloc:/ {
+  line = $0;
+  sub(/.*malloc: /, "", line);
+  sub(/ .*/, "", line);
+  out = out sprintf(", \"malloc_bytes\": %s", line);
+}
+END { print out "}" }'
+}
+
+rm -f $output
+status=0
+for config in $configs
+do
+  case "$config" in
+    default) flags= ;;
+    gc-sections) flags=--gc-sections ;;
+    icf) flags=--icf=all ;;
+    gdb-index) flags=--gdb-index ;;
+    threads-*)
+      flags="--threads --thread-count=`echo $config | sed -e 's/^threads-//'`"
+      ;;
+    *)
+      echo "perf_run.sh: unknown configuration $config" 1>&2
+      exit 1
+      ;;
+  esac
+
+  run=1
+  while test $run -le $repeat
+  do
+    rm -f $workdir/perf.out
+    if $gold --stats -static -nostdlib -e main -o $workdir/perf.out \
+	 $flags $inputs > $workdir/perf.stats 2>&1
+    then
+      stats_to_json $config $run < $workdir/perf.stats >> $output
+    else
+      echo "perf_run.sh: link failed for $config:" 1>&2
+      cat $workdir/perf.stats 1>&2
+      status=1
+    fi
+    run=`expr $run + 1`
+  done
+done
+
+if test "$keep" = "no"
+then
+  rm -rf $workdir
+fi
+
+if test -f $output
+then
+  echo "perf_run.sh: results written to $output"
+fi
+exit $status
@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <time.h>
 #include "plugin-api.h"
 
 struct claimed_file
@@ -68,6 +70,19 @@ static ld_plugin_get_input_section_name get_input_section_name = NULL;
 static ld_plugin_get_input_section_contents get_input_section_contents = NULL;
 static ld_plugin_update_section_order update_section_order = NULL;
 static ld_plugin_allow_section_ordering allow_section_ordering = NULL;
+static ld_plugin_allow_parallel_claim_file allow_parallel_claim_file = NULL;
+
+/* Protects the list of claimed files when the claim file hook is
+   called concurrently.  */
+static pthread_mutex_t claimed_file_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Set when the plugin declared its claim file hook thread-safe.  The
+   hook then counts how many calls are in progress at once, under
+   claimed_file_lock, and reports the maximum from the cleanup hook.  */
+static int parallel_claim = 0;
+static int active_claims = 0;
+static int max_active_claims = 0;
+static pthread_cond_t active_claims_cond = PTHREAD_COND_INITIALIZER;
 
 #define MAXOPTS 10
 
@@ -158,6 +173,9 @@ onload(struct ld_plugin_tv *tv)
 	case LDPT_ALLOW_SECTION_ORDERING:
 	  allow_section_ordering = *entry->tv_u.tv_allow_section_ordering;
 	  break;
+	case LDPT_ALLOW_PARALLEL_CLAIM_FILE:
+	  allow_parallel_claim_file = *entry->tv_u.tv_allow_parallel_claim_file;
+	  break;
         default:
           break;
         }
@@ -191,7 +209,27 @@ onload(struct ld_plugin_tv *tv)
   (*message)(LDPL_INFO, "gold version:  %d", gold_version);
 
   for (i = 0; i < nopts; ++i)
-    (*message)(LDPL_INFO, "option: %s", opts[i]);
+    {
+      (*message)(LDPL_INFO, "option: %s", opts[i]);
+
+      /* Declare the claim file hook thread-safe if asked to.  */
+      if (strcmp(opts[i], "parallel_claim") == 0)
+        {
+          if (allow_parallel_claim_file == NULL)
+            {
+              fprintf(stderr,
+                      "tv_allow_parallel_claim_file interface missing\n");
+              return LDPS_ERR;
+            }
+          if ((*allow_parallel_claim_file)() != LDPS_OK)
+            {
+              (*message)(LDPL_ERROR, "error allowing parallel claim file");
+              return LDPS_ERR;
+            }
+          (*message)(LDPL_INFO, "parallel claim file allowed");
+          parallel_claim = 1;
+        }
+    }
 
   if ((*register_claim_file_hook)(claim_file_hook) != LDPS_OK)
     {
@@ -270,6 +308,29 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
   int irfile_was_opened = 0;
   char syms_name[80];
 
+  if (parallel_claim)
+    {
+      struct timespec deadline;
+
+      /* Wait a little for another call to enter the hook, so that
+         the overlap is seen even though claiming a file is fast.
+         Once two calls have overlapped, nobody waits any more.  */
+      pthread_mutex_lock(&claimed_file_lock);
+      ++active_claims;
+      if (active_claims > max_active_claims)
+        max_active_claims = active_claims;
+      pthread_cond_broadcast(&active_claims_cond);
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_sec += 1;
+      while (max_active_claims < 2
+             && pthread_cond_timedwait(&active_claims_cond,
+                                       &claimed_file_lock,
+                                       &deadline) == 0)
+        ;
+      --active_claims;
+      pthread_mutex_unlock(&claimed_file_lock);
+    }
+
   (*message)(LDPL_INFO,
              "%s: claim file hook called (offset = %ld, size = %ld)",
              file->name, (long)file->offset, (long)file->filesize);
@@ -389,11 +450,13 @@ claim_file_hook (const struct ld_plugin_input_file* file, int* claimed)
   claimed_file->nsyms = nsyms;
   claimed_file->syms = syms;
   claimed_file->next = NULL;
+  pthread_mutex_lock(&claimed_file_lock);
   if (last_claimed_file == NULL)
     first_claimed_file = claimed_file;
   else
     last_claimed_file->next = claimed_file;
   last_claimed_file = claimed_file;
+  pthread_mutex_unlock(&claimed_file_lock);
 
   (*message)(LDPL_INFO, "%s: claiming file, adding %d symbols",
              file->name, nsyms);
@@ -598,6 +661,9 @@ all_symbols_read_hook(void)
 enum ld_plugin_status
 cleanup_hook(void)
 {
+  if (parallel_claim)
+    (*message)(LDPL_INFO, "maximum concurrent claim file hook calls: %d",
+               max_active_claims);
   (*message)(LDPL_INFO, "cleanup hook called");
   return LDPS_OK;
 }
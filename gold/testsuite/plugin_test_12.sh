@@ -0,0 +1,79 @@
+#!/bin/sh
+
+# plugin_test_12.sh -- test concurrent calls to the claim file hook.
+
+# Copyright (C) 2017 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# This file goes with plugin_test.c, a simple plug-in library.  The
+# plugin declares its claim file hook thread-safe, so gold may call it
+# concurrently when linking with --threads.  The plugin counts the
+# hook calls that are in progress at the same time, and the test fails
+# unless at least two of them overlapped.  The result must otherwise
+# match the serial link in plugin_test_1.
+
+check()
+{
+    if ! grep -q "$2" "$1"
+    then
+	echo "Did not find expected output in $1:"
+	echo "   $2"
+	echo ""
+	echo "Actual output below:"
+	cat "$1"
+	exit 1
+    fi
+}
+
+# There is nothing to run in parallel without thread support.
+if grep -q "compiled without thread support" plugin_test_12.err
+then
+    exit 77
+fi
+
+check plugin_test_12.err "API version:"
+check plugin_test_12.err "gold version:"
+check plugin_test_12.err "option: _Z4f13iv"
+check plugin_test_12.err "option: parallel_claim"
+check plugin_test_12.err "parallel claim file allowed"
+check plugin_test_12.err "two_file_test_main.o: claim file hook called"
+check plugin_test_12.err "two_file_test_1.o.syms: claim file hook called"
+check plugin_test_12.err "two_file_test_1b.o.syms: claim file hook called"
+check plugin_test_12.err "two_file_test_2.o.syms: claim file hook called"
+check plugin_test_12.err "two_file_test_1.o.syms: _Z4f13iv: PREVAILING_DEF_IRONLY"
+check plugin_test_12.err "two_file_test_1.o.syms: _Z2t2v: PREVAILING_DEF_REG"
+check plugin_test_12.err "two_file_test_1.o.syms: v2: RESOLVED_IR"
+check plugin_test_12.err "two_file_test_1.o.syms: t17data: RESOLVED_IR"
+check plugin_test_12.err "two_file_test_2.o.syms: _Z4f13iv: PREEMPTED_IR"
+check plugin_test_12.err "two_file_test_1.o: adding new input file"
+check plugin_test_12.err "two_file_test_1b.o: adding new input file"
+check plugin_test_12.err "two_file_test_2.o: adding new input file"
+check plugin_test_12.err "cleanup hook called"
+
+max=`sed -n 's/.*maximum concurrent claim file hook calls: \([0-9]*\).*/\1/p' plugin_test_12.err`
+if test -z "$max" || test "$max" -lt 2
+then
+    echo "Claim file hook calls did not run concurrently:"
+    echo ""
+    echo "Actual output below:"
+    cat plugin_test_12.err
+    exit 1
+fi
+
+exit 0
@@ -1035,6 +1035,25 @@ class Target_x86_64 : public Sized_target<size, false>
     bool skip_call_tls_get_addr_;
   };
 
+  // The relocations which relocate_section can apply directly, for
+  // use with gold::relocate_section_fast.
+  class Fast_relocate
+  {
+   public:
+    // Apply a relocation against a local symbol.  Return false if
+    // Relocate::relocate must handle it.
+    static inline bool
+    relocate(const Sized_relobj_file<size, false>*, unsigned int r_type,
+	     const Symbol_value<size>*, elfcpp::Elf_Xword addend,
+	     unsigned char* view, section_size_type view_size,
+	     typename elfcpp::Elf_types<size>::Elf_Addr address);
+
+    // Whether a relocation of type R_TYPE may change how the next
+    // relocation is handled.
+    static inline bool
+    affects_next(unsigned int r_type);
+  };
+
   // Check if relocation against this symbol is a candidate for
   // conversion from
   // mov foo@GOTPCREL(%rip), %reg
@@ -4017,6 +4036,89 @@ class X86_64_relocate_functions : public Relocate_functions<size, false>
   }
 };
 
+// Apply one of the common relocations against a local symbol.  This
+// must give the same result as Relocate::relocate.  We don't need to
+// worry about IFUNC or TLS symbols, which relocate_section_fast
+// passes to Relocate::relocate.
+
+template<int size>
+inline bool
+Target_x86_64<size>::Fast_relocate::relocate(
+    const Sized_relobj_file<size, false>* object,
+    unsigned int r_type,
+    const Symbol_value<size>* psymval,
+    elfcpp::Elf_Xword addend,
+    unsigned char* view,
+    section_size_type view_size,
+    typename elfcpp::Elf_types<size>::Elf_Addr address)
+{
+  typedef X86_64_relocate_functions<size> Reloc_funcs;
+  typename Reloc_funcs::Reloc_status rstatus;
+
+  switch (r_type)
+    {
+    case elfcpp::R_X86_64_64:
+      if (view_size < 8)
+	return false;
+      Reloc_funcs::rela64(view, object, psymval, addend);
+      return true;
+
+    case elfcpp::R_X86_64_32:
+      if (view_size < 4)
+	return false;
+      rstatus = Reloc_funcs::rela32_check(view, object, psymval, addend,
+					  Reloc_funcs::CHECK_UNSIGNED);
+      break;
+
+    case elfcpp::R_X86_64_32S:
+      if (view_size < 4)
+	return false;
+      rstatus = Reloc_funcs::rela32_check(view, object, psymval, addend,
+					  Reloc_funcs::CHECK_SIGNED);
+      break;
+
+    case elfcpp::R_X86_64_PC32:
+    case elfcpp::R_X86_64_PC32_BND:
+    case elfcpp::R_X86_64_PLT32:
+    case elfcpp::R_X86_64_PLT32_BND:
+      if (view_size < 4)
+	return false;
+      rstatus = Reloc_funcs::pcrela32_check(view, object, psymval, addend,
+					    address);
+      break;
+
+    default:
+      return false;
+    }
+
+  // Let Relocate::relocate report any overflow.
+  return rstatus == Reloc_funcs::RELOC_OK;
+}
+
+// A TLS relocation may cause Relocate::relocate to skip the call to
+// __tls_get_addr which follows it, so the next relocation has to go
+// through Relocate::relocate too.
+
+template<int size>
+inline bool
+Target_x86_64<size>::Fast_relocate::affects_next(unsigned int r_type)
+{
+  switch (r_type)
+    {
+    case elfcpp::R_X86_64_TLSGD:
+    case elfcpp::R_X86_64_GOTPC32_TLSDESC:
+    case elfcpp::R_X86_64_TLSDESC_CALL:
+    case elfcpp::R_X86_64_TLSLD:
+    case elfcpp::R_X86_64_DTPOFF32:
+    case elfcpp::R_X86_64_DTPOFF64:
+    case elfcpp::R_X86_64_GOTTPOFF:
+    case elfcpp::R_X86_64_TPOFF32:
+      return true;
+    default:
+      return false;
+    }
+}
+
 // Perform a relocation.
 
 template<int size>
@@ -5042,8 +5144,9 @@ Target_x86_64<size>::relocate_section(
 
   gold_assert(sh_type == elfcpp::SHT_RELA);
 
-  gold::relocate_section<size, false, Target_x86_64<size>, Relocate,
-			 gold::Default_comdat_behavior, Classify_reloc>(
+  gold::relocate_section_fast<size, false, Target_x86_64<size>, Relocate,
+			      gold::Default_comdat_behavior, Classify_reloc,
+			      Fast_relocate>(
     relinfo,
     this,
     prelocs,
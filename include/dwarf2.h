@@ -429,7 +429,12 @@ enum dwarf_name_index_attribute
     DW_IDX_parent = 4,
     DW_IDX_type_hash = 5,
     DW_IDX_lo_user = 0x2000,
-    DW_IDX_hi_user = 0x3fff
+    DW_IDX_hi_user = 0x3fff,
+
+    /* GNU extensions, recording whether the name is local to its
+       unit or visible outside it.  */
+    DW_IDX_GNU_internal = 0x2000,
+    DW_IDX_GNU_external = 0x2001
   };
 
 /* Range list entry kinds in .debug_rnglists* section.  */
@@ -365,6 +365,15 @@ enum ld_plugin_status
 (*ld_plugin_get_input_section_size) (const struct ld_plugin_section section,
                                      uint64_t *secsize);
 
+/* The linker's interface for declaring that the plugin's claim_file
+   handler is thread-safe, so that the linker may call it concurrently
+   for different input files.  This must be invoked from the plugin's
+   onload entry point.  */
+
+typedef
+enum ld_plugin_status
+(*ld_plugin_allow_parallel_claim_file) (void);
+
 enum ld_plugin_level
 {
   LDPL_INFO,
@@ -407,7 +416,8 @@ enum ld_plugin_tag
   LDPT_UNIQUE_SEGMENT_FOR_SECTIONS = 27,
   LDPT_GET_SYMBOLS_V3 = 28,
   LDPT_GET_INPUT_SECTION_ALIGNMENT = 29,
-  LDPT_GET_INPUT_SECTION_SIZE = 30
+  LDPT_GET_INPUT_SECTION_SIZE = 30,
+  LDPT_ALLOW_PARALLEL_CLAIM_FILE = 31
 };
 
 /* The plugin transfer vector.  */
@@ -441,6 +451,7 @@ struct ld_plugin_tv
     ld_plugin_unique_segment_for_sections tv_unique_segment_for_sections;
     ld_plugin_get_input_section_alignment tv_get_input_section_alignment;
     ld_plugin_get_input_section_size tv_get_input_section_size;
+    ld_plugin_allow_parallel_claim_file tv_allow_parallel_claim_file;
   } tv_u;
 };
 